@@ -6,11 +6,33 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "gol_api.h"
 #include "gol_ref.h"
 #include "gol_array.h"
 #include "gol_bits.h"
+#include "gol_tiles.h"
+#include "gol_counts.h"
+#include "gol_threads.h"
+#include "gol_stream.h"
+#include "gol_stats.h"
+#include "gol_random.h"
+#include "gol_pattern.h"
+#include "gol_snapshot.h"
+#include "gol_history.h"
+#include "gol_variant.h"
+#include "gol_ranks.h"
+#include "gol_frames.h"
+#include "gol_macrocell.h"
+#include "gol_perf.h"
+#include "gol_tune.h"
+#include "gol_region.h"
+#include "gol_compare.h"
+#include "gol_census.h"
 
 
 /* character representations of cell states */
@@ -20,362 +42,2272 @@
 
 typedef struct
 {
-    GOL_Variant_t Variant;
+    GOL_Variant_t  Variant;
+    const VARIANT_Ops_t* Ops_p;
+    GOL_Options_t  Options;
+    THREADS_Pool_t Pool;
+    int            OriginColumn;
+    int            OriginRow;
+    long long      Generation;
+    pthread_mutex_t SnapshotLock;  // Guards Published_p, readers take it too
+    SNAPSHOT_t*    Published_p;    // The last generation evolved, or NULL
+    HISTORY_t      History;
+    PERF_Group_t   Counters;       // Of the thread evolving the world and its workers, open if Options.CountEvents
+    long long      CellUpdates;    // While the counters were started
+    REGION_Index_t Region;         // Built when first counted, since the last change
     union
     {
-        RefGame_t   RefGame;
-        ArrayGame_t ArrayGame;
-        BitsGame_t  BitsGame;
+        RefGame_t    RefGame;
+        ArrayGame_t  ArrayGame;
+        BitsGame_t   BitsGame;
+        TilesGame_t  TilesGame;
+        CountsGame_t CountsGame;
     } Data;
 } GameOfLife_t;
 
 
+typedef struct
+{
+    GameOfLife_t* Game_p;
+    double        Density;
+    uint64_t      Seed;
+    uint64_t*     Rows_p;         // One row for each worker to fill
+} RandomFill_t;
+
+
+typedef struct
+{
+    GameOfLife_t* Game_p;
+    int           Width;          // Columns loaded, the rest of a line is cut
+    const char*   Text_p;         // The whole file, mapped
+    size_t        Size;
+    size_t*       LineStarts_p;   // NumberOfLines + 1 offsets into Text_p
+    int           NumberOfLines;
+    uint64_t*     Rows_p;         // One row for each worker to pack into
+} TextLoad_t;
+
+
+typedef struct
+{
+    CENSUS_Table_t  Table;
+    CENSUS_Entry_t* Entries_p;    // Most common first
+} Census_t;
+
+
+typedef struct
+{
+    GameOfLife_t*    Game_p;
+    MACROCELL_Tree_t Tree;
+    long long        Column;      // Of the root, at the top left of the world
+    long long        Row;
+    uint64_t*        Rows_p;      // One row for each worker to flatten into
+} MacrocellLoad_t;
+
+
+static GOL_Options_t DefaultOptions =
+{
+    DEFAULT_NUM_THREADS,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0
+};
+
+static pthread_mutex_t OptionsLock = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread GOL_Status_t LastStatus = GOL_OK;
+
+
+static GOL_Status_t
+SetStatus(const GOL_Status_t Status);
+
+static GameOfLife_t*
+InitializeWorld(const GOL_Variant_t        Variant,
+                const int                  Width,
+                const int                  Height,
+                const int                  UseDefaultPattern,
+                const GOL_Options_t* const Options_p);
+
+static GOL_Status_t
+CopyCells(GameOfLife_t* Target_p, GameOfLife_t* Source_p, const int Column, const int Row);
+
+static void*
+MakeTuningSample(void*                      Context_p,
+                 const TUNE_Choice_t* const Choice_p,
+                 const int                  Column,
+                 const int                  Row,
+                 const int                  Width,
+                 const int                  Height);
+
+static void
+EvolveTuningSample(void* Sample_p);
+
+static void
+DestroyTuningSample(void* Sample_p);
+
+static void
+GetStats(const GOL_Game_t Game, STATS_t* Stats_p);
+
+static void
+AutoResize(GameOfLife_t* Game_p);
+
+static void
+PlanResize(const int  Min,
+           const int  Max,
+           const int  Size,
+           const int  Margin,
+           const int  Alignment,
+           int* const NewSize_p,
+           int* const Shift_p);
+
+static void
+SetCellStateInCurrent(const GOL_Game_t Game, const int Column, const int Row, const int State);
+
+static void
+SetRowInCurrent(GameOfLife_t* Game_p, const int Row, const uint64_t* const Cells_p);
+
+static void
+StampRowInCurrent(GameOfLife_t*         Game_p,
+                  const int             Row,
+                  const int             Column,
+                  const uint64_t* const Cells_p,
+                  const int             NumberOfColumns,
+                  const PATTERN_Mode_t  Mode);
+
+static void
+InvalidateStats(GameOfLife_t* Game_p);
+
+static int
+UnshareCurrent(GameOfLife_t* Game_p);
+
+static void
+PublishSnapshot(GameOfLife_t* Game_p, SNAPSHOT_t* Snapshot_p);
+
+static int
+PublishCurrent(GameOfLife_t* Game_p);
+
+static SNAPSHOT_t*
+CreateSnapshot(GameOfLife_t* Game_p);
+
+static SNAPSHOT_t*
+CopySnapshot(GameOfLife_t* Game_p);
+
+static int
+RecordHistory(GameOfLife_t* Game_p);
+
+static GOL_Status_t
+FillBufferView(GOL_BufferView_t* const View_p, const SNAPSHOT_t* const Snapshot_p);
+
+static void
+GetRow(GameOfLife_t* Game_p, const int Row, uint64_t* const Cells_p);
+
+static void
+UnpackStreamRow(const uint_t* const Row_p, const int Width, uint64_t* const Cells_p);
+
+static void
+PackStreamRow(const uint64_t* const Cells_p, const int Width, const int NumberOfUints, uint_t* const Row_p);
+
+static void
+GetRowOfGame(void* Context_p, const int Row, uint64_t* const Cells_p);
+
+static SNAPSHOT_t*
+EvolveForCompare(void* Context_p);
+
+static GOL_Status_t
+SaveText(GameOfLife_t* Game_p, const char* const Filename_p);
+
+static GOL_Status_t
+SaveMacrocell(GameOfLife_t* Game_p, const char* const Filename_p);
+
+static GOL_Status_t
+LoadMacrocell(GameOfLife_t* Game_p, const char* const Text_p, const size_t Size);
+
+static void
+FillRandomBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+static void
+LoadTextBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+static void
+LoadMacrocellBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+
+GOL_Status_t
+GOL_GetLastError(void)
+{
+    return LastStatus;
+}
+
+
+const char*
+GOL_GetStatusString(const GOL_Status_t Status)
+{
+    switch (Status)
+    {
+    case GOL_OK:                     return "Success";
+    case GOL_ERROR_INVALID_ARGUMENT: return "Invalid argument";
+    case GOL_ERROR_OUT_OF_MEMORY:    return "Out of memory";
+    case GOL_ERROR_IO:               return "Input/output error";
+    case GOL_ERROR_FORMAT:           return "Unrecognized format";
+    case GOL_ERROR_NOT_SUPPORTED:    return "Not supported by this variant";
+    case GOL_ERROR_NOT_FOUND:        return "Generation not kept";
+    case GOL_ERROR_MISMATCH:         return "Worlds differ";
+    default:                         return "Unknown status";
+    }
+}
+
+
+void
+GOL_SetOptions(const GOL_Options_t* const Options_p)
+{
+    pthread_mutex_lock(&OptionsLock);
+    DefaultOptions = *Options_p;
+    if (DefaultOptions.NumberOfThreads < 1)
+    {
+        DefaultOptions.NumberOfThreads = 1;
+    }
+    pthread_mutex_unlock(&OptionsLock);
+}
+
+
+void
+GOL_GetOptions(GOL_Options_t* const Options_p)
+{
+    pthread_mutex_lock(&OptionsLock);
+    *Options_p = DefaultOptions;
+    pthread_mutex_unlock(&OptionsLock);
+}
+
+
+GOL_Game_t
+GOL_InitializeWorld(const GOL_Variant_t Variant,
+                    const int           Width,
+                    const int           Height,
+                    const int           UseDefaultPattern)
+{
+    GOL_Options_t Options;
+
+    GOL_GetOptions(&Options);
+    return InitializeWorld(Variant, Width, Height, UseDefaultPattern, &Options);
+}
+
+
+static GameOfLife_t*
+InitializeWorld(const GOL_Variant_t        Variant,
+                const int                  Width,
+                const int                  Height,
+                const int                  UseDefaultPattern,
+                const GOL_Options_t* const Options_p)
+{
+    GameOfLife_t* Game_p = NULL;
+    int Result = 0;
+
+    const VARIANT_Ops_t* Ops_p = VARIANT_GetOps(Variant);
+
+    if (Ops_p == NULL || (Variant != GOL_VARIANT_REFERENCE && (Width <= 0 || Height <= 0)))
+    {
+        SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    if ((Game_p = malloc(sizeof(GameOfLife_t))) == NULL)
+    {
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    Game_p->Variant = Variant;
+    Game_p->Ops_p   = Ops_p;
+    Game_p->Options = *Options_p;
+    if (Ops_p->Flags & VARIANT_ONLY_IN_PLACE)
+    {
+        Game_p->Options.InPlace = 1;
+    }
+    else if (!(Ops_p->Flags & VARIANT_IN_PLACE))
+    {
+        Game_p->Options.InPlace = 0;
+    }
+
+    if (HISTORY_Initialize(&Game_p->History, Game_p->Options.HistoryLength, Game_p->Options.KeyframeInterval) != 0)
+    {
+        free(Game_p);
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    if (Ops_p->Flags & VARIANT_THREADED)
+    {
+        THREADS_CreatePool(&Game_p->Pool, Game_p->Options.NumberOfThreads, Game_p->Options.PinThreads);
+    }
+    else
+    {
+        THREADS_CreatePool(&Game_p->Pool, 1, 0);
+    }
+
+    Game_p->CellUpdates = 0;
+    if (Game_p->Options.CountEvents)
+    {
+        Result = PERF_OpenGroup(&Game_p->Counters, &Game_p->Pool);
+        Game_p->Options.CountEvents = (Result > 0);
+    }
+    if (Result < 0)
+    {
+        THREADS_DestroyPool(&Game_p->Pool);
+        HISTORY_Destroy(&Game_p->History);
+        free(Game_p);
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    if (Ops_p->Initialize(&Game_p->Data, Width, Height, Game_p->Options.InPlace, &Game_p->Pool) != 0)
+    {
+        if (Game_p->Options.CountEvents)
+        {
+            PERF_CloseGroup(&Game_p->Counters);
+        }
+        THREADS_DestroyPool(&Game_p->Pool);
+        HISTORY_Destroy(&Game_p->History);
+        free(Game_p);
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    Game_p->OriginColumn = 0;
+    Game_p->OriginRow    = 0;
+    Game_p->Generation   = 0;
+    Game_p->Published_p  = NULL;
+    pthread_mutex_init(&Game_p->SnapshotLock, NULL);
+    REGION_Initialize(&Game_p->Region);
+
+    if (UseDefaultPattern)
+    {
+        // Insert the Pattern "Glider"
+        SetCellStateInCurrent(Game_p, 1, 2, ALIVE);
+        SetCellStateInCurrent(Game_p, 3, 1, ALIVE);
+        SetCellStateInCurrent(Game_p, 3, 2, ALIVE);
+        SetCellStateInCurrent(Game_p, 3, 3, ALIVE);
+        SetCellStateInCurrent(Game_p, 2, 3, ALIVE);
+    }
+
+    SetStatus(GOL_OK);
+    return Game_p;
+}
+
+
+// The file is mapped and split into lines first, then each worker packs
+// the lines of the rows it zeroed, and will evolve
+GOL_Game_t
+GOL_InitializeWorldFromFile(const GOL_Variant_t Variant,
+                            const int           Width,
+                            const int           Height,
+                            const char* const   Filename_p)
+{
+    GameOfLife_t* Game_p = GOL_InitializeWorld(Variant, Width, Height, 0);
+    GOL_Status_t Status = GOL_OK;
+    TextLoad_t Load;
+    struct stat Stat;
+    int Fd;
+
+    if (Game_p == NULL)
+    {
+        return NULL;
+    }
+
+    if ((Fd = open(Filename_p, O_RDONLY)) < 0 || fstat(Fd, &Stat) != 0)
+    {
+        if (Fd >= 0)
+        {
+            close(Fd);
+        }
+        GOL_DestroyWorld((GOL_Game_t*)&Game_p);
+        SetStatus(GOL_ERROR_IO);
+        return NULL;
+    }
+
+    // REFERENCE worlds have a fixed size, longer lines are cut
+    Load.Game_p        = Game_p;
+    Load.Width         = (Width < GOL_GetWorldWidth(Game_p)) ? Width : GOL_GetWorldWidth(Game_p);
+    Load.Size          = Stat.st_size;
+    Load.Text_p        = NULL;
+    Load.LineStarts_p  = NULL;
+    Load.NumberOfLines = 0;
+    Load.Rows_p        = NULL;
+
+    if (Load.Size > 0)
+    {
+        const int MaxLines = (Height < GOL_GetWorldHeight(Game_p)) ? Height : GOL_GetWorldHeight(Game_p);
+
+        Load.Text_p = mmap(NULL, Load.Size, PROT_READ, MAP_PRIVATE, Fd, 0);
+        Load.LineStarts_p = malloc(((size_t)MaxLines + 1) * sizeof(size_t));
+        Load.Rows_p = malloc((size_t)THREADS_GetNumberOfThreads(&Game_p->Pool) *
+                             ((GOL_GetWorldWidth(Game_p) + 63) / 64) * sizeof(uint64_t));
+        if (Load.Text_p == MAP_FAILED || Load.LineStarts_p == NULL || Load.Rows_p == NULL)
+        {
+            if (Load.Text_p != MAP_FAILED)
+            {
+                munmap((void*)Load.Text_p, Load.Size);
+            }
+            free(Load.LineStarts_p);
+            free(Load.Rows_p);
+            close(Fd);
+            GOL_DestroyWorld((GOL_Game_t*)&Game_p);
+            SetStatus((Load.Text_p == MAP_FAILED) ? GOL_ERROR_IO : GOL_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+        madvise((void*)Load.Text_p, Load.Size, MADV_SEQUENTIAL);
+
+        if (MACROCELL_IsMacrocell(Load.Text_p, Load.Size))
+        {
+            Status = LoadMacrocell(Game_p, Load.Text_p, Load.Size);
+        }
+        else
+        {
+            // Line j is LineStarts_p[j] up to LineStarts_p[j + 1], newline included
+            Load.LineStarts_p[0] = 0;
+            while (Load.NumberOfLines < MaxLines && Load.LineStarts_p[Load.NumberOfLines] < Load.Size)
+            {
+                const size_t Start = Load.LineStarts_p[Load.NumberOfLines];
+                const char* Newline_p = memchr(Load.Text_p + Start, '\n', Load.Size - Start);
+
+                Load.LineStarts_p[++Load.NumberOfLines] = (Newline_p != NULL) ? (size_t)(Newline_p - Load.Text_p) + 1 : Load.Size;
+            }
+
+            THREADS_Run(&Game_p->Pool, LoadTextBand, &Load);
+        }
+        InvalidateStats(Game_p);
+
+        munmap((void*)Load.Text_p, Load.Size);
+        free(Load.LineStarts_p);
+        free(Load.Rows_p);
+    }
+    close(Fd);
+
+    if (Status != GOL_OK)
+    {
+        GOL_DestroyWorld((GOL_Game_t*)&Game_p);
+        SetStatus(Status);
+        return NULL;
+    }
+    return Game_p;
+}
+
+
+GOL_Game_t
+GOL_InitializeWorldRandom(const GOL_Variant_t      Variant,
+                          const int                Width,
+                          const int                Height,
+                          const double             Density,
+                          const unsigned long long Seed)
+{
+    const double Rounded = RANDOM_RoundDensity(Density);
+    GameOfLife_t* Game_p;
+    RandomFill_t Fill;
+
+    // A density too close to 0 or 1 would give a world without a cell that
+    // differs from the others
+    if ((Density > 0.0 && Rounded == 0.0) || (Density < 1.0 && Rounded == 1.0))
+    {
+        SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    Game_p = GOL_InitializeWorld(Variant, Width, Height, 0);
+    if (Game_p == NULL)
+    {
+        return NULL;
+    }
+
+    // Each worker fills the rows it zeroed, and will evolve
+    Fill.Game_p  = Game_p;
+    Fill.Density = Density;
+    Fill.Seed    = Seed;
+    Fill.Rows_p  = malloc((size_t)THREADS_GetNumberOfThreads(&Game_p->Pool) *
+                          ((GOL_GetWorldWidth(Game_p) + 63) / 64) * sizeof(uint64_t));
+    if (Fill.Rows_p == NULL)
+    {
+        GOL_DestroyWorld((GOL_Game_t*)&Game_p);
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    THREADS_Run(&Game_p->Pool, FillRandomBand, &Fill);
+    free(Fill.Rows_p);
+    InvalidateStats(Game_p);
+
+    return Game_p;
+}
+
+
+GOL_Game_t
+GOL_InitializeWorldFromPackedFile(const GOL_Variant_t Variant,
+                                  const char* const   Filename_p)
+{
+    GameOfLife_t* Game_p = NULL;
+    STREAM_Header_t Header;
+    SNAPSHOT_t Current;
+    uint_t* Row_p;
+    uint64_t* Cells_p;
+    size_t BytesPerRow;
+    int Fd;
+
+    if ((Fd = open(Filename_p, O_RDONLY)) < 0)
+    {
+        SetStatus(GOL_ERROR_IO);
+        return NULL;
+    }
+    if (STREAM_ReadHeader(Fd, &Header) != 0)
+    {
+        close(Fd);
+        SetStatus(GOL_ERROR_FORMAT);
+        return NULL;
+    }
+
+    Game_p = GOL_InitializeWorld(Variant, Header.Width, Header.Height, 0);
+    BytesPerRow = Header.NumberOfUintsPerRow * sizeof(uint_t);
+    Row_p = malloc(BytesPerRow);
+    Cells_p = malloc(((Header.Width + 63) / 64) * sizeof(uint64_t));
+    if (Game_p != NULL && (Row_p == NULL || Cells_p == NULL))
+    {
+        GOL_DestroyWorld((GOL_Game_t*)&Game_p);
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+    if (Game_p != NULL && Game_p->Ops_p->Describe != NULL)
+    {
+        Game_p->Ops_p->Describe(&Game_p->Data, &Current);
+    }
+
+    for (int j = 0; Game_p != NULL && j < Header.Height; j++)
+    {
+        if (pread(Fd, Row_p, BytesPerRow, sizeof(Header) + (off_t)j * BytesPerRow) != (ssize_t)BytesPerRow)
+        {
+            // Truncated
+            GOL_DestroyWorld((GOL_Game_t*)&Game_p);
+            SetStatus(GOL_ERROR_FORMAT);
+            break;
+        }
+
+        // Packed rows are laid out as BITS rows
+        if (Game_p->Ops_p->Describe != NULL && Current.Layout == SNAPSHOT_LAYOUT_BITS &&
+            Current.Stride == Header.NumberOfUintsPerRow)
+        {
+            memcpy((uint_t*)Current.Buffer_p + (size_t)(1 + j) * Header.NumberOfUintsPerRow,
+                   Row_p, BytesPerRow);
+        }
+        else if (j < GOL_GetWorldHeight(Game_p))
+        {
+            UnpackStreamRow(Row_p, Header.Width, Cells_p);
+            SetRowInCurrent(Game_p, j, Cells_p);
+        }
+    }
+
+    if (Game_p != NULL)
+    {
+        InvalidateStats(Game_p);
+    }
+
+    free(Cells_p);
+    free(Row_p);
+    close(Fd);
+    return Game_p;
+}
+
+
+GOL_Game_t
+GOL_InitializeWorldFromBuffer(const GOL_Variant_t           Variant,
+                              const GOL_BufferView_t* const View_p,
+                              void                          (*Release)(void* Context_p),
+                              void*                         Context_p)
+{
+    GameOfLife_t* Game_p;
+    GOL_BufferView_t Expected;
+    void** Current_pp;
+    void* Buffer_p;
+
+    if (View_p->Data_p == NULL || (uintptr_t)View_p->Data_p % 64 != 0 || View_p->Width <= 0 || View_p->Height <= 0)
+    {
+        SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    Game_p = GOL_InitializeWorld(Variant, View_p->Width, View_p->Height, 0);
+    if (Game_p == NULL)
+    {
+        return NULL;
+    }
+
+    // The world's own buffer tells what the caller's must look like
+    if (GOL_GetBufferView(Game_p, &Expected) != GOL_OK)
+    {
+        GOL_DestroyWorld((GOL_Game_t*)&Game_p);
+        SetStatus(GOL_ERROR_NOT_SUPPORTED);
+        return NULL;
+    }
+    if (View_p->Format      != Expected.Format    ||
+        View_p->Size        <  Expected.Size      ||
+        View_p->RowStride   != Expected.RowStride ||
+        View_p->WordSize    != Expected.WordSize  ||
+        View_p->HaloRows    != Expected.HaloRows  ||
+        View_p->HaloColumns != Expected.HaloColumns)
+    {
+        GOL_DestroyWorld((GOL_Game_t*)&Game_p);
+        SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    if ((Buffer_p = SNAPSHOT_WrapBuffer(View_p->Data_p, Expected.Size, Release, Context_p)) == NULL)
+    {
+        GOL_DestroyWorld((GOL_Game_t*)&Game_p);
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    Current_pp = Game_p->Ops_p->GetCurrentBuffer(&Game_p->Data);
+    SNAPSHOT_ReleaseBuffer(*Current_pp);
+    *Current_pp = Buffer_p;
+    InvalidateStats(Game_p);
+
+    return Game_p;
+}
+
+
+void
+GOL_DestroyWorld(GOL_Game_t* Game_p)
+{
+    GameOfLife_t** Game_pp = (GameOfLife_t**)Game_p;
+
+    (*Game_pp)->Ops_p->Destroy(&(*Game_pp)->Data);
+
+    // Snapshots still held keep their buffers
+    PublishSnapshot(*Game_pp, NULL);
+    pthread_mutex_destroy(&(*Game_pp)->SnapshotLock);
+    HISTORY_Destroy(&(*Game_pp)->History);
+    REGION_Destroy(&(*Game_pp)->Region);
+
+    if ((*Game_pp)->Options.CountEvents)
+    {
+        PERF_CloseGroup(&(*Game_pp)->Counters);
+    }
+    THREADS_DestroyPool(&(*Game_pp)->Pool);
+    free(*Game_pp);
+    *Game_pp = NULL;
+}
+
+
+GOL_Status_t
+GOL_EvolveWorld(const GOL_Game_t Game)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    GOL_Status_t Status = GOL_OK;
+    long long FirstKept;
+    long long LastKept;
+    int Result;
+
+    // The generation the world started from is kept too
+    if (Game_p->Options.HistoryLength > 0 &&
+        (HISTORY_GetRange(&Game_p->History, &FirstKept, &LastKept) != 0 || LastKept != Game_p->Generation) &&
+        RecordHistory(Game_p) != 0)
+    {
+        Status = GOL_ERROR_OUT_OF_MEMORY;
+    }
+
+    // Worlds evolved in place write to the published buffer
+    if (Game_p->Options.InPlace)
+    {
+        PublishSnapshot(Game_p, NULL);
+    }
+
+    if (Game_p->Options.AutoGrowMargin > 0)
+    {
+        AutoResize(Game_p);
+    }
+
+    if (Game_p->Options.CountEvents)
+    {
+        PERF_StartGroup(&Game_p->Counters);
+        Result = Game_p->Ops_p->Evolve(&Game_p->Data);
+        PERF_StopGroup(&Game_p->Counters);
+        Game_p->CellUpdates += (long long)GOL_GetWorldWidth(Game_p) * GOL_GetWorldHeight(Game_p);
+    }
+    else
+    {
+        Result = Game_p->Ops_p->Evolve(&Game_p->Data);
+    }
+
+    // Without a buffer of its own to evolve into, the world stays as it was
+    if (Result != 0)
+    {
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+    REGION_Invalidate(&Game_p->Region);
+
+    Game_p->Generation++;
+    if (PublishCurrent(Game_p) != 0)
+    {
+        Status = GOL_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (Game_p->Options.HistoryLength > 0 && RecordHistory(Game_p) != 0)
+    {
+        Status = GOL_ERROR_OUT_OF_MEMORY;
+    }
+    return SetStatus(Status);
+}
+
+
+GOL_Status_t
+GOL_EvolveWorldInRanks(const GOL_Game_t Game,
+                       const int        NumberOfRanks,
+                       const int        NumberOfGenerations)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    const int Width  = GOL_GetWorldWidth(Game_p);
+    const int Height = GOL_GetWorldHeight(Game_p);
+    RANKS_World_t World;
+    uint64_t* Cells_p;
+    int Result;
+
+    if (NumberOfRanks <= 0 || NumberOfGenerations < 0)
+    {
+        return SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+    }
+    if (NumberOfGenerations == 0)
+    {
+        return SetStatus(GOL_OK);
+    }
+
+    if ((Cells_p = malloc(((Width + 63) / 64) * sizeof(uint64_t))) == NULL)
+    {
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+    if (RANKS_Create(&World, Width, Height, NumberOfRanks) != 0)
+    {
+        free(Cells_p);
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+
+    for (int Row = 0; Row < Height; Row++)
+    {
+        GetRow(Game_p, Row, Cells_p);
+        PackStreamRow(Cells_p, Width, World.NumberOfUintsPerRow, RANKS_GetRow(&World, Row));
+    }
+
+    // The ranks are forked by this thread, and inherit counters opened for
+    // them here, which they add to when they exit
+    if (Game_p->Options.CountEvents)
+    {
+        PERF_Counters_t RankCounters;
+
+        PERF_Open(&RankCounters, 1);
+        PERF_Start(&RankCounters);
+        Result = RANKS_Evolve(&World, NumberOfGenerations);
+        PERF_Stop(&RankCounters);
+        PERF_AddToGroup(&Game_p->Counters, &RankCounters);
+        PERF_Close(&RankCounters);
+        Game_p->CellUpdates += (long long)Width * Height * NumberOfGenerations;
+    }
+    else
+    {
+        Result = RANKS_Evolve(&World, NumberOfGenerations);
+    }
+    if (Result == 0)
+    {
+        long long FirstKept;
+        long long LastKept;
+
+        if (Game_p->Options.HistoryLength > 0 &&
+            (HISTORY_GetRange(&Game_p->History, &FirstKept, &LastKept) != 0 || LastKept != Game_p->Generation) &&
+            RecordHistory(Game_p) != 0)
+        {
+            Result = -1;
+        }
+
+        if (UnshareCurrent(Game_p) != 0)
+        {
+            RANKS_Destroy(&World);
+            free(Cells_p);
+            return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        }
+        for (int Row = 0; Row < Height; Row++)
+        {
+            UnpackStreamRow(RANKS_GetRow(&World, Row), Width, Cells_p);
+            SetRowInCurrent(Game_p, Row, Cells_p);
+        }
+        InvalidateStats(Game_p);
+
+        Game_p->Generation += NumberOfGenerations;
+        if (PublishCurrent(Game_p) != 0)
+        {
+            Result = -1;
+        }
+
+        if (Game_p->Options.HistoryLength > 0 && RecordHistory(Game_p) != 0)
+        {
+            Result = -1;
+        }
+    }
+
+    RANKS_Destroy(&World);
+    free(Cells_p);
+    return SetStatus((Result == 0) ? GOL_OK : GOL_ERROR_OUT_OF_MEMORY);
+}
+
+
+GOL_Game_t
+GOL_CloneWorld(const GOL_Game_t Game, const GOL_Variant_t Variant)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    GameOfLife_t* Clone_p = GOL_InitializeWorld(Variant, GOL_GetWorldWidth(Game_p), GOL_GetWorldHeight(Game_p), 0);
+    GOL_Status_t Status;
+
+    if (Clone_p == NULL)
+    {
+        return NULL;
+    }
+    if ((Status = CopyCells(Clone_p, Game_p, 0, 0)) != GOL_OK)
+    {
+        GOL_DestroyWorld((GOL_Game_t*)&Clone_p);
+        SetStatus(Status);
+        return NULL;
+    }
+
+    Clone_p->Generation   = Game_p->Generation;
+    Clone_p->OriginColumn = Game_p->OriginColumn;
+    Clone_p->OriginRow    = Game_p->OriginRow;
+    SetStatus(GOL_OK);
+    return Clone_p;
+}
+
+
+GOL_Status_t
+GOL_TuneWorld(const GOL_Game_t    Game,
+              const int           BudgetMilliseconds,
+              const char* const   CacheFilename_p,
+              GOL_Tuning_t* const Tuning_p)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    const int Width  = GOL_GetWorldWidth(Game_p);
+    const int Height = GOL_GetWorldHeight(Game_p);
+    const TUNE_Sampler_t Sampler = { MakeTuningSample, EvolveTuningSample, DestroyTuningSample, Game_p };
+    int Variants[GOL_VARIANT_LAST_ENTRY];
+    int NumberOfVariants = 0;
+    TUNE_Choice_t Choice;
+
+    if (BudgetMilliseconds <= 0)
+    {
+        return SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+    }
+
+    // REFERENCE worlds keep their own size
+    for (int Variant = 0; Variant < GOL_VARIANT_LAST_ENTRY; Variant++)
+    {
+        if (Variant != GOL_VARIANT_REFERENCE || (Width == DEFAULT_WORLD_WIDTH && Height == DEFAULT_WORLD_HEIGHT))
+        {
+            Variants[NumberOfVariants++] = Variant;
+        }
+    }
+
+    if (TUNE_Choose(CacheFilename_p, Width, Height, GOL_GetPopulation(Game_p), Variants, NumberOfVariants,
+                    BudgetMilliseconds / 1000.0, &Sampler, &Choice, &Tuning_p->Cached) != 0)
+    {
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+    Tuning_p->Variant              = (GOL_Variant_t)Choice.Variant;
+    Tuning_p->NumberOfThreads      = Choice.NumberOfThreads;
+    Tuning_p->InPlace              = Choice.InPlace;
+    Tuning_p->CellUpdatesPerSecond = Choice.CellUpdatesPerSecond;
+    return SetStatus(GOL_OK);
+}
+
+
+GOL_Census_t
+GOL_SearchSoups(const GOL_Variant_t      Variant,
+                const long long          NumberOfSoups,
+                const unsigned long long Seed,
+                const int                NumberOfThreads)
+{
+    GOL_Options_t Options;
+    THREADS_Pool_t Pool;
+    Census_t* Census_p;
+    int Failed;
+
+    if (NumberOfSoups < 0 || VARIANT_GetOps(Variant) == NULL)
+    {
+        SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    if (Variant == GOL_VARIANT_REFERENCE)
+    {
+        // Fixed at 39 x 20
+        SetStatus(GOL_ERROR_NOT_SUPPORTED);
+        return NULL;
+    }
+    if ((Census_p = calloc(1, sizeof(Census_t))) == NULL)
+    {
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    CENSUS_Initialize(&Census_p->Table);
+
+    GOL_GetOptions(&Options);
+    THREADS_CreatePool(&Pool, (NumberOfThreads > 0) ? NumberOfThreads : TUNE_GetNumberOfCpus(), Options.PinThreads);
+    Failed = CENSUS_SearchSoups(&Census_p->Table, VARIANT_GetOps(Variant), NumberOfSoups, Seed, &Pool) != 0;
+    THREADS_DestroyPool(&Pool);
+
+    if (Failed || (Census_p->Entries_p = CENSUS_Sort(&Census_p->Table)) == NULL)
+    {
+        GOL_DestroyCensus((GOL_Census_t*)&Census_p);
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    SetStatus(GOL_OK);
+    return Census_p;
+}
+
+
+int
+GOL_GetCensusSize(const GOL_Census_t Census)
+{
+    return ((Census_t*)Census)->Table.NumberOfEntries;
+}
+
+
+void
+GOL_GetCensusEntry(const GOL_Census_t Census,
+                   const int          Index,
+                   const char** const Code_pp,
+                   long long* const   Count_p)
+{
+    Census_t* Census_p = (Census_t*)Census;
+
+    *Code_pp = Census_p->Entries_p[Index].Code_p;
+    *Count_p = Census_p->Entries_p[Index].Count;
+}
+
+
+void
+GOL_DestroyCensus(GOL_Census_t* Census_p)
+{
+    Census_t** Census_pp = (Census_t**)Census_p;
+
+    CENSUS_Destroy(&(*Census_pp)->Table);
+    free((*Census_pp)->Entries_p);
+    free(*Census_pp);
+    *Census_pp = NULL;
+}
+
+
+GOL_Status_t
+GOL_GetEventCounts(const GOL_Game_t Game, GOL_EventCounts_t* const Counts_p)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    long long Counts[PERF_EVENT_LAST_ENTRY];
+
+    if (!Game_p->Options.CountEvents)
+    {
+        return SetStatus(GOL_ERROR_NOT_SUPPORTED);
+    }
+
+    PERF_ReadGroup(&Game_p->Counters, Counts);
+    Counts_p->CellUpdates  = Game_p->CellUpdates;
+    Counts_p->Cycles       = Counts[PERF_EVENT_CYCLES];
+    Counts_p->Instructions = Counts[PERF_EVENT_INSTRUCTIONS];
+    Counts_p->L1DMisses    = Counts[PERF_EVENT_L1D_MISSES];
+    Counts_p->LLCMisses    = Counts[PERF_EVENT_LLC_MISSES];
+    Counts_p->BranchMisses = Counts[PERF_EVENT_BRANCH_MISSES];
+    Counts_p->DTLBMisses   = Counts[PERF_EVENT_DTLB_MISSES];
+    return SetStatus(GOL_OK);
+}
+
+
+GOL_Status_t
+GOL_CompareWorlds(const GOL_Game_t Game1,
+                  const GOL_Game_t Game2,
+                  int* const       Column_p,
+                  int* const       Row_p)
+{
+    GameOfLife_t* Game1_p = (GameOfLife_t*)Game1;
+    GameOfLife_t* Game2_p = (GameOfLife_t*)Game2;
+    const COMPARE_World_t World1 =
+    {
+        GOL_GetWorldWidth(Game1_p), GOL_GetWorldHeight(Game1_p), Game1_p->OriginColumn, Game1_p->OriginRow,
+        GetRowOfGame, Game1_p
+    };
+    const COMPARE_World_t World2 =
+    {
+        GOL_GetWorldWidth(Game2_p), GOL_GetWorldHeight(Game2_p), Game2_p->OriginColumn, Game2_p->OriginRow,
+        GetRowOfGame, Game2_p
+    };
+
+    switch (COMPARE_Rows(&World1, &World2, Column_p, Row_p))
+    {
+    case 0:
+        return SetStatus(GOL_OK);
+
+    case 1:
+        return SetStatus(GOL_ERROR_MISMATCH);
+
+    default:
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+}
+
+
+GOL_Status_t
+GOL_EvolveAndCompare(const GOL_Game_t Game1,
+                     const GOL_Game_t Game2,
+                     const int        NumberOfGenerations,
+                     const int        QueueLength,
+                     long long* const Generation_p,
+                     int* const       Column_p,
+                     int* const       Row_p)
+{
+    long long Generation;
+    int Column;
+    int Row;
+
+    if (NumberOfGenerations < 0 || Game1 == Game2)
+    {
+        return SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+    }
+
+    switch (COMPARE_Run(EvolveForCompare, Game1, Game2, NumberOfGenerations, QueueLength,
+                        &Generation, &Column, &Row))
+    {
+    case 0:
+        return SetStatus(GOL_OK);
+
+    case 1:
+        if (Generation_p != NULL)
+        {
+            *Generation_p = Generation;
+        }
+        if (Column_p != NULL && Row_p != NULL)
+        {
+            *Column_p = Column;
+            *Row_p    = Row;
+        }
+        return SetStatus(GOL_ERROR_MISMATCH);
+
+    default:
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+}
+
+
+void
+GOL_OutputWorld(const GOL_Game_t Game)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    const int Width  = GOL_GetWorldWidth(Game_p);
+    const int Height = GOL_GetWorldHeight(Game_p);
+
+    {
+//        char worldstr[2*WORLDWIDTH+2];
+        char* worldstr = malloc(2*Width+2);
+        uint64_t* cells = malloc(((Width + 63) / 64) * sizeof(uint64_t));
+        int i, j;
+
+        if (worldstr == NULL || cells == NULL) {
+            free(worldstr);
+            free(cells);
+            return;
+        }
+
+        worldstr[2*Width+1] = '\0';
+        worldstr[0] = '+';
+        for (i = 1; i < 2*Width; i++)
+            worldstr[i] = '-';
+        worldstr[2*Width] = '+';
+        puts(worldstr);
+        for (i = 0; i <= 2*Width; i+=2)
+            worldstr[i] = '|';
+        for (i = 0; i < Height; i++) {
+            GetRow(Game_p, i, cells);
+            for (j = 0; j < Width; j++)
+                worldstr[2*j+1] = ((cells[j / 64] >> (j % 64)) & 1) ? CHAR_ALIVE : CHAR_DEAD;
+            puts(worldstr);
+        }
+        worldstr[0] = '+';
+        for (i = 1; i < 2*Width; i++)
+            worldstr[i] = '-';
+        worldstr[2*Width] = '+';
+        puts(worldstr);
+        free(worldstr);
+        free(cells);
+    }
+}
+
+
+GOL_Status_t
+GOL_SaveWorldToFile(const GOL_Game_t Game, const char* const Filename_p)
+{
+    const size_t Length = strlen(Filename_p);
+
+    if (Length >= 3 && strcmp(Filename_p + Length - 3, ".mc") == 0)
+    {
+        return SaveMacrocell((GameOfLife_t*)Game, Filename_p);
+    }
+    return SaveText((GameOfLife_t*)Game, Filename_p);
+}
+
+
+// One line per row, CHAR_ALIVE and CHAR_DEAD
+static GOL_Status_t
+SaveText(GameOfLife_t* Game_p, const char* const Filename_p)
+{
+    const int Width  = GOL_GetWorldWidth(Game_p);
+    const int Height = GOL_GetWorldHeight(Game_p);
+    FILE * pfile;
+    int i, j;
+    char* strwrite = malloc(Width + 1);
+    uint64_t* cells = malloc(((Width + 63) / 64) * sizeof(uint64_t));
+    GOL_Status_t Status = GOL_OK;
+
+    if (strwrite == NULL || cells == NULL) {
+        free(strwrite);
+        free(cells);
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+    if ((pfile = fopen(Filename_p, "w")) == NULL) {
+        free(strwrite);
+        free(cells);
+        return SetStatus(GOL_ERROR_IO);
+    }
+
+    strwrite[Width] = '\0'; /* null terminator */
+    for (j = 0; j < Height; j++) {
+        GetRow(Game_p, j, cells);
+        for (i = 0; i < Width; i++)
+            strwrite[i] = ((cells[i / 64] >> (i % 64)) & 1) ? CHAR_ALIVE : CHAR_DEAD;
+        if (fprintf(pfile,"%s\n",strwrite) < 0)
+            Status = GOL_ERROR_IO;
+    }
+
+    free(strwrite);
+    free(cells);
+    if (fclose(pfile) != 0)
+        Status = GOL_ERROR_IO;
+    return SetStatus(Status);
+}
+
+
+static GOL_Status_t
+SaveMacrocell(GameOfLife_t* Game_p, const char* const Filename_p)
+{
+    FILE* File_p;
+    int Result;
+
+    if ((File_p = fopen(Filename_p, "w")) == NULL)
+    {
+        return SetStatus(GOL_ERROR_IO);
+    }
+
+    Result = MACROCELL_Write(File_p, GOL_GetWorldWidth(Game_p), GOL_GetWorldHeight(Game_p), GetRowOfGame, Game_p);
+    if (fclose(File_p) != 0 && Result == 0)
+    {
+        Result = -1;
+    }
+    return SetStatus((Result == 0) ? GOL_OK : (Result == -2) ? GOL_ERROR_OUT_OF_MEMORY : GOL_ERROR_IO);
+}
+
+
+GOL_Status_t
+GOL_SaveWorldToPackedFile(const GOL_Game_t Game, const char* const Filename_p)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    const int Width  = GOL_GetWorldWidth(Game);
+    const int Height = GOL_GetWorldHeight(Game);
+    const int NumberOfUintsPerRow = (Width + 2 + 31) / 32;
+    const size_t BytesPerRow = NumberOfUintsPerRow * sizeof(uint_t);
+    uint_t* Row_p = calloc(NumberOfUintsPerRow, sizeof(uint_t));
+    uint64_t* Cells_p = malloc(((Width + 63) / 64) * sizeof(uint64_t));
+    SNAPSHOT_t Current;
+    int Result = 0;
+    int Fd;
+
+    if (Row_p == NULL || Cells_p == NULL)
+    {
+        free(Row_p);
+        free(Cells_p);
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+    if ((Fd = open(Filename_p, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+    {
+        free(Row_p);
+        free(Cells_p);
+        return SetStatus(GOL_ERROR_IO);
+    }
+
+    if (Game_p->Ops_p->Describe != NULL)
+    {
+        Game_p->Ops_p->Describe(&Game_p->Data, &Current);
+    }
+
+    Result = STREAM_WriteHeader(Fd, Width, Height);
+    for (int j = 0; Result == 0 && j < Height; j++)
+    {
+        const uint_t* Source_p = Row_p;
+
+        // BITS rows are written as they are
+        if (Game_p->Ops_p->Describe != NULL && Current.Layout == SNAPSHOT_LAYOUT_BITS)
+        {
+            Source_p = (const uint_t*)Current.Buffer_p + (size_t)(1 + j) * NumberOfUintsPerRow;
+        }
+        else
+        {
+            GetRow(Game_p, j, Cells_p);
+            PackStreamRow(Cells_p, Width, NumberOfUintsPerRow, Row_p);
+        }
+
+        if (pwrite(Fd, Source_p, BytesPerRow, sizeof(STREAM_Header_t) + (off_t)j * BytesPerRow) !=
+            (ssize_t)BytesPerRow)
+        {
+            Result = -1;
+        }
+    }
+
+    free(Row_p);
+    free(Cells_p);
+    if (close(Fd) != 0)
+    {
+        Result = -1;
+    }
+    return SetStatus((Result == 0) ? GOL_OK : GOL_ERROR_IO);
+}
+
+
+GOL_Status_t
+GOL_StreamEvolve(const char* const Filename_p,
+                 const char* const ScratchFilename_p,
+                 const int         NumberOfGenerations)
+{
+    THREADS_Pool_t Pool;
+    GOL_Options_t Options;
+    int SourceFd;
+    int TargetFd;
+    int Result = 0;
+
+    if ((SourceFd = open(Filename_p, O_RDWR)) < 0)
+    {
+        return SetStatus(GOL_ERROR_IO);
+    }
+    if ((TargetFd = open(ScratchFilename_p, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+    {
+        close(SourceFd);
+        return SetStatus(GOL_ERROR_IO);
+    }
+
+    GOL_GetOptions(&Options);
+    THREADS_CreatePool(&Pool, Options.NumberOfThreads, Options.PinThreads);
+
+    for (int i = 0; i < NumberOfGenerations && Result == 0; i++)
+    {
+        int TempFd = SourceFd;
+
+        Result = STREAM_EvolveFile(SourceFd, TargetFd, &Pool);
+        SourceFd = TargetFd;
+        TargetFd = TempFd;
+    }
+
+    THREADS_DestroyPool(&Pool);
+
+    // After an odd number of generations the result is in the scratch file
+    if (Result == 0 && (NumberOfGenerations % 2) != 0)
+    {
+        Result = rename(ScratchFilename_p, Filename_p);
+    }
+    else if (Result == 0)
+    {
+        unlink(ScratchFilename_p);
+    }
+
+    if (close(SourceFd) != 0 || close(TargetFd) != 0)
+    {
+        Result = -1;
+    }
+    return SetStatus((Result == 0) ? GOL_OK : GOL_ERROR_IO);
+}
+
+
+GOL_Pattern_t
+GOL_LoadPattern(const char* const Filename_p)
+{
+    GOL_Pattern_t Pattern = NULL;
+    FILE* File_p;
+    char* Text_p;
+    long Size;
+
+    if ((File_p = fopen(Filename_p, "rb")) == NULL)
+    {
+        SetStatus(GOL_ERROR_IO);
+        return NULL;
+    }
+
+    // Unless the text is read and parsed, which sets it again
+    SetStatus(GOL_ERROR_IO);
+    if (fseek(File_p, 0, SEEK_END) == 0 && (Size = ftell(File_p)) >= 0 &&
+        fseek(File_p, 0, SEEK_SET) == 0 && (Text_p = malloc(Size + 1)) != NULL)
+    {
+        if (fread(Text_p, 1, Size, File_p) == (size_t)Size)
+        {
+            Text_p[Size] = '\0';
+            Pattern = GOL_ParsePattern(Text_p);
+        }
+        free(Text_p);
+    }
+
+    fclose(File_p);
+    return Pattern;
+}
+
+
+GOL_Pattern_t
+GOL_ParsePattern(const char* const Text_p)
+{
+    PATTERN_t* Pattern_p = malloc(sizeof(PATTERN_t));
+
+    if (Pattern_p == NULL)
+    {
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    if (PATTERN_Parse(Pattern_p, Text_p) != 0)
+    {
+        PATTERN_Destroy(Pattern_p);
+        free(Pattern_p);
+        SetStatus(GOL_ERROR_FORMAT);
+        return NULL;
+    }
+
+    SetStatus(GOL_OK);
+    return Pattern_p;
+}
+
+
+void
+GOL_DestroyPattern(GOL_Pattern_t* Pattern_p)
+{
+    PATTERN_t** Pattern_pp = (PATTERN_t**)Pattern_p;
+
+    if (*Pattern_pp != NULL)
+    {
+        PATTERN_Destroy(*Pattern_pp);
+        free(*Pattern_pp);
+        *Pattern_pp = NULL;
+    }
+}
+
+
+GOL_Status_t
+GOL_StampPattern(const GOL_Game_t      Game,
+                 const GOL_Pattern_t   Pattern,
+                 const int             Column,
+                 const int             Row,
+                 const GOL_Transform_t Transform,
+                 const GOL_StampMode_t Mode)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    const PATTERN_Image_t* Image_p;
+    int FirstRow;
+    int EndRow;
+
+    if (Transform >= GOL_TRANSFORM_LAST_ENTRY || Mode >= GOL_STAMP_LAST_ENTRY ||
+        (Image_p = PATTERN_GetImage((PATTERN_t*)Pattern, (PATTERN_Transform_t)Transform)) == NULL)
+    {
+        return SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (UnshareCurrent(Game_p) != 0)
+    {
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+
+    FirstRow = (Row > 0) ? 0 : -Row;
+    EndRow   = GOL_GetWorldHeight(Game_p) - Row;
+    EndRow   = (EndRow < Image_p->Height) ? EndRow : Image_p->Height;
+
+    for (int j = FirstRow; j < EndRow; j++)
+    {
+        StampRowInCurrent(Game_p, Row + j, Column, Image_p->Rows_p + (size_t)j * Image_p->WordsPerRow,
+                          Image_p->Width, (PATTERN_Mode_t)Mode);
+    }
+
+    InvalidateStats(Game_p);
+    return SetStatus(GOL_OK);
+}
+
+
+GOL_Snapshot_t
+GOL_AcquireSnapshot(const GOL_Game_t Game)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    SNAPSHOT_t* Snapshot_p;
+
+    pthread_mutex_lock(&Game_p->SnapshotLock);
+    Snapshot_p = Game_p->Published_p;
+    if (Snapshot_p != NULL)
+    {
+        SNAPSHOT_Retain(Snapshot_p);
+    }
+    pthread_mutex_unlock(&Game_p->SnapshotLock);
+
+    SetStatus((Snapshot_p != NULL) ? GOL_OK : GOL_ERROR_NOT_FOUND);
+    return Snapshot_p;
+}
+
+
+void
+GOL_ReleaseSnapshot(GOL_Snapshot_t* Snapshot_p)
+{
+    SNAPSHOT_Release((SNAPSHOT_t*)*Snapshot_p);
+    *Snapshot_p = NULL;
+}
+
+
+long long
+GOL_GetSnapshotGeneration(const GOL_Snapshot_t Snapshot)
+{
+    return ((SNAPSHOT_t*)Snapshot)->Generation;
+}
+
+
+int
+GOL_GetSnapshotWidth(const GOL_Snapshot_t Snapshot)
+{
+    return ((SNAPSHOT_t*)Snapshot)->Width;
+}
+
+
+int
+GOL_GetSnapshotHeight(const GOL_Snapshot_t Snapshot)
+{
+    return ((SNAPSHOT_t*)Snapshot)->Height;
+}
+
+
+int
+GOL_GetSnapshotCellState(const GOL_Snapshot_t Snapshot, const int Column, const int Row)
+{
+    return SNAPSHOT_GetCellState((SNAPSHOT_t*)Snapshot, Column, Row);
+}
+
+
+void
+GOL_GetSnapshotRow(const GOL_Snapshot_t Snapshot, const int Row, uint64_t* const Cells_p)
+{
+    SNAPSHOT_GetRow((SNAPSHOT_t*)Snapshot, Row, Cells_p);
+}
+
+
+GOL_Status_t
+GOL_GetBufferView(const GOL_Game_t Game, GOL_BufferView_t* const View_p)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    SNAPSHOT_t Current;
+
+    if (Game_p->Ops_p->Describe == NULL)
+    {
+        return SetStatus(GOL_ERROR_NOT_SUPPORTED);
+    }
+
+    Game_p->Ops_p->Describe(&Game_p->Data, &Current);
+    return FillBufferView(View_p, &Current);
+}
+
+
+GOL_Status_t
+GOL_GetSnapshotBufferView(const GOL_Snapshot_t Snapshot, GOL_BufferView_t* const View_p)
+{
+    SNAPSHOT_t* Snapshot_p = (SNAPSHOT_t*)Snapshot;
+
+    return FillBufferView(View_p, Snapshot_p);
+}
+
+
+GOL_Recorder_t
+GOL_StartRecording(const char* const       Path_p,
+                   const GOL_FrameFormat_t Format,
+                   const int               QueueLength)
+{
+    FRAMES_Recorder_t* Recorder_p;
+
+    if (Format < 0 || Format >= GOL_FRAMES_LAST_ENTRY)
+    {
+        SetStatus(GOL_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    Recorder_p = FRAMES_Start(Path_p, (FRAMES_Format_t)Format, QueueLength);
+    SetStatus((Recorder_p != NULL) ? GOL_OK : GOL_ERROR_IO);
+    return Recorder_p;
+}
+
+
+GOL_Status_t
+GOL_RecordFrame(const GOL_Recorder_t Recorder, const GOL_Game_t Game)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    SNAPSHOT_t* Snapshot_p;
+
+    // REFERENCE worlds have no buffer to share
+    if ((Snapshot_p = CreateSnapshot(Game_p)) == NULL &&
+        (Snapshot_p = CopySnapshot(Game_p)) == NULL)
+    {
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+
+    return SetStatus((FRAMES_Add((FRAMES_Recorder_t*)Recorder, Snapshot_p) == 0) ? GOL_OK : GOL_ERROR_IO);
+}
+
+
+GOL_Status_t
+GOL_StopRecording(GOL_Recorder_t* Recorder_p)
+{
+    int Result = FRAMES_Stop((FRAMES_Recorder_t*)*Recorder_p);
+
+    *Recorder_p = NULL;
+    return SetStatus((Result == 0) ? GOL_OK : GOL_ERROR_IO);
+}
+
+
+// Describes the buffer of a snapshot with the BYTES or BITS layout.
+// Returns GOL_ERROR_NOT_SUPPORTED for other layouts.
+static GOL_Status_t
+FillBufferView(GOL_BufferView_t* const View_p, const SNAPSHOT_t* const Snapshot_p)
+{
+    switch (Snapshot_p->Layout)
+    {
+    case SNAPSHOT_LAYOUT_BYTES:
+        View_p->Format   = GOL_BUFFER_BYTES;
+        View_p->WordSize = 1;
+        break;
+
+    case SNAPSHOT_LAYOUT_BITS:
+        View_p->Format   = GOL_BUFFER_BITS;
+        View_p->WordSize = sizeof(uint_t);
+        break;
+
+    default:
+        return SetStatus(GOL_ERROR_NOT_SUPPORTED);
+    }
+
+    View_p->Data_p      = (void*)Snapshot_p->Buffer_p;
+    View_p->Width       = Snapshot_p->Width;
+    View_p->Height      = Snapshot_p->Height;
+    View_p->RowStride   = (size_t)Snapshot_p->Stride * View_p->WordSize;
+    View_p->Size        = View_p->RowStride * (Snapshot_p->Height + 2);
+    View_p->HaloRows    = 1;
+    View_p->HaloColumns = 1;
+    return SetStatus(GOL_OK);
+}
+
+
+long long
+GOL_GetGeneration(const GOL_Game_t Game)
+{
+    return ((GameOfLife_t*)Game)->Generation;
+}
+
+
+int
+GOL_GetHistoryRange(const GOL_Game_t Game, long long* const First_p, long long* const Last_p)
+{
+    return HISTORY_GetRange(&((GameOfLife_t*)Game)->History, First_p, Last_p);
+}
+
+
+GOL_Status_t
+GOL_SeekGeneration(const GOL_Game_t Game, const long long Generation)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    const uint64_t* Cells_p;
+    int Width;
+    int Height;
+    int OriginColumn;
+    int OriginRow;
+
+    switch (HISTORY_Seek(&Game_p->History, Generation, &Cells_p, &Width, &Height, &OriginColumn, &OriginRow))
+    {
+    case 0:
+        break;
+
+    case 1:
+        return SetStatus(GOL_ERROR_NOT_FOUND);
+
+    default:
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+
+    // Only worlds that grow change size, the old cells are all overwritten
+    if (Width != GOL_GetWorldWidth(Game_p) || Height != GOL_GetWorldHeight(Game_p))
+    {
+        if (Game_p->Ops_p->Resize == NULL)
+        {
+            return SetStatus(GOL_ERROR_NOT_SUPPORTED);
+        }
+        if (Game_p->Ops_p->Resize(&Game_p->Data, Width, Height, 0, 0) != 0)
+        {
+            return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        }
+    }
+
+    if (UnshareCurrent(Game_p) != 0)
+    {
+        return SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+    }
+    for (int Row = 0; Row < Height; Row++)
+    {
+        SetRowInCurrent(Game_p, Row, Cells_p + (size_t)Row * ((Width + 63) / 64));
+    }
+    InvalidateStats(Game_p);
+
+    Game_p->OriginColumn = OriginColumn;
+    Game_p->OriginRow    = OriginRow;
+    Game_p->Generation   = Generation;
+    return SetStatus((PublishCurrent(Game_p) == 0) ? GOL_OK : GOL_ERROR_OUT_OF_MEMORY);
+}
+
+
+// Keeps Status for GOL_GetLastError() on this thread and returns it
+static GOL_Status_t
+SetStatus(const GOL_Status_t Status)
+{
+    LastStatus = Status;
+    return Status;
+}
+
+
+// Packs a row of the current world, bit c % 64 of word c / 64 is column c
+static void
+GetRow(GameOfLife_t* Game_p, const int Row, uint64_t* const Cells_p)
+{
+    Game_p->Ops_p->GetRow(&Game_p->Data, Row, Cells_p);
+}
+
+
+// Sets a cell state in the current world. Used for loading files only,
+// into worlds that have no snapshot yet to share their buffer with.
+static void
+SetCellStateInCurrent(const GOL_Game_t Game, const int Column, const int Row, const int State)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+
+    Game_p->Ops_p->SetCellState(&Game_p->Data, Column, Row, State);
+}
+
+
+// Sets a whole row in the current world, from the packed words of Cells_p
+static void
+SetRowInCurrent(GameOfLife_t* Game_p, const int Row, const uint64_t* const Cells_p)
+{
+    Game_p->Ops_p->SetRow(&Game_p->Data, Row, Cells_p);
+}
+
+
+// Combines a row of packed pattern cells into the current world
+static void
+StampRowInCurrent(GameOfLife_t*         Game_p,
+                  const int             Row,
+                  const int             Column,
+                  const uint64_t* const Cells_p,
+                  const int             NumberOfColumns,
+                  const PATTERN_Mode_t  Mode)
+{
+    Game_p->Ops_p->StampRow(&Game_p->Data, Row, Column, Cells_p, NumberOfColumns, Mode);
+}
+
+
+// Must be called after the current world is modified directly
+static void
+InvalidateStats(GameOfLife_t* Game_p)
+{
+    Game_p->Ops_p->InvalidateStats(&Game_p->Data);
+    REGION_Invalidate(&Game_p->Region);
+}
+
+
+// Must be called before the current world is modified directly, so that
+// a snapshot of it is left as it was. Returns 0, or -1 if out of memory,
+// when the world must not be modified.
+static int
+UnshareCurrent(GameOfLife_t* Game_p)
+{
+    if (Game_p->Ops_p->GetCurrentBuffer != NULL &&
+        SNAPSHOT_UnshareBuffer(Game_p->Ops_p->GetCurrentBuffer(&Game_p->Data), 1) < 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+
+// Replaces the published snapshot, which may be NULL
+static void
+PublishSnapshot(GameOfLife_t* Game_p, SNAPSHOT_t* Snapshot_p)
+{
+    SNAPSHOT_t* OldSnapshot_p;
+
+    pthread_mutex_lock(&Game_p->SnapshotLock);
+    OldSnapshot_p = Game_p->Published_p;
+    Game_p->Published_p = Snapshot_p;
+    pthread_mutex_unlock(&Game_p->SnapshotLock);
+
+    SNAPSHOT_Release(OldSnapshot_p);
+}
+
+
+// Publishes a snapshot of the current world. Returns 0, or -1 if out of
+// memory, with no snapshot published rather than one of another generation.
 static int
-GetCellState(const GOL_Game_t Game, const int Column, const int Row);
+PublishCurrent(GameOfLife_t* Game_p)
+{
+    SNAPSHOT_t* Snapshot_p = CreateSnapshot(Game_p);
 
-static void
-SetCellStateInCurrent(const GOL_Game_t Game, const int Column, const int Row, const int State);
+    PublishSnapshot(Game_p, Snapshot_p);
+    return (Snapshot_p == NULL && Game_p->Ops_p->Describe != NULL) ? -1 : 0;
+}
 
 
-GOL_Game_t
-GOL_InitializeWorld(const GOL_Variant_t Variant,
-                    const int           Width,
-                    const int           Height,
-                    const int           UseDefaultPattern)
+// Returns a snapshot of the current world, sharing its buffer
+static SNAPSHOT_t*
+CreateSnapshot(GameOfLife_t* Game_p)
 {
-    GameOfLife_t* Game_p = NULL;
-    char* VariantName_p = NULL;
+    SNAPSHOT_t Current;
+    SNAPSHOT_t* Snapshot_p;
 
-    switch (Variant)
+    if (Game_p->Ops_p->Describe == NULL)
     {
-    case GOL_VARIANT_REFERENCE:
-        Game_p = malloc(sizeof(GameOfLife_t));
-        Game_p->Variant = GOL_VARIANT_REFERENCE;
-        initialize_world(&Game_p->Data.RefGame);
-        VariantName_p = "REFERENCE";
-        break;
+        return NULL;
+    }
 
-    case GOL_VARIANT_ARRAY:
-        Game_p = malloc(sizeof(GameOfLife_t));
-        Game_p->Variant = GOL_VARIANT_ARRAY;
-        ARRAY_InitializeWorld(&Game_p->Data.ArrayGame, Width, Height);
-        VariantName_p = "ARRAY";
-        break;
+    Game_p->Ops_p->Describe(&Game_p->Data, &Current);
+    Snapshot_p = SNAPSHOT_Create(Current.Layout, Current.Width, Current.Height, Current.Stride,
+                                 Current.Buffer_p, Current.TileIndex_p, Game_p->Generation);
+    if (Snapshot_p != NULL)
+    {
+        Snapshot_p->OriginColumn = Game_p->OriginColumn;
+        Snapshot_p->OriginRow    = Game_p->OriginRow;
+    }
+    return Snapshot_p;
+}
 
-    case GOL_VARIANT_BITS:
-        Game_p = malloc(sizeof(GameOfLife_t));
-        Game_p->Variant = GOL_VARIANT_BITS;
-        BITS_InitializeWorld(&Game_p->Data.BitsGame, Width, Height);
-        VariantName_p = "BITS";
-        break;
 
-    default:
-        printf("Invalid implementation variant: %d\n", Variant);
+// Returns a snapshot of a copy of the current world, in BITS layout, or
+// NULL if memory runs out
+static SNAPSHOT_t*
+CopySnapshot(GameOfLife_t* Game_p)
+{
+    const int UintInBits = sizeof(uint_t) * 8;
+    const int Width  = GOL_GetWorldWidth(Game_p);
+    const int Height = GOL_GetWorldHeight(Game_p);
+    const int NumberOfUints = (Width + 2 + (UintInBits - 1)) / UintInBits;
+    SNAPSHOT_t* Snapshot_p = NULL;
+    uint64_t* Cells_p;
+    uint_t* Buffer_p;
+
+    if ((Cells_p = malloc(((Width + 63) / 64) * sizeof(uint64_t))) == NULL)
+    {
+        return NULL;
     }
-
-    if (Game_p != NULL)
+    if ((Buffer_p = SNAPSHOT_AllocateBuffer((size_t)NumberOfUints * (Height + 2) * sizeof(uint_t))) != NULL)
     {
-        printf("Initialized **%s** world\n", VariantName_p);
+        memset(Buffer_p, 0, NumberOfUints * sizeof(uint_t));
+        memset(Buffer_p + (size_t)(Height + 1) * NumberOfUints, 0, NumberOfUints * sizeof(uint_t));
+        for (int Row = 0; Row < Height; Row++)
+        {
+            GetRow(Game_p, Row, Cells_p);
+            PackStreamRow(Cells_p, Width, NumberOfUints, Buffer_p + (size_t)(Row + 1) * NumberOfUints);
+        }
 
-        if (UseDefaultPattern)
+        // The snapshot holds the only reference left
+        Snapshot_p = SNAPSHOT_Create(SNAPSHOT_LAYOUT_BITS, Width, Height, NumberOfUints,
+                                     Buffer_p, NULL, Game_p->Generation);
+        if (Snapshot_p != NULL)
         {
-            // Insert the Pattern "Glider"
-            SetCellStateInCurrent(Game_p, 1, 2, ALIVE);
-            SetCellStateInCurrent(Game_p, 3, 1, ALIVE);
-            SetCellStateInCurrent(Game_p, 3, 2, ALIVE);
-            SetCellStateInCurrent(Game_p, 3, 3, ALIVE);
-            SetCellStateInCurrent(Game_p, 2, 3, ALIVE);
+            Snapshot_p->OriginColumn = Game_p->OriginColumn;
+            Snapshot_p->OriginRow    = Game_p->OriginRow;
         }
+        SNAPSHOT_ReleaseBuffer(Buffer_p);
     }
 
-    return Game_p;
+    free(Cells_p);
+    return Snapshot_p;
 }
 
 
-GOL_Game_t
-GOL_InitializeWorldFromFile(const GOL_Variant_t Variant,
-                            const int           Width,
-                            const int           Height,
-                            const char* const   Filename_p)
+// Keeps the current generation in the history
+// Without the memory for it, the history is dropped and the world goes on
+// without one. Returns 0, or -1 if it was dropped.
+static int
+RecordHistory(GameOfLife_t* Game_p)
 {
-    GameOfLife_t* Game_p = NULL;
-
-    Game_p = GOL_InitializeWorld(Variant, Width, Height, 0);
-    if (Game_p != NULL)
+    if (HISTORY_Record(&Game_p->History, Game_p->Generation,
+                       GOL_GetWorldWidth(Game_p), GOL_GetWorldHeight(Game_p),
+                       Game_p->OriginColumn, Game_p->OriginRow,
+                       GetRowOfGame, Game_p) != 0)
     {
-        FILE * pfile;
-        int i = 0, j = 0, len;
-        char strread[256];
-
-        if ((pfile = fopen(Filename_p, "r")) == NULL) {
-                fprintf(stderr,"Error: unable to read \"%s\" (error #%d).\n",
-                        Filename_p, errno);
-                abort();
-        }
+        HISTORY_Destroy(&Game_p->History);
+        Game_p->Options.HistoryLength = 0;
+        return -1;
+    }
+    return 0;
+}
 
-        while (j < Height && !feof(pfile) &&
-                        fgets(strread, 256, pfile) != NULL) {
-                /* jth line read */
-                len = strlen(strread);
-                if (len > Width)
-                        len = Width; /* ignore extra chars */
-                for (i = 0; i < len; i++)
-                    SetCellStateInCurrent(Game_p, i, j, strread[i] == CHAR_ALIVE ? ALIVE : DEAD);
-                j++; /* next line */
-        }
-        fclose(pfile);
 
-    }
-    return Game_p;
+// For the modules that read the world a row at a time
+static void
+GetRowOfGame(void* Context_p, const int Row, uint64_t* const Cells_p)
+{
+    GetRow((GameOfLife_t*)Context_p, Row, Cells_p);
 }
 
 
-void
-GOL_DestroyWorld(GOL_Game_t* Game_p)
+// One step of GOL_EvolveAndCompare(), on the thread of the world
+static SNAPSHOT_t*
+EvolveForCompare(void* Context_p)
 {
-    GameOfLife_t** Game_pp = (GameOfLife_t**)Game_p;
-    switch ((*Game_pp)->Variant)
+    GameOfLife_t* Game_p = (GameOfLife_t*)Context_p;
+    SNAPSHOT_t* Snapshot_p;
+    const long long Generation = Game_p->Generation;
+
+    // A world that could not be evolved ends the comparison
+    if (GOL_EvolveWorld(Game_p) != GOL_OK && Game_p->Generation == Generation)
     {
-    case GOL_VARIANT_REFERENCE:
-        // No action
-        break;
+        return NULL;
+    }
 
-    case GOL_VARIANT_ARRAY:
-        ARRAY_DestroyWorld(&(*Game_pp)->Data.ArrayGame);
-        break;
+    // REFERENCE worlds have no buffer to share
+    if ((Snapshot_p = CreateSnapshot(Game_p)) == NULL)
+    {
+        Snapshot_p = CopySnapshot(Game_p);
+    }
+    return Snapshot_p;
+}
 
-    case GOL_VARIANT_BITS:
-        BITS_DestroyWorld(&(*Game_pp)->Data.BitsGame);
-        break;
 
-    default:
-        printf("Invalid implementation variant: %d\n", (*Game_pp)->Variant);
+// Packed file rows have bit b of uint b / 32 as column b - 1, as BITS rows
+static void
+UnpackStreamRow(const uint_t* const Row_p, const int Width, uint64_t* const Cells_p)
+{
+    memset(Cells_p, 0, ((Width + 63) / 64) * sizeof(uint64_t));
+    for (int Column = 0; Column < Width; Column++)
+    {
+        const int Bit = Column + 1;
+        Cells_p[Column / 64] |= (uint64_t)((Row_p[Bit / 32] >> (Bit % 32)) & 1) << (Column % 64);
     }
-
-    free(*Game_pp);
-    *Game_pp = NULL;
 }
 
 
-void
-GOL_EvolveWorld(const GOL_Game_t Game)
+static void
+PackStreamRow(const uint64_t* const Cells_p, const int Width, const int NumberOfUints, uint_t* const Row_p)
 {
-    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
-    switch (Game_p->Variant)
+    memset(Row_p, 0, NumberOfUints * sizeof(uint_t));
+    for (int Column = 0; Column < Width; Column++)
     {
-    case GOL_VARIANT_REFERENCE:
-        next_generation(&Game_p->Data.RefGame);
-        break;
+        const int Bit = Column + 1;
+        Row_p[Bit / 32] |= (uint_t)((Cells_p[Column / 64] >> (Column % 64)) & 1) << (Bit % 32);
+    }
+}
 
-    case GOL_VARIANT_ARRAY:
-        ARRAY_EvolveWorld(&Game_p->Data.ArrayGame);
-        break;
 
-    case GOL_VARIANT_BITS:
-        BITS_EvolveWorld(&Game_p->Data.BitsGame);
-        break;
+static void
+FillRandomBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    RandomFill_t* Fill_p = (RandomFill_t*)Context_p;
+    const int Width = GOL_GetWorldWidth(Fill_p->Game_p);
+    uint64_t* Cells_p = Fill_p->Rows_p + (size_t)ThreadIndex * ((Width + 63) / 64);
+    int Start;
+    int End;
 
-    default:
-        printf("Invalid implementation variant: %d\n", Game_p->Variant);
+    THREADS_GetBand(GOL_GetWorldHeight(Fill_p->Game_p), ThreadIndex, NumberOfThreads, &Start, &End);
+
+    for (int Row = Start; Row < End; Row++)
+    {
+        RANDOM_GetRow(Cells_p, Width, Row, Fill_p->Seed, Fill_p->Density);
+        SetRowInCurrent(Fill_p->Game_p, Row, Cells_p);
     }
 }
 
 
-void
-GOL_CompareWorlds(const GOL_Game_t Game1, const GOL_Game_t Game2)
+// Packs the lines of one band, 64 characters to a word, CHAR_ALIVE is alive
+static void
+LoadTextBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
 {
-    int Game1_Width;
-    int Game1_Height;
-    int Game2_Width;
-    int Game2_Height;
-    int MaxWidth;
-    int MaxHeight;
+    TextLoad_t* Load_p = (TextLoad_t*)Context_p;
+    const int Width = GOL_GetWorldWidth(Load_p->Game_p);
+    uint64_t* Cells_p = Load_p->Rows_p + (size_t)ThreadIndex * ((Width + 63) / 64);
+    int Start;
+    int End;
+
+    THREADS_GetBand(GOL_GetWorldHeight(Load_p->Game_p), ThreadIndex, NumberOfThreads, &Start, &End);
+    End = (End < Load_p->NumberOfLines) ? End : Load_p->NumberOfLines;
 
-    Game1_Width = GOL_GetWorldWidth(Game1);
-    Game2_Width = GOL_GetWorldWidth(Game2);
+    for (int Row = Start; Row < End; Row++)
+    {
+        const char* Line_p = Load_p->Text_p + Load_p->LineStarts_p[Row];
+        const size_t LineLength = Load_p->LineStarts_p[Row + 1] - Load_p->LineStarts_p[Row];
+        const int Length = (LineLength < (size_t)Load_p->Width) ? (int)LineLength : Load_p->Width;
+
+        memset(Cells_p, 0, ((Width + 63) / 64) * sizeof(uint64_t));
+        for (int Word = 0; Word < Length / 64; Word++)
+        {
+            const char* Chars_p = Line_p + Word * 64;
+            uint64_t Cells = 0;
+
+            for (int Bit = 0; Bit < 64; Bit++)
+            {
+                Cells |= (uint64_t)(Chars_p[Bit] == CHAR_ALIVE) << Bit;
+            }
+            Cells_p[Word] = Cells;
+        }
+        for (int Column = Length & ~63; Column < Length; Column++)
+        {
+            Cells_p[Column / 64] |= (uint64_t)(Line_p[Column] == CHAR_ALIVE) << (Column % 64);
+        }
+        SetRowInCurrent(Load_p->Game_p, Row, Cells_p);
+    }
+}
 
-    Game1_Height = GOL_GetWorldHeight(Game1);
-    Game2_Height = GOL_GetWorldHeight(Game2);
 
-    MaxWidth = (Game1_Width > Game2_Width) ? Game1_Width : Game2_Width;
-    MaxHeight = (Game1_Height > Game2_Height) ? Game1_Height : Game2_Height;
+// Copies the cells of Source_p from (Column, Row) on into the whole of
+// Target_p, cells past the end of Source_p are dead
+static GOL_Status_t
+CopyCells(GameOfLife_t* Target_p, GameOfLife_t* Source_p, const int Column, const int Row)
+{
+    const int TargetWidth  = GOL_GetWorldWidth(Target_p);
+    const int TargetHeight = GOL_GetWorldHeight(Target_p);
+    const int SourceWidth  = GOL_GetWorldWidth(Source_p);
+    const int SourceHeight = GOL_GetWorldHeight(Source_p);
+    const int NumberOfWords = (TargetWidth + 63) / 64;
+    uint64_t* SourceCells_p = malloc(((SourceWidth + 63) / 64) * sizeof(uint64_t));
+    uint64_t* TargetCells_p = malloc(NumberOfWords * sizeof(uint64_t));
+
+    if (SourceCells_p == NULL || TargetCells_p == NULL)
+    {
+        free(SourceCells_p);
+        free(TargetCells_p);
+        return GOL_ERROR_OUT_OF_MEMORY;
+    }
 
-    for (int x = 0; x < MaxWidth; x++)
+    for (int r = 0; r < TargetHeight; r++)
     {
-        for (int y = 0; y < MaxHeight; y++)
+        memset(TargetCells_p, 0, NumberOfWords * sizeof(uint64_t));
+        if (Row + r < SourceHeight)
         {
-            if (GetCellState(Game1, x, y) != GetCellState(Game2, x, y))
+            GetRow(Source_p, Row + r, SourceCells_p);
+            for (int Word = 0; Word < NumberOfWords; Word++)
             {
-                printf("ERROR! Worlds are not equal! X=%d Y= %d\n", x, y);
-                printf("GAME1\n");
-                GOL_OutputWorld(Game1);
-                printf("GAME2\n");
-                GOL_OutputWorld(Game2);
-                exit(-1);
+                TargetCells_p[Word] = PATTERN_GetBits(SourceCells_p, SourceWidth, Column + 64 * Word) &
+                                      PATTERN_GetMask(TargetWidth, 64 * Word);
             }
         }
+        SetRowInCurrent(Target_p, r, TargetCells_p);
     }
+    InvalidateStats(Target_p);
+
+    free(SourceCells_p);
+    free(TargetCells_p);
+    return GOL_OK;
 }
 
 
-void
-GOL_OutputWorld(const GOL_Game_t Game)
+// A world of the choice holding the sample of the world being tuned
+static void*
+MakeTuningSample(void*                      Context_p,
+                 const TUNE_Choice_t* const Choice_p,
+                 const int                  Column,
+                 const int                  Row,
+                 const int                  Width,
+                 const int                  Height)
 {
-    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
-    int Width;
-    int Height;
+    GameOfLife_t* Sample_p;
+    GOL_Options_t Options;
 
-    switch (Game_p->Variant)
+    GOL_GetOptions(&Options);
+    Options.NumberOfThreads = Choice_p->NumberOfThreads;
+    Options.InPlace         = Choice_p->InPlace;
+    Options.AutoGrowMargin  = 0;
+    Options.HistoryLength   = 0;
+    Options.CountEvents     = 0;
+
+    if ((Sample_p = InitializeWorld((GOL_Variant_t)Choice_p->Variant, Width, Height, 0, &Options)) == NULL)
     {
-    case GOL_VARIANT_REFERENCE:
-        Width = get_world_width();
-        Height = get_world_height();
-        break;
+        return NULL;
+    }
+    if (CopyCells(Sample_p, (GameOfLife_t*)Context_p, Column, Row) != GOL_OK)
+    {
+        GOL_DestroyWorld((GOL_Game_t*)&Sample_p);
+        return NULL;
+    }
+    return Sample_p;
+}
 
-    case GOL_VARIANT_ARRAY:
-        Width  = Game_p->Data.ArrayGame.Width;
-        Height = Game_p->Data.ArrayGame.Height;
-        break;
 
-    case GOL_VARIANT_BITS:
-        Width  = Game_p->Data.BitsGame.Width;
-        Height = Game_p->Data.BitsGame.Height;
-        break;
+static void
+EvolveTuningSample(void* Sample_p)
+{
+    GOL_EvolveWorld(Sample_p);
+}
 
-    default:
-        printf("Invalid implementation variant: %d\n", Game_p->Variant);
-        return;
+
+static void
+DestroyTuningSample(void* Sample_p)
+{
+    GOL_DestroyWorld((GOL_Game_t*)&Sample_p);
+}
+
+
+/*
+ * The top left cell of the root goes to the top left cell of the world,
+ * where it was when the world was saved, unless live cells would be left
+ * out. Then the top left of the live cells does, as for a pattern.
+ */
+static GOL_Status_t
+LoadMacrocell(GameOfLife_t* Game_p, const char* const Text_p, const size_t Size)
+{
+    MacrocellLoad_t Load;
+    int Result;
+
+    if ((Result = MACROCELL_Parse(&Load.Tree, Text_p, Size)) != 0)
+    {
+        return (Result == -2) ? GOL_ERROR_OUT_OF_MEMORY : GOL_ERROR_FORMAT;
     }
 
+    Load.Game_p = Game_p;
+    Load.Column = 0;
+    Load.Row    = 0;
+    if (Load.Tree.MaxColumn >= GOL_GetWorldWidth(Game_p) || Load.Tree.MaxRow >= GOL_GetWorldHeight(Game_p))
     {
-//        char worldstr[2*WORLDWIDTH+2];
-        char* worldstr = malloc(2*Width+2);
-        int i, j;
+        Load.Column = Load.Tree.MinColumn;
+        Load.Row    = Load.Tree.MinRow;
+    }
 
-        worldstr[2*Width+1] = '\0';
-        worldstr[0] = '+';
-        for (i = 1; i < 2*Width; i++)
-            worldstr[i] = '-';
-        worldstr[2*Width] = '+';
-        puts(worldstr);
-        for (i = 0; i <= 2*Width; i+=2)
-            worldstr[i] = '|';
-        for (i = 0; i < Height; i++) {
-            for (j = 0; j < Width; j++)
-                worldstr[2*j+1] = GetCellState(Game_p, j, i) == ALIVE ? CHAR_ALIVE : CHAR_DEAD;
-            puts(worldstr);
-        }
-        worldstr[0] = '+';
-        for (i = 1; i < 2*Width; i++)
-            worldstr[i] = '-';
-        worldstr[2*Width] = '+';
-        puts(worldstr);
-        free(worldstr);
+    Load.Rows_p = malloc((size_t)THREADS_GetNumberOfThreads(&Game_p->Pool) *
+                         ((GOL_GetWorldWidth(Game_p) + 63) / 64) * sizeof(uint64_t));
+    if (Load.Rows_p == NULL)
+    {
+        MACROCELL_Destroy(&Load.Tree);
+        return GOL_ERROR_OUT_OF_MEMORY;
     }
+
+    THREADS_Run(&Game_p->Pool, LoadMacrocellBand, &Load);
+    free(Load.Rows_p);
+    MACROCELL_Destroy(&Load.Tree);
+    return GOL_OK;
 }
 
 
-void
-GOL_SaveWorldToFile(const GOL_Game_t Game, const char* const Filename_p)
+// Flattens the rows of one band out of the quadtree
+static void
+LoadMacrocellBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
 {
-    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
-    int Width;
-    int Height;
+    MacrocellLoad_t* Load_p = (MacrocellLoad_t*)Context_p;
+    const int Width = GOL_GetWorldWidth(Load_p->Game_p);
+    uint64_t* Cells_p = Load_p->Rows_p + (size_t)ThreadIndex * ((Width + 63) / 64);
+    int Start;
+    int End;
 
-    switch (Game_p->Variant)
+    THREADS_GetBand(GOL_GetWorldHeight(Load_p->Game_p), ThreadIndex, NumberOfThreads, &Start, &End);
+
+    for (int Row = Start; Row < End; Row++)
     {
-    case GOL_VARIANT_REFERENCE:
-        Width = get_world_width();
-        Height = get_world_height();
-        break;
+        MACROCELL_GetRow(&Load_p->Tree, Load_p->Row + Row, Load_p->Column, Width, Cells_p);
+        SetRowInCurrent(Load_p->Game_p, Row, Cells_p);
+    }
+}
 
-    case GOL_VARIANT_ARRAY:
-        Width  = Game_p->Data.ArrayGame.Width;
-        Height = Game_p->Data.ArrayGame.Height;
-        break;
 
-    case GOL_VARIANT_BITS:
-        Width  = Game_p->Data.BitsGame.Width;
-        Height = Game_p->Data.BitsGame.Height;
-        break;
+long long
+GOL_GetPopulation(const GOL_Game_t Game)
+{
+    STATS_t Stats;
 
-    default:
-        printf("Invalid implementation variant: %d\n", Game_p->Variant);
-        return;
-    }
+    GetStats(Game, &Stats);
+    return Stats.Population;
+}
 
-    FILE * pfile;
-    int i, j;
-    char* strwrite = malloc(Width + 1);
 
-    if ((pfile = fopen(Filename_p, "w")) == NULL) {
-        fprintf(stderr,"Error: unable to open \"%s\" for writing (error #%d).\n",
-                Filename_p, errno);
-        abort();
+/*
+ * The rectangle is cut to the world. The index is built on the pool's
+ * workers the first time the world is counted after it changes, so that
+ * any number of rectangles can be counted for about the cost of one pass
+ * over the world.
+ */
+long long
+GOL_CountLive(const GOL_Game_t Game,
+              const int        MinColumn,
+              const int        MinRow,
+              const int        MaxColumn,
+              const int        MaxRow)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    const int Width       = GOL_GetWorldWidth(Game_p);
+    const int Height      = GOL_GetWorldHeight(Game_p);
+    const int FirstColumn = (MinColumn > 0) ? MinColumn : 0;
+    const int FirstRow    = (MinRow > 0) ? MinRow : 0;
+    const int LastColumn  = (MaxColumn < Width - 1) ? MaxColumn : Width - 1;
+    const int LastRow     = (MaxRow < Height - 1) ? MaxRow : Height - 1;
+
+    if (FirstColumn > LastColumn || FirstRow > LastRow)
+    {
+        SetStatus(GOL_OK);
+        return 0;
     }
 
-    strwrite[Width] = '\0'; /* null terminator */
-    for (j = 0; j < Height; j++) {
-        for (i = 0; i < Width; i++)
-            strwrite[i] = GetCellState(Game, i, j) == ALIVE ? CHAR_ALIVE : CHAR_DEAD;
-        fprintf(pfile,"%s\n",strwrite);
+    if (REGION_Build(&Game_p->Region, Width, Height, GetRowOfGame, Game_p, &Game_p->Pool) != 0)
+    {
+        SetStatus(GOL_ERROR_OUT_OF_MEMORY);
+        return -1;
     }
 
-    free(strwrite);
-    fclose(pfile);
+    SetStatus(GOL_OK);
+    return REGION_Count(&Game_p->Region, FirstColumn, FirstRow, LastColumn, LastRow);
+}
+
+
+int
+GOL_GetBoundingBox(const GOL_Game_t Game,
+                   int* const       MinColumn_p,
+                   int* const       MinRow_p,
+                   int* const       MaxColumn_p,
+                   int* const       MaxRow_p)
+{
+    STATS_t Stats;
 
+    GetStats(Game, &Stats);
+    if (Stats.Population == 0)
+    {
+        return 0;
+    }
+
+    *MinColumn_p = Stats.MinColumn;
+    *MinRow_p    = Stats.MinRow;
+    *MaxColumn_p = Stats.MaxColumn;
+    *MaxRow_p    = Stats.MaxRow;
+    return 1;
 }
 
 
-static int
-GetCellState(const GOL_Game_t Game, const int Column, const int Row)
+// The ARRAY, BITS and TILES variants keep their stats up to date while evolving
+static void
+GetStats(const GOL_Game_t Game, STATS_t* Stats_p)
+{
+    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+
+    Game_p->Ops_p->GetStats(&Game_p->Data, Stats_p);
+}
+
+
+void
+GOL_GetWorldOrigin(const GOL_Game_t Game, int* const Column_p, int* const Row_p)
 {
-    int State = CELL_DEAD;
     GameOfLife_t* Game_p = (GameOfLife_t*)Game;
 
-    switch (Game_p->Variant)
+    *Column_p = Game_p->OriginColumn;
+    *Row_p    = Game_p->OriginRow;
+}
+
+
+/*
+ * Grows the world (doubling it along an axis) when live cells come within
+ * AutoGrowMargin of the border, and shrinks it when the live cells take
+ * up less than a quarter of it. Columns only move in whole 32 cell steps,
+ * so that BITS rows can be moved uint by uint.
+ */
+static void
+AutoResize(GameOfLife_t* Game_p)
+{
+    const int Width  = GOL_GetWorldWidth(Game_p);
+    const int Height = GOL_GetWorldHeight(Game_p);
+    int NewWidth;
+    int NewHeight;
+    int ColumnShift;
+    int RowShift;
+    STATS_t Stats;
+
+    if (Game_p->Ops_p->Resize == NULL)
     {
-    case GOL_VARIANT_REFERENCE:
-        State = get_cell_state(&Game_p->Data.RefGame, Column, Row);
-        break;
+        return;
+    }
 
-    case GOL_VARIANT_ARRAY:
-        State = ARRAY_GetCellState(&Game_p->Data.ArrayGame, Column, Row);
-        break;
+    GetStats(Game_p, &Stats);
+    if (Stats.Population == 0)
+    {
+        return;
+    }
 
-    case GOL_VARIANT_BITS:
-        State = BITS_GetCellState(&Game_p->Data.BitsGame, Column, Row);
-        break;
+    PlanResize(Stats.MinColumn, Stats.MaxColumn, Width, Game_p->Options.AutoGrowMargin, 32,
+               &NewWidth, &ColumnShift);
+    PlanResize(Stats.MinRow, Stats.MaxRow, Height, Game_p->Options.AutoGrowMargin, 1,
+               &NewHeight, &RowShift);
 
-    default:
-        break;
+    if (NewWidth == Width && NewHeight == Height && ColumnShift == 0 && RowShift == 0)
+    {
+        return;
+    }
+
+    // Without the memory to grow, the world evolves at the size it has
+    if (Game_p->Ops_p->Resize(&Game_p->Data, NewWidth, NewHeight, ColumnShift, RowShift) != 0)
+    {
+        return;
     }
-    return State;
+    Game_p->OriginColumn -= ColumnShift;
+    Game_p->OriginRow    -= RowShift;
 }
 
 
-// Sets a cell state in the current world. Used for loading files only.
+// Plans the resize along one axis, where live cells span [Min, Max]
 static void
-SetCellStateInCurrent(const GOL_Game_t Game, const int Column, const int Row, const int State)
+PlanResize(const int  Min,
+           const int  Max,
+           const int  Size,
+           const int  Margin,
+           const int  Alignment,
+           int* const NewSize_p,
+           int* const Shift_p)
 {
-    GameOfLife_t* Game_p = (GameOfLife_t*)Game;
+    const int NearLow  = (Min < Margin);
+    const int NearHigh = (Max >= Size - Margin);
 
-    switch (Game_p->Variant)
-    {
-    case GOL_VARIANT_REFERENCE:
-        set_cell_state_in_current(&Game_p->Data.RefGame, Column, Row, State);
-        break;
+    *NewSize_p = Size;
+    *Shift_p   = 0;
 
-    case GOL_VARIANT_ARRAY:
-        ARRAY_SetCellStateInCurrent(&Game_p->Data.ArrayGame, Column, Row, State);
-        break;
+    if (NearLow || NearHigh)
+    {
+        // Double the size, split between the sides that need room
+        int Extra     = (NearLow && NearHigh) ? Size / 2 : Size;
+        int LowExtra  = 0;
+        int HighExtra = 0;
 
-    case GOL_VARIANT_BITS:
-        BITS_SetCellStateInCurrent(&Game_p->Data.BitsGame, Column, Row, State);
-        break;
+        if (Extra < Margin)
+        {
+            Extra = Margin;
+        }
+        if (NearLow)
+        {
+            LowExtra = ((Extra + Alignment - 1) / Alignment) * Alignment;
+        }
+        if (NearHigh)
+        {
+            HighExtra = Extra;
+        }
+        *NewSize_p = Size + LowExtra + HighExtra;
+        *Shift_p   = LowExtra;
+    }
+    else
+    {
+        // Keep twice the margin on both sides, so the next grow is far off
+        int Start = Min - 2 * Margin;
+        int End   = Max + 2 * Margin + 1;
 
-    default:
-        break;
+        Start = (Start > 0) ? (Start / Alignment) * Alignment : 0;
+        End   = (End < Size) ? End : Size;
+        if ((End - Start) * 4 <= Size)
+        {
+            *NewSize_p = End - Start;
+            *Shift_p   = -Start;
+        }
     }
 }
 
@@ -385,25 +2317,8 @@ int
 GOL_GetWorldWidth(const GOL_Game_t Game)
 {
     GameOfLife_t* Game_p = (GameOfLife_t*)Game;
-    int Width = 0;
-    switch (Game_p->Variant)
-    {
-    case GOL_VARIANT_REFERENCE:
-        Width = get_world_width();
-        break;
 
-    case GOL_VARIANT_ARRAY:
-        Width = ARRAY_GetWorldWidth(&Game_p->Data.ArrayGame);
-        break;
-
-    case GOL_VARIANT_BITS:
-        Width = BITS_GetWorldWidth(&Game_p->Data.BitsGame);
-        break;
-
-    default:
-        break;
-    }
-    return Width;
+    return Game_p->Ops_p->GetWidth(&Game_p->Data);
 }
 
 
@@ -412,23 +2327,6 @@ int
 GOL_GetWorldHeight(const GOL_Game_t Game)
 {
     GameOfLife_t* Game_p = (GameOfLife_t*)Game;
-    int Height = 0;
-    switch (Game_p->Variant)
-    {
-    case GOL_VARIANT_REFERENCE:
-        Height = get_world_height();
-        break;
-
-    case GOL_VARIANT_ARRAY:
-        Height = ARRAY_GetWorldHeight(&Game_p->Data.ArrayGame);
-        break;
-
-    case GOL_VARIANT_BITS:
-        Height = BITS_GetWorldHeight(&Game_p->Data.BitsGame);
-        break;
 
-    default:
-        break;
-    }
-    return Height;
+    return Game_p->Ops_p->GetHeight(&Game_p->Data);
 }
@@ -1,23 +1,50 @@
 /*
  * Game of Life API
+ *
+ * Built into libgol (static and shared, see the Makefile). The library
+ * never prints, except from GOL_OutputWorld(), and never exits: calls
+ * that can fail return a GOL_Status_t, or NULL with the reason kept for
+ * GOL_GetLastError(). Worlds share no state, so different worlds may be
+ * used from different threads at the same time. A single world must only
+ * be used from one thread at a time, apart from its snapshots.
  */
 
+#include <stdint.h>
+
 
 #define DEFAULT_WORLD_WIDTH       39
 #define DEFAULT_WORLD_HEIGHT      20
 
 #define DEFAULT_NUM_GENERATIONS   50
 
+#define DEFAULT_NUM_THREADS       1
+
 
 #define CELL_ALIVE  1
 #define CELL_DEAD   0
 
 
+// Negative, so that "0 on success" holds for every call returning one
+typedef enum
+{
+    GOL_OK                     =  0,
+    GOL_ERROR_INVALID_ARGUMENT = -1,
+    GOL_ERROR_OUT_OF_MEMORY    = -2,
+    GOL_ERROR_IO               = -3,   // errno tells why
+    GOL_ERROR_FORMAT           = -4,   // A file or text could not be parsed
+    GOL_ERROR_NOT_SUPPORTED    = -5,   // Not for this variant
+    GOL_ERROR_NOT_FOUND        = -6,   // The generation is not kept
+    GOL_ERROR_MISMATCH         = -7,   // The worlds differ
+} GOL_Status_t;
+
+
 typedef enum
 {
     GOL_VARIANT_REFERENCE,
     GOL_VARIANT_ARRAY,
     GOL_VARIANT_BITS,
+    GOL_VARIANT_TILES,
+    GOL_VARIANT_COUNTS,
 
     GOL_VARIANT_LAST_ENTRY
 } GOL_Variant_t;
@@ -26,6 +53,149 @@ typedef enum
 typedef void* GOL_Game_t;
 
 
+typedef void* GOL_Pattern_t;
+
+
+typedef void* GOL_Snapshot_t;
+
+
+typedef void* GOL_Recorder_t;
+
+
+typedef void* GOL_Census_t;
+
+
+// In the same order as PATTERN_Transform_t
+typedef enum
+{
+    GOL_TRANSFORM_IDENTITY,
+    GOL_TRANSFORM_ROTATE_90,       // Clockwise
+    GOL_TRANSFORM_ROTATE_180,
+    GOL_TRANSFORM_ROTATE_270,
+    GOL_TRANSFORM_FLIP_COLUMNS,    // Mirrored left to right
+    GOL_TRANSFORM_FLIP_ROWS,       // Mirrored top to bottom
+    GOL_TRANSFORM_TRANSPOSE,       // Mirrored in the main diagonal
+    GOL_TRANSFORM_ANTI_TRANSPOSE,  // Mirrored in the other diagonal
+
+    GOL_TRANSFORM_LAST_ENTRY
+} GOL_Transform_t;
+
+
+// In the same order as PATTERN_Mode_t
+typedef enum
+{
+    GOL_STAMP_OR,      // Live pattern cells are set
+    GOL_STAMP_XOR,     // Live pattern cells are toggled
+    GOL_STAMP_COPY,    // The whole pattern rectangle is overwritten
+
+    GOL_STAMP_LAST_ENTRY
+} GOL_StampMode_t;
+
+
+// In the same order as FRAMES_Format_t. Alive cells are black.
+typedef enum
+{
+    GOL_FRAMES_PBM,    // One file per frame, PATH followed by the generation
+    GOL_FRAMES_PGM,    // in six digits and .pbm or .pgm
+    GOL_FRAMES_GIF,    // One animated GIF in PATH
+    GOL_FRAMES_RAW,    // 8-bit grey frames back to back in PATH, as for
+                       // ffmpeg -f rawvideo -pix_fmt gray
+
+    GOL_FRAMES_LAST_ENTRY
+} GOL_FrameFormat_t;
+
+
+typedef enum
+{
+    GOL_BUFFER_BYTES,   // One byte per cell, CELL_ALIVE or CELL_DEAD
+    GOL_BUFFER_BITS,    // 32-bit words in native byte order, bit b of word w
+                        // is storage column 32 * w + b
+
+    GOL_BUFFER_LAST_ENTRY
+} GOL_BufferFormat_t;
+
+
+/*
+ * The memory of a world as it is. Each row has HaloColumns dead cells on
+ * either side and there are HaloRows dead rows above and below, so cell
+ * (Column, Row) is storage column Column + HaloColumns of storage row
+ * Row + HaloRows, which starts at Data_p + (Row + HaloRows) * RowStride.
+ */
+typedef struct
+{
+    GOL_BufferFormat_t Format;
+    void*              Data_p;      // The first halo row
+    size_t             Size;        // Bytes, halo rows included
+    int                Width;
+    int                Height;
+    size_t             RowStride;   // Bytes from one row to the next
+    int                WordSize;    // Bytes per word, 1 for GOL_BUFFER_BYTES
+    int                HaloRows;
+    int                HaloColumns;
+} GOL_BufferView_t;
+
+
+typedef struct
+{
+    int NumberOfThreads;  // Worker threads per world (ARRAY, BITS and TILES)
+    int PinThreads;       // Pin each worker to its own core, spread over nodes
+    int InPlace;          // Evolve ARRAY and BITS worlds in a single buffer
+    int AutoGrowMargin;   // If > 0, ARRAY and BITS worlds grow and shrink to
+                          // keep live cells this many cells from the border
+    int HistoryLength;    // If > 0, at least this many past generations are
+                          // kept for GOL_SeekGeneration()
+    int KeyframeInterval; // Generations between full copies in the history
+                          // (0 for 64), the rest are kept as changes only
+    int CountEvents;      // Count hardware events while the world evolves,
+                          // see GOL_GetEventCounts()
+} GOL_Options_t;
+
+
+// Hardware events counted while a world evolved, -1 for those that could
+// not be counted
+typedef struct
+{
+    long long CellUpdates;     // Cells evolved, Width * Height a generation
+    long long Cycles;
+    long long Instructions;
+    long long L1DMisses;       // Level 1 data cache read misses
+    long long LLCMisses;       // Last level cache misses
+    long long BranchMisses;
+    long long DTLBMisses;      // Data TLB read misses
+} GOL_EventCounts_t;
+
+
+// A variant and the options it evolves fastest with, see GOL_TuneWorld()
+typedef struct
+{
+    GOL_Variant_t Variant;
+    int           NumberOfThreads;
+    int           InPlace;
+    int           Cached;                // Taken from the cache, not measured
+    double        CellUpdatesPerSecond;  // On the sample, when measured
+} GOL_Tuning_t;
+
+
+// The status of the last call on the calling thread that returned a
+// GOL_Status_t or a handle
+GOL_Status_t
+GOL_GetLastError(void);
+
+
+const char*
+GOL_GetStatusString(const GOL_Status_t Status);
+
+
+// Options are copied into each world when it is initialized, so changing
+// them affects worlds initialized after the call only.
+void
+GOL_SetOptions(const GOL_Options_t* const Options_p);
+
+
+void
+GOL_GetOptions(GOL_Options_t* const Options_p);
+
+
 GOL_Game_t
 GOL_InitializeWorld(const GOL_Variant_t Variant,
                     const int           Width,
@@ -33,6 +203,15 @@ GOL_InitializeWorld(const GOL_Variant_t Variant,
                     const int           UseDefaultPattern);
 
 
+/*
+ * Each line of the text file is a row, '*' is alive and anything else
+ * dead. Lines may be of any length, cells past Width are ignored.
+ *
+ * A file starting with "[M2]" is read as macrocell, the quadtree format of
+ * Golly, and flattened straight into the world. The top left of the root
+ * is put at the top left of the world, unless that would leave live cells
+ * out, when the top left of the live cells is.
+ */
 GOL_Game_t
 GOL_InitializeWorldFromFile(const GOL_Variant_t Variant,
                             const int           Width,
@@ -40,27 +219,373 @@ GOL_InitializeWorldFromFile(const GOL_Variant_t Variant,
                             const char* const   Filename_p);
 
 
+// Fills the world with random cells, each alive with probability Density
+// (rounded to 16 significant bits, and to a multiple of 2^-32). Fails with
+// GOL_ERROR_INVALID_ARGUMENT for a density that would round to 0 or 1
+// without being it. The world only depends on Width, Height, Density and
+// Seed, not on the variant or the number of threads.
+GOL_Game_t
+GOL_InitializeWorldRandom(const GOL_Variant_t      Variant,
+                          const int                Width,
+                          const int                Height,
+                          const double             Density,
+                          const unsigned long long Seed);
+
+
+// Loads a packed world file as written by GOL_SaveWorldToPackedFile(),
+// the size of the world is taken from the file.
+GOL_Game_t
+GOL_InitializeWorldFromPackedFile(const GOL_Variant_t Variant,
+                                  const char* const   Filename_p);
+
+
+/*
+ * Makes a world that evolves in the caller's buffer, as described by
+ * View_p, without copying it. Only ARRAY (GOL_BUFFER_BYTES) and BITS
+ * (GOL_BUFFER_BITS) worlds can, and the layout must be the one
+ * GOL_GetBufferView() gives for a world of the same size. Data_p must be
+ * aligned to 64 bytes, as the world's own buffers are, and the halo and
+ * the padding at the end of each row must be dead.
+ *
+ * Worlds that are not evolved in place take turns between the caller's
+ * buffer and one of their own, and may give it up when they grow. Once
+ * neither the world nor any snapshot uses the buffer, Release (if not
+ * NULL) is called with Context_p. Returns NULL if the view does not fit.
+ */
+GOL_Game_t
+GOL_InitializeWorldFromBuffer(const GOL_Variant_t           Variant,
+                              const GOL_BufferView_t* const View_p,
+                              void                          (*Release)(void* Context_p),
+                              void*                         Context_p);
+
+
 void
 GOL_DestroyWorld(GOL_Game_t* Game_p);
 
 
+// Makes a world of Variant, with the options now set, holding the current
+// generation of Game. REFERENCE worlds keep their own size.
+GOL_Game_t
+GOL_CloneWorld(const GOL_Game_t Game, const GOL_Variant_t Variant);
+
+
+/*
+ * Finds the variant, number of threads and in place setting that evolve
+ * Game fastest. Each candidate evolves a copy of (a sample of) the world
+ * for its share of about BudgetMilliseconds. REFERENCE is only a
+ * candidate for worlds of its own size, and the number of threads goes up
+ * in powers of two to the number of CPUs.
+ *
+ * If CacheFilename_p is not NULL, the choice is looked up there first, for
+ * this host and worlds of about the size and density of Game, and stored
+ * there once measured. A cache that can not be read or written is not an
+ * error, the choice is just measured again next time.
+ */
+GOL_Status_t
+GOL_TuneWorld(const GOL_Game_t    Game,
+              const int           BudgetMilliseconds,
+              const char* const   CacheFilename_p,
+              GOL_Tuning_t* const Tuning_p);
+
+
+/*
+ * Evolves NumberOfSoups random 16 x 16 soups, at density 0.5, until each
+ * settles down, and counts the objects left over by their apgcodes (see
+ * gol_census.h). Soup i is drawn from Seed and i, so a search gives the
+ * same census on any number of threads, from 0 for one per CPU. Each
+ * thread evolves its soups one after the other in a 128 x 128 world of
+ * Variant. Spaceships are counted and taken out as they near the edges,
+ * and the world doubles around the soup when anything else does. Soups
+ * that outgrow 1024 x 1024 are counted as zz_EDGE, and soups that do not
+ * repeat with a period of 60 or less within 20000 generations as
+ * zz_UNSTABLE.
+ */
+GOL_Census_t
+GOL_SearchSoups(const GOL_Variant_t      Variant,
+                const long long          NumberOfSoups,
+                const unsigned long long Seed,
+                const int                NumberOfThreads);
+
+
+int
+GOL_GetCensusSize(const GOL_Census_t Census);
+
+
+// Entries are ordered most common first. The code is valid until the
+// census is destroyed.
 void
-GOL_EvolveWorld(const GOL_Game_t Game);
+GOL_GetCensusEntry(const GOL_Census_t Census,
+                   const int          Index,
+                   const char** const Code_pp,
+                   long long* const   Count_p);
 
 
-// Prints and exit():s if worlds differ
 void
-GOL_CompareWorlds(const GOL_Game_t Game1, const GOL_Game_t Game2);
+GOL_DestroyCensus(GOL_Census_t* Census_p);
+
+
+/*
+ * Returns GOL_ERROR_OUT_OF_MEMORY if the world needed a new buffer to
+ * evolve into (a snapshot still holds the one it would overwrite) and
+ * could not get one, in which case it is left as it was. The error is
+ * also returned if the generation could not be kept in the history or
+ * published as a snapshot. The world is evolved all the same then, and
+ * from then on keeps no history, or has no snapshot until the next one.
+ */
+GOL_Status_t
+GOL_EvolveWorld(const GOL_Game_t Game);
+
+
+/*
+ * Evolves the world NumberOfGenerations times in NumberOfRanks child
+ * processes, each with a band of rows, which pass their border rows to
+ * each other through shared memory. Worlds of any variant can be evolved
+ * this way, the bands are always BITS worlds. The world does not grow, and
+ * only the last generation is published and kept in the history.
+ */
+GOL_Status_t
+GOL_EvolveWorldInRanks(const GOL_Game_t Game,
+                       const int        NumberOfRanks,
+                       const int        NumberOfGenerations);
+
+
+/*
+ * Events counted by the world's kernel, in its workers, its ranks and the
+ * thread evolving it, but not in other threads of the caller, over all
+ * generations evolved so far. Only the evolve itself is counted, not the
+ * snapshots, history or growing around it. Returns GOL_ERROR_NOT_SUPPORTED
+ * if the world was made without CountEvents, or no event can be counted
+ * (perf_event_open() is not allowed, or the CPU has no counters).
+ */
+GOL_Status_t
+GOL_GetEventCounts(const GOL_Game_t Game, GOL_EventCounts_t* const Counts_p);
+
+
+// Returns GOL_ERROR_MISMATCH if the worlds differ, and the first cell
+// that does in (*Column_p, *Row_p) unless they are NULL. Cells are
+// compared where they are relative to the world origins (see
+// GOL_GetWorldOrigin()), so a world that grew still matches one that did
+// not, and so are the cells returned. Cells outside a world are dead.
+GOL_Status_t
+GOL_CompareWorlds(const GOL_Game_t Game1,
+                  const GOL_Game_t Game2,
+                  int* const       Column_p,
+                  int* const       Row_p);
+
+
+/*
+ * Evolves both worlds NumberOfGenerations times, each on a thread of its
+ * own, and compares every generation as GOL_CompareWorlds() does. The
+ * comparison runs on the calling thread while the worlds make the next
+ * generations, neither more than QueueLength generations ahead of it.
+ * Stops at the first generation that differs and returns
+ * GOL_ERROR_MISMATCH, with the number of generations evolved up to it and
+ * its first cell that differs. The worlds may then have gone up to
+ * QueueLength + 1 generations further.
+ */
+GOL_Status_t
+GOL_EvolveAndCompare(const GOL_Game_t Game1,
+                     const GOL_Game_t Game2,
+                     const int        NumberOfGenerations,
+                     const int        QueueLength,
+                     long long* const Generation_p,
+                     int* const       Column_p,
+                     int* const       Row_p);
 
 
 void
 GOL_OutputWorld(const GOL_Game_t Game);
 
 
-void
+// Writes text as read by GOL_InitializeWorldFromFile(), or macrocell if
+// Filename_p ends in ".mc", with the world at the top left of the root.
+GOL_Status_t
 GOL_SaveWorldToFile(const GOL_Game_t Game, const char* const Filename_p);
 
 
+GOL_Status_t
+GOL_SaveWorldToPackedFile(const GOL_Game_t Game, const char* const Filename_p);
+
+
+/*
+ * Evolves the packed world in Filename_p out-of-core, generation by
+ * generation, using ScratchFilename_p for every other generation. The final
+ * generation always ends up in Filename_p.
+ */
+GOL_Status_t
+GOL_StreamEvolve(const char* const Filename_p,
+                 const char* const ScratchFilename_p,
+                 const int         NumberOfGenerations);
+
+
+// Loads an RLE or plain text pattern. Returns NULL if the file can not be
+// read or parsed.
+GOL_Pattern_t
+GOL_LoadPattern(const char* const Filename_p);
+
+
+GOL_Pattern_t
+GOL_ParsePattern(const char* const Text_p);
+
+
+void
+GOL_DestroyPattern(GOL_Pattern_t* Pattern_p);
+
+
+/*
+ * Stamps Pattern, after Transform, into the world with its top left cell at
+ * (Column, Row). Parts outside the world are clipped. The same pattern may
+ * be stamped any number of times, each transform is only made once.
+ */
+GOL_Status_t
+GOL_StampPattern(const GOL_Game_t      Game,
+                 const GOL_Pattern_t   Pattern,
+                 const int             Column,
+                 const int             Row,
+                 const GOL_Transform_t Transform,
+                 const GOL_StampMode_t Mode);
+
+
+/*
+ * Returns the generation last evolved by GOL_EvolveWorld(), NULL if there
+ * is none. May be called from any thread while the world keeps evolving,
+ * the snapshot never changes until it is released. ARRAY, BITS and TILES
+ * worlds hand out the buffer they just evolved into, without copying, and
+ * only take a new buffer if a snapshot still holds the old one when they
+ * come to overwrite it. Worlds evolved in place have no snapshot while
+ * they evolve, and REFERENCE worlds have none at all.
+ */
+GOL_Snapshot_t
+GOL_AcquireSnapshot(const GOL_Game_t Game);
+
+
+void
+GOL_ReleaseSnapshot(GOL_Snapshot_t* Snapshot_p);
+
+
+// The number of evolves made before the snapshot was taken
+long long
+GOL_GetSnapshotGeneration(const GOL_Snapshot_t Snapshot);
+
+
+int
+GOL_GetSnapshotWidth(const GOL_Snapshot_t Snapshot);
+
+
+int
+GOL_GetSnapshotHeight(const GOL_Snapshot_t Snapshot);
+
+
+int
+GOL_GetSnapshotCellState(const GOL_Snapshot_t Snapshot, const int Column, const int Row);
+
+
+// Packs a row of the snapshot, bit c % 64 of word c / 64 is column c
+void
+GOL_GetSnapshotRow(const GOL_Snapshot_t Snapshot, const int Row, uint64_t* const Cells_p);
+
+
+/*
+ * Fills View_p with the current world of an ARRAY or BITS world, without
+ * copying it. The memory must not be written and is only valid until the
+ * world is next evolved or changed. Returns GOL_ERROR_NOT_SUPPORTED for
+ * other variants.
+ */
+GOL_Status_t
+GOL_GetBufferView(const GOL_Game_t Game, GOL_BufferView_t* const View_p);
+
+
+// As GOL_GetBufferView(), but valid for as long as the snapshot is held
+GOL_Status_t
+GOL_GetSnapshotBufferView(const GOL_Snapshot_t Snapshot, GOL_BufferView_t* const View_p);
+
+
+/*
+ * Starts recording frames to Path_p. Frames are encoded on a thread of the
+ * recorder's own, and up to QueueLength of them wait for it. GIF and RAW
+ * frames all have the size of the first one. Returns NULL if the output
+ * can not be opened.
+ */
+GOL_Recorder_t
+GOL_StartRecording(const char* const       Path_p,
+                   const GOL_FrameFormat_t Format,
+                   const int               QueueLength);
+
+
+/*
+ * Queues the current world as a frame. ARRAY, BITS, TILES and COUNTS
+ * worlds are not copied, the frame shares the buffer as a snapshot does.
+ * Waits while the queue is full. Returns GOL_ERROR_IO once a frame could
+ * not be written.
+ */
+GOL_Status_t
+GOL_RecordFrame(const GOL_Recorder_t Recorder, const GOL_Game_t Game);
+
+
+// Writes the frames still queued and closes the output
+GOL_Status_t
+GOL_StopRecording(GOL_Recorder_t* Recorder_p);
+
+
+// The number of evolves made, as changed by GOL_SeekGeneration()
+long long
+GOL_GetGeneration(const GOL_Game_t Game);
+
+
+// Returns 0 and the first and last generations kept, -1 if there are none.
+// Generations are kept when the world is initialized with HistoryLength set.
+int
+GOL_GetHistoryRange(const GOL_Game_t Game, long long* const First_p, long long* const Last_p);
+
+
+/*
+ * Puts the world back to Generation, as it was right after it was evolved,
+ * size and origin included. Later generations are forgotten and evolving
+ * goes on from there. Returns GOL_ERROR_NOT_FOUND if Generation is not
+ * kept, or GOL_ERROR_OUT_OF_MEMORY if the world can not be resized to it.
+ */
+GOL_Status_t
+GOL_SeekGeneration(const GOL_Game_t Game, const long long Generation);
+
+
+long long
+GOL_GetPopulation(const GOL_Game_t Game);
+
+
+/*
+ * The live cells in columns MinColumn .. MaxColumn and rows MinRow ..
+ * MaxRow (inclusive, like GOL_GetBoundingBox()), 0 for rectangles outside
+ * the world. Counting a rectangle costs O(1) for the 64 x 64 tiles it
+ * covers whole, plus a popcount per word along its edges, once an index
+ * of the world has been built. The index is built by the first count after
+ * the world changes. Worlds made by GOL_InitializeWorldFromBuffer() are
+ * not indexed again when their buffer is changed from outside. Returns -1
+ * if out of memory.
+ */
+long long
+GOL_CountLive(const GOL_Game_t Game,
+              const int        MinColumn,
+              const int        MinRow,
+              const int        MaxColumn,
+              const int        MaxRow);
+
+
+// Returns 0 if there are no live cells, otherwise 1 and the bounding box
+// of the live cells (inclusive).
+int
+GOL_GetBoundingBox(const GOL_Game_t Game,
+                   int* const       MinColumn_p,
+                   int* const       MinRow_p,
+                   int* const       MaxColumn_p,
+                   int* const       MaxRow_p);
+
+
+// The position of cell (0, 0) relative to where it was when the world
+// was initialized. Only changes for worlds with AutoGrowMargin set.
+void
+GOL_GetWorldOrigin(const GOL_Game_t Game, int* const Column_p, int* const Row_p);
+
+
 int
 GOL_GetWorldWidth(const GOL_Game_t Game);
 
@@ -7,39 +7,140 @@
 #include <stdlib.h>
 
 #include "gol_array.h"
+#include "gol_snapshot.h"
 
 
-//#define POS_OFFSET(Column, Row, Width)   (((Row) * ((Width) + 2)) + (1 + (Column)))
+static void
+FirstTouchBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
 
-#define POS_OFFSET(Column, Row, Width)   (((1 + (Row)) * ((Width) + 2)) + (1 + (Column)))
-//int Pos = (1 + Row) * (Game_p->Width + 2) + (1 + Column);
+static int
+ListActiveTiles(ArrayGame_t* Game_p);
+
+static void
+EvolveTile(void* Context_p, const int Task, const int ThreadIndex);
+
+static void
+SaveBandBordersInPlace(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
 
+static void
+EvolveBandInPlace(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
 
 static int
-CalculateNewCellState(ArrayGame_t* Game_p,
-                      const int    Column,
-                      const int    Row);
+EvolveRow(const byte_t* const PrevRow_p,
+          const byte_t* const CurrentRow_p,
+          const byte_t* const NextRow_p,
+          byte_t* const       EvolvedRow_p,
+          const int           Width,
+          int* const          MinColumn_p,
+          int* const          MaxColumn_p);
 
-void
-ARRAY_InitializeWorld(ArrayGame_t* Game_p,
-                      const int    Width,
-                      const int    Height)
+static void
+GetBandActiveRows(ArrayGame_t* Game_p,
+                  const int    ThreadIndex,
+                  const int    NumberOfThreads,
+                  int*         Start_p,
+                  int*         End_p,
+                  int*         ActiveStart_p,
+                  int*         ActiveEnd_p);
+
+
+int
+ARRAY_InitializeWorld(ArrayGame_t*    Game_p,
+                      const int       Width,
+                      const int       Height,
+                      const int       InPlace,
+                      THREADS_Pool_t* Pool_p)
 {
-    int NumberOfBytes = (Width + 2) * (Height + 2);
-    Game_p->CurrentWorld_p  = malloc(NumberOfBytes);
-    Game_p->EvolvingWorld_p = malloc(NumberOfBytes);
+    size_t NumberOfBytes = (size_t)(Width + 2) * (Height + 2);
+    Game_p->CurrentWorld_p  = SNAPSHOT_AllocateBuffer(NumberOfBytes);
+    Game_p->EvolvingWorld_p = InPlace ? NULL : SNAPSHOT_AllocateBuffer(NumberOfBytes);
+    Game_p->RowBuffers_p    = InPlace ?
+        malloc((size_t)4 * (Width + 2) * THREADS_GetNumberOfThreads(Pool_p)) : NULL;
+    Game_p->BandStats_p     = malloc(THREADS_GetNumberOfThreads(Pool_p) * sizeof(STATS_t));
     Game_p->Width  = Width;
     Game_p->Height = Height;
+    Game_p->Pool_p = Pool_p;
+    STATS_Reset(&Game_p->Stats);
+    Game_p->StatsValid = 1;
+
+    Game_p->TilesX = (Width + ARRAY_TILE_COLUMNS - 1) / ARRAY_TILE_COLUMNS;
+    Game_p->TilesY = (Height + ARRAY_TILE_ROWS - 1) / ARRAY_TILE_ROWS;
+    Game_p->TileChanged_p         = calloc(Game_p->TilesX * Game_p->TilesY, 1);
+    Game_p->EvolvingTileChanged_p = calloc(Game_p->TilesX * Game_p->TilesY, 1);
+    Game_p->TileStats_p           = malloc(Game_p->TilesX * Game_p->TilesY * sizeof(STATS_t));
+    Game_p->ActiveTiles_p         = malloc(Game_p->TilesX * Game_p->TilesY * sizeof(int));
+    Game_p->EvolveAllTiles        = 1;
 
-    memset(Game_p->CurrentWorld_p, 0, NumberOfBytes);
+    if (Game_p->CurrentWorld_p == NULL || (Game_p->EvolvingWorld_p == NULL && !InPlace) ||
+        (Game_p->RowBuffers_p == NULL && InPlace) || Game_p->BandStats_p == NULL ||
+        Game_p->TileChanged_p == NULL || Game_p->EvolvingTileChanged_p == NULL ||
+        Game_p->TileStats_p == NULL || Game_p->ActiveTiles_p == NULL)
+    {
+        ARRAY_DestroyWorld(Game_p);
+        return -1;
+    }
+
+    // Both worlds are cleared, halo included, by the threads that evolve them
+    THREADS_Run(Pool_p, FirstTouchBand, Game_p);
+    return 0;
 }
 
 
 void
 ARRAY_DestroyWorld(ArrayGame_t* Game_p)
 {
-    free(Game_p->CurrentWorld_p);
-    free(Game_p->EvolvingWorld_p);
+    SNAPSHOT_ReleaseBuffer(Game_p->CurrentWorld_p);
+    SNAPSHOT_ReleaseBuffer(Game_p->EvolvingWorld_p);
+    free(Game_p->RowBuffers_p);
+    free(Game_p->BandStats_p);
+    free(Game_p->TileChanged_p);
+    free(Game_p->EvolvingTileChanged_p);
+    free(Game_p->TileStats_p);
+    free(Game_p->ActiveTiles_p);
+}
+
+
+int
+ARRAY_ResizeWorld(ArrayGame_t* Game_p,
+                  const int    NewWidth,
+                  const int    NewHeight,
+                  const int    ColumnShift,
+                  const int    RowShift)
+{
+    ArrayGame_t OldGame = *Game_p;
+    const size_t OldBytesPerRow = OldGame.Width + 2;
+    const size_t NewBytesPerRow = NewWidth + 2;
+    const int FirstColumn = (ColumnShift < 0) ? -ColumnShift : 0;
+    const int EndColumn   = (OldGame.Width + ColumnShift > NewWidth) ? NewWidth - ColumnShift : OldGame.Width;
+    STATS_t Stats;
+
+    ARRAY_GetStats(&OldGame, &Stats);
+    if (ARRAY_InitializeWorld(Game_p, NewWidth, NewHeight, OldGame.EvolvingWorld_p == NULL, OldGame.Pool_p) != 0)
+    {
+        *Game_p = OldGame;
+        return -1;
+    }
+
+    for (int Row = 0; Row < OldGame.Height && EndColumn > FirstColumn; Row++)
+    {
+        int NewRow = Row + RowShift;
+        if (NewRow >= 0 && NewRow < NewHeight)
+        {
+            memcpy(Game_p->CurrentWorld_p + (NewRow + 1) * NewBytesPerRow + 1 + FirstColumn + ColumnShift,
+                   OldGame.CurrentWorld_p + (Row + 1) * OldBytesPerRow + 1 + FirstColumn,
+                   EndColumn - FirstColumn);
+        }
+    }
+
+    // The stats still hold unless live cells were dropped
+    STATS_Shift(&Stats, ColumnShift, RowShift);
+    Game_p->Stats = Stats;
+    Game_p->StatsValid = (Stats.Population == 0) ||
+                         (Stats.MinColumn >= 0 && Stats.MaxColumn < NewWidth &&
+                          Stats.MinRow >= 0 && Stats.MaxRow < NewHeight);
+
+    ARRAY_DestroyWorld(&OldGame);
+    return 0;
 }
 
 
@@ -62,6 +163,8 @@ ARRAY_SetCellStateInCurrent(ArrayGame_t* Game_p,
 {
     int Pos = (1 + Row) * (Game_p->Width + 2) + (1 + Column);
     *(Game_p->CurrentWorld_p + Pos) = State;
+    Game_p->StatsValid     = 0;
+    Game_p->EvolveAllTiles = 1;
 }
 
 
@@ -75,21 +178,161 @@ ARRAY_GetCellState(ArrayGame_t* Game_p,
 }
 
 
-void
+int
 ARRAY_EvolveWorld(ArrayGame_t* Game_p)
 {
-    for (int Column = 0; Column < Game_p->Width; Column++)
+    if (Game_p->EvolvingWorld_p == NULL)
     {
+        const int NumberOfThreads = THREADS_GetNumberOfThreads(Game_p->Pool_p);
+
+        // A snapshot still reading this generation keeps it to itself
+        if (SNAPSHOT_UnshareBuffer((void**)&Game_p->CurrentWorld_p, 1) < 0)
+        {
+            return -1;
+        }
+
+        // Only rows next to a live row can be alive in the next generation
+        if (!Game_p->StatsValid)
+        {
+            Game_p->ActiveStart = 0;
+            Game_p->ActiveEnd   = Game_p->Height;
+        }
+        else if (Game_p->Stats.Population == 0)
+        {
+            Game_p->ActiveStart = 0;
+            Game_p->ActiveEnd   = 0;
+        }
+        else
+        {
+            Game_p->ActiveStart = (Game_p->Stats.MinRow > 0) ? Game_p->Stats.MinRow - 1 : 0;
+            Game_p->ActiveEnd   = (Game_p->Stats.MaxRow + 2 < Game_p->Height) ?
+                                  Game_p->Stats.MaxRow + 2 : Game_p->Height;
+        }
+
+        // The rows just outside each band must be saved before any band
+        // starts to overwrite its rows
+        THREADS_Run(Game_p->Pool_p, SaveBandBordersInPlace, Game_p);
+        THREADS_Run(Game_p->Pool_p, EvolveBandInPlace, Game_p);
+
+        STATS_Reset(&Game_p->Stats);
+        for (int i = 0; i < NumberOfThreads; i++)
+        {
+            STATS_Merge(&Game_p->Stats, &Game_p->BandStats_p[i]);
+        }
+    }
+    else
+    {
+        // Skipped tiles rely on the evolving world holding the generation
+        // before, which a new buffer (if a snapshot holds the old one) does not
+        switch (SNAPSHOT_UnshareBuffer((void**)&Game_p->EvolvingWorld_p, 0))
+        {
+        case 0:
+            break;
+
+        case 1:
+            Game_p->EvolveAllTiles = 1;
+            break;
+
+        default:
+            return -1;
+        }
+
+        // Busy and dead regions take very different times, so the tiles
+        // are shared out by work stealing rather than in fixed bands
+        THREADS_RunTasks(Game_p->Pool_p, ListActiveTiles(Game_p), EvolveTile, Game_p);
+
+        byte_t* TempWorld_p = Game_p->CurrentWorld_p;
+        Game_p->CurrentWorld_p = Game_p->EvolvingWorld_p;
+        Game_p->EvolvingWorld_p = TempWorld_p;
+
+        unsigned char* TempChanged_p = Game_p->TileChanged_p;
+        Game_p->TileChanged_p = Game_p->EvolvingTileChanged_p;
+        Game_p->EvolvingTileChanged_p = TempChanged_p;
+        Game_p->EvolveAllTiles = 0;
+
+        STATS_Reset(&Game_p->Stats);
+        for (int Tile = 0; Tile < Game_p->TilesX * Game_p->TilesY; Tile++)
+        {
+            STATS_Merge(&Game_p->Stats, &Game_p->TileStats_p[Tile]);
+        }
+    }
+    Game_p->StatsValid = 1;
+    return 0;
+}
+
+
+void
+ARRAY_GetStats(ArrayGame_t* Game_p, STATS_t* Stats_p)
+{
+    if (!Game_p->StatsValid)
+    {
+        const size_t BytesPerRow = Game_p->Width + 2;
+
+        STATS_Reset(&Game_p->Stats);
         for (int Row = 0; Row < Game_p->Height; Row++)
         {
-            int NewCellState = CalculateNewCellState(Game_p, Column, Row);
-            ARRAY_SetCellState(Game_p, Column, Row, NewCellState);
+            const byte_t* Row_p = Game_p->CurrentWorld_p + (Row + 1) * BytesPerRow;
+            int Population = 0;
+            int MinColumn = 0;
+            int MaxColumn = 0;
+
+            for (int Column = 0; Column < Game_p->Width; Column++)
+            {
+                if (Row_p[1 + Column])
+                {
+                    MinColumn = (Population == 0) ? Column : MinColumn;
+                    MaxColumn = Column;
+                    Population++;
+                }
+            }
+            STATS_AddRow(&Game_p->Stats, Row, Population, MinColumn, MaxColumn);
         }
+        Game_p->StatsValid = 1;
+    }
+    *Stats_p = Game_p->Stats;
+}
+
+
+void
+ARRAY_SetRowInCurrent(ArrayGame_t*          Game_p,
+                      const int             Row,
+                      const uint64_t* const Cells_p)
+{
+    byte_t* Row_p = Game_p->CurrentWorld_p + (size_t)(Row + 1) * (Game_p->Width + 2) + 1;
+
+    for (int Column = 0; Column < Game_p->Width; Column++)
+    {
+        Row_p[Column] = (Cells_p[Column / 64] >> (Column % 64)) & 1;
+    }
+}
+
+
+void
+ARRAY_StampRowInCurrent(ArrayGame_t*          Game_p,
+                        const int             Row,
+                        const int             Column,
+                        const uint64_t* const Cells_p,
+                        const int             NumberOfColumns,
+                        const PATTERN_Mode_t  Mode)
+{
+    byte_t* Row_p = Game_p->CurrentWorld_p + (size_t)(Row + 1) * (Game_p->Width + 2) + 1;
+    const int FirstColumn = (Column > 0) ? Column : 0;
+    const int EndColumn   = (Column + NumberOfColumns < Game_p->Width) ? Column + NumberOfColumns : Game_p->Width;
+
+    for (int i = FirstColumn; i < EndColumn; i++)
+    {
+        const int j = i - Column;
+
+        Row_p[i] = (byte_t)PATTERN_Combine(Row_p[i], (Cells_p[j / 64] >> (j % 64)) & 1, 1, Mode);
     }
+}
+
 
-    byte_t* TempWorld_p = Game_p->CurrentWorld_p;
-    Game_p->CurrentWorld_p = Game_p->EvolvingWorld_p;
-    Game_p->EvolvingWorld_p = TempWorld_p;
+void
+ARRAY_InvalidateStats(ArrayGame_t* Game_p)
+{
+    Game_p->StatsValid     = 0;
+    Game_p->EvolveAllTiles = 1;
 }
 
 
@@ -107,35 +350,218 @@ ARRAY_GetWorldHeight(ArrayGame_t* Game_p)
 }
 
 
+static void
+FirstTouchBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    ArrayGame_t* Game_p = (ArrayGame_t*)Context_p;
+    const size_t BytesPerRow = Game_p->Width + 2;
+    int Start;
+    int End;
+
+    THREADS_GetBand(Game_p->Height, ThreadIndex, NumberOfThreads, &Start, &End);
+
+    // Translate to storage rows, the first and last band also own the halo
+    Start = (Start == 0) ? 0 : Start + 1;
+    End   = (End == Game_p->Height) ? Game_p->Height + 2 : End + 1;
+
+    memset(Game_p->CurrentWorld_p + Start * BytesPerRow, 0, (End - Start) * BytesPerRow);
+    if (Game_p->EvolvingWorld_p != NULL)
+    {
+        memset(Game_p->EvolvingWorld_p + Start * BytesPerRow, 0, (End - Start) * BytesPerRow);
+    }
+}
+
+
+// Tiles that can change are those next to a tile that changed last time
 static int
-CalculateNewCellState(ArrayGame_t* Game_p,
-                      const int    Column,
-                      const int    Row)
-{
-
-//    int CurrentState = ARRAY_GetCellState(Game_p, Column, Row);
-    int CurrentState = *(Game_p->CurrentWorld_p + POS_OFFSET(Column, Row, Game_p->Width));
-    int NewState = 0;
-    int Neighbors;
-
-    Neighbors = *(Game_p->CurrentWorld_p + POS_OFFSET(Column - 1, Row - 1, Game_p->Width)) +
-                *(Game_p->CurrentWorld_p + POS_OFFSET(Column,     Row - 1, Game_p->Width)) +
-                *(Game_p->CurrentWorld_p + POS_OFFSET(Column + 1, Row - 1, Game_p->Width)) +
-                *(Game_p->CurrentWorld_p + POS_OFFSET(Column - 1, Row,     Game_p->Width)) +
-                *(Game_p->CurrentWorld_p + POS_OFFSET(Column + 1, Row,     Game_p->Width)) +
-                *(Game_p->CurrentWorld_p + POS_OFFSET(Column - 1, Row + 1, Game_p->Width)) +
-                *(Game_p->CurrentWorld_p + POS_OFFSET(Column,     Row + 1, Game_p->Width)) +
-                *(Game_p->CurrentWorld_p + POS_OFFSET(Column + 1, Row + 1, Game_p->Width));
-
-    if (CurrentState)
+ListActiveTiles(ArrayGame_t* Game_p)
+{
+    int NumberOfActiveTiles = 0;
+
+    for (int TileY = 0; TileY < Game_p->TilesY; TileY++)
     {
-        // Cell is ALIVE
-        NewState = (Neighbors == 2 || Neighbors == 3);
+        for (int TileX = 0; TileX < Game_p->TilesX; TileX++)
+        {
+            const int Tile = TileY * Game_p->TilesX + TileX;
+            int Active = Game_p->EvolveAllTiles;
+
+            for (int y = TileY - 1; y <= TileY + 1 && !Active; y++)
+            {
+                for (int x = TileX - 1; x <= TileX + 1 && !Active; x++)
+                {
+                    Active = (x >= 0 && x < Game_p->TilesX && y >= 0 && y < Game_p->TilesY &&
+                              Game_p->TileChanged_p[y * Game_p->TilesX + x]);
+                }
+            }
+
+            if (Active)
+            {
+                Game_p->ActiveTiles_p[NumberOfActiveTiles++] = Tile;
+            }
+            else
+            {
+                // The evolving world still holds the previous generation,
+                // which is the same as the current one in this tile
+                Game_p->EvolvingTileChanged_p[Tile] = 0;
+            }
+        }
     }
-    else
+    return NumberOfActiveTiles;
+}
+
+
+static void
+EvolveTile(void* Context_p, const int Task, const int ThreadIndex)
+{
+    ArrayGame_t* Game_p = (ArrayGame_t*)Context_p;
+    const size_t BytesPerRow = Game_p->Width + 2;
+    const int Tile = Game_p->ActiveTiles_p[Task];
+    const int FirstRow    = (Tile / Game_p->TilesX) * ARRAY_TILE_ROWS;
+    const int FirstColumn = (Tile % Game_p->TilesX) * ARRAY_TILE_COLUMNS;
+    const int EndRow      = (FirstRow + ARRAY_TILE_ROWS < Game_p->Height) ?
+                            FirstRow + ARRAY_TILE_ROWS : Game_p->Height;
+    const int EndColumn   = (FirstColumn + ARRAY_TILE_COLUMNS < Game_p->Width) ?
+                            FirstColumn + ARRAY_TILE_COLUMNS : Game_p->Width;
+    STATS_t* Stats_p = &Game_p->TileStats_p[Tile];
+    int Changed = 0;
+
+    STATS_Reset(Stats_p);
+
+    for (int Row = FirstRow; Row < EndRow; Row++)
+    {
+        // Offset so that the tile looks like a world EndColumn - FirstColumn wide
+        const byte_t* Row_p = Game_p->CurrentWorld_p + (Row + 1) * BytesPerRow + FirstColumn;
+        byte_t* Evolved_p = Game_p->EvolvingWorld_p + (Row + 1) * BytesPerRow + FirstColumn;
+        int MinColumn;
+        int MaxColumn;
+        int Population;
+
+        Population = EvolveRow(Row_p - BytesPerRow, Row_p, Row_p + BytesPerRow, Evolved_p,
+                               EndColumn - FirstColumn, &MinColumn, &MaxColumn);
+        STATS_AddRow(Stats_p, Row, Population, FirstColumn + MinColumn, FirstColumn + MaxColumn);
+        if (!Changed)
+        {
+            Changed = (memcmp(Evolved_p + 1, Row_p + 1, EndColumn - FirstColumn) != 0);
+        }
+    }
+
+    Game_p->EvolvingTileChanged_p[Tile] = Changed;
+}
+
+
+/*
+ * Each thread has four rows in RowBuffers_p: the original row above its
+ * band, the original row below it, and a ring of two for the original
+ * versions of the rows it has already overwritten.
+ */
+static void
+SaveBandBordersInPlace(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    ArrayGame_t* Game_p = (ArrayGame_t*)Context_p;
+    const size_t BytesPerRow = Game_p->Width + 2;
+    byte_t* Buffers_p = Game_p->RowBuffers_p + 4 * BytesPerRow * ThreadIndex;
+    int Start;
+    int End;
+
+    THREADS_GetBand(Game_p->Height, ThreadIndex, NumberOfThreads, &Start, &End);
+
+    // Storage row Start holds world row Start - 1, the halo for the first band
+    memcpy(Buffers_p, Game_p->CurrentWorld_p + Start * BytesPerRow, BytesPerRow);
+    memcpy(Buffers_p + BytesPerRow, Game_p->CurrentWorld_p + (End + 1) * BytesPerRow, BytesPerRow);
+}
+
+
+static void
+EvolveBandInPlace(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    ArrayGame_t* Game_p = (ArrayGame_t*)Context_p;
+    const size_t BytesPerRow = Game_p->Width + 2;
+    byte_t* Buffers_p = Game_p->RowBuffers_p + 4 * BytesPerRow * ThreadIndex;
+    const byte_t* Below_p = Buffers_p + BytesPerRow;
+    byte_t* Ring_p[2] = { Buffers_p + 2 * BytesPerRow, Buffers_p + 3 * BytesPerRow };
+    STATS_t* Stats_p = &Game_p->BandStats_p[ThreadIndex];
+    const byte_t* Prev_p;
+    int Start;
+    int End;
+    int ActiveStart;
+    int ActiveEnd;
+
+    GetBandActiveRows(Game_p, ThreadIndex, NumberOfThreads, &Start, &End, &ActiveStart, &ActiveEnd);
+    STATS_Reset(Stats_p);
+
+    // Rows above the active ones are left untouched, so they are still original
+    Prev_p = (ActiveStart == Start) ? Buffers_p :
+             Game_p->CurrentWorld_p + ActiveStart * BytesPerRow;
+
+    for (int Row = ActiveStart; Row < ActiveEnd; Row++)
+    {
+        byte_t* Row_p = Game_p->CurrentWorld_p + (Row + 1) * BytesPerRow;
+        byte_t* Saved_p = Ring_p[Row & 1];
+        const byte_t* Next_p = (Row + 1 < End) ? Row_p + BytesPerRow : Below_p;
+        int MinColumn;
+        int MaxColumn;
+        int Population;
+
+        memcpy(Saved_p, Row_p, BytesPerRow);
+        Population = EvolveRow(Prev_p, Saved_p, Next_p, Row_p, Game_p->Width, &MinColumn, &MaxColumn);
+        STATS_AddRow(Stats_p, Row, Population, MinColumn, MaxColumn);
+        Prev_p = Saved_p;
+    }
+}
+
+
+// Returns the population of the evolved row and the columns it spans
+static int
+EvolveRow(const byte_t* const PrevRow_p,
+          const byte_t* const CurrentRow_p,
+          const byte_t* const NextRow_p,
+          byte_t* const       EvolvedRow_p,
+          const int           Width,
+          int* const          MinColumn_p,
+          int* const          MaxColumn_p)
+{
+    int Population = 0;
+
+    *MinColumn_p = 0;
+    *MaxColumn_p = 0;
+
+    for (int Column = 1; Column <= Width; Column++)
+    {
+        int Neighbors = PrevRow_p[Column - 1] + PrevRow_p[Column] + PrevRow_p[Column + 1] +
+                        CurrentRow_p[Column - 1] +              CurrentRow_p[Column + 1] +
+                        NextRow_p[Column - 1] + NextRow_p[Column] + NextRow_p[Column + 1];
+        int NewState = (Neighbors == 3) || (CurrentRow_p[Column] && Neighbors == 2);
+
+        EvolvedRow_p[Column] = NewState;
+        if (NewState)
+        {
+            if (Population == 0)
+            {
+                *MinColumn_p = Column - 1;
+            }
+            *MaxColumn_p = Column - 1;
+            Population++;
+        }
+    }
+    return Population;
+}
+
+
+static void
+GetBandActiveRows(ArrayGame_t* Game_p,
+                  const int    ThreadIndex,
+                  const int    NumberOfThreads,
+                  int*         Start_p,
+                  int*         End_p,
+                  int*         ActiveStart_p,
+                  int*         ActiveEnd_p)
+{
+    THREADS_GetBand(Game_p->Height, ThreadIndex, NumberOfThreads, Start_p, End_p);
+
+    *ActiveStart_p = (Game_p->ActiveStart > *Start_p) ? Game_p->ActiveStart : *Start_p;
+    *ActiveEnd_p   = (Game_p->ActiveEnd < *End_p) ? Game_p->ActiveEnd : *End_p;
+    if (*ActiveEnd_p < *ActiveStart_p)
     {
-        // Cell is DEAD
-        NewState = (Neighbors == 3);
+        *ActiveEnd_p = *ActiveStart_p;
     }
-    return NewState;
 }
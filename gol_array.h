@@ -6,29 +6,77 @@
 #ifndef GOL_ARRAY_H_
 #define GOL_ARRAY_H_
 
+#include <stdint.h>
+
+#include "gol_threads.h"
+#include "gol_stats.h"
+#include "gol_pattern.h"
+
 
 typedef unsigned char byte_t;
 
 
+// Worlds with two buffers are evolved in tiles of this many rows and
+// columns, and only tiles next to a tile that changed last time are evolved
+#ifndef ARRAY_TILE_ROWS
+#define ARRAY_TILE_ROWS      32
+#endif
+#ifndef ARRAY_TILE_COLUMNS
+#define ARRAY_TILE_COLUMNS   256
+#endif
+
+
 typedef struct
 {
-    int     Width;
-    int     Height;
-    byte_t* CurrentWorld_p;
-    byte_t* EvolvingWorld_p;
+    int             Width;
+    int             Height;
+    byte_t*         CurrentWorld_p;
+    byte_t*         EvolvingWorld_p;  // NULL when evolving in place
+    byte_t*         RowBuffers_p;     // In place: four saved rows per thread
+    THREADS_Pool_t* Pool_p;
+    STATS_t         Stats;            // Live cells in CurrentWorld_p
+    int             StatsValid;
+    STATS_t*        BandStats_p;      // One per thread, merged after evolve
+    int             ActiveStart;      // In place: rows that may change in this evolve
+    int             ActiveEnd;
+    int             TilesX;
+    int             TilesY;
+    unsigned char*  TileChanged_p;    // Per tile: changed in the last evolve
+    unsigned char*  EvolvingTileChanged_p;
+    STATS_t*        TileStats_p;      // Per tile: live cells in CurrentWorld_p
+    int*            ActiveTiles_p;    // Tiles to evolve in this evolve
+    int             EvolveAllTiles;   // Set when CurrentWorld_p is changed directly
 } ArrayGame_t;
 
 
-void
-ARRAY_InitializeWorld(ArrayGame_t* Game_p,
-                      const int    Width,
-                      const int    Height);
+// Rows are split into one band per thread in Pool_p (which may be NULL),
+// and each worker zeroes its own band so that its pages are placed locally.
+// With InPlace set only one world is allocated and it is evolved row by
+// row, keeping the original rows that are still needed in a small ring.
+// Returns 0, or -1 if out of memory, with nothing left allocated.
+int
+ARRAY_InitializeWorld(ArrayGame_t*    Game_p,
+                      const int       Width,
+                      const int       Height,
+                      const int       InPlace,
+                      THREADS_Pool_t* Pool_p);
 
 
 void
 ARRAY_DestroyWorld(ArrayGame_t* Game_p);
 
 
+// Reallocates the world and moves cell (Column, Row) to (Column +
+// ColumnShift, Row + RowShift). Cells that end up outside are dropped.
+// Returns 0, or -1 if out of memory, with the world left as it was.
+int
+ARRAY_ResizeWorld(ArrayGame_t* Game_p,
+                  const int    NewWidth,
+                  const int    NewHeight,
+                  const int    ColumnShift,
+                  const int    RowShift);
+
+
 void
 ARRAY_SetCellState(ArrayGame_t* Game_p,
                    const int    Column,
@@ -49,10 +97,43 @@ ARRAY_GetCellState(ArrayGame_t* Game_p,
                    const int    Row);
 
 
-void
+// Returns 0, or -1 if out of memory, with the world left as it was
+int
 ARRAY_EvolveWorld(ArrayGame_t* Game_p);
 
 
+// Stats come for free after an evolve, otherwise the world is scanned
+void
+ARRAY_GetStats(ArrayGame_t* Game_p, STATS_t* Stats_p);
+
+
+// Sets a whole row of the current world, bit c % 64 of word c / 64 is
+// column c. Bits for columns >= Width must be clear. Rows may be set from
+// several threads at once, ARRAY_InvalidateStats() must be called after.
+void
+ARRAY_SetRowInCurrent(ArrayGame_t*          Game_p,
+                      const int             Row,
+                      const uint64_t* const Cells_p);
+
+
+// Combines NumberOfColumns packed cells, laid out as for
+// ARRAY_SetRowInCurrent(), into the current world from (Column, Row) on.
+// Column may be negative, cells outside the world are dropped.
+// ARRAY_InvalidateStats() must be called after.
+void
+ARRAY_StampRowInCurrent(ArrayGame_t*          Game_p,
+                        const int             Row,
+                        const int             Column,
+                        const uint64_t* const Cells_p,
+                        const int             NumberOfColumns,
+                        const PATTERN_Mode_t  Mode);
+
+
+// Must be called after the current world is modified directly
+void
+ARRAY_InvalidateStats(ArrayGame_t* Game_p);
+
+
 int
 ARRAY_GetWorldWidth(ArrayGame_t* Game_p);
 
@@ -7,22 +7,66 @@
 #include <string.h>
 
 #include "gol_bits.h"
+#include "gol_snapshot.h"
 
 //#define ENABLE_VERBOSE_LOGGING
 
 #define CALC_BITS_PER_3(X)   ((0x0E994 >> ((X) << 1)) & 0x03)
 
-
+#ifdef ENABLE_VERBOSE_LOGGING
 static int
 CalculateNewCellState(BitsGame_t* Game_p,
                       const int   Column,
                       const int   Row);
+#endif
 
+static void
+FirstTouchBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
 
-void
-BITS_InitializeWorld(BitsGame_t* Game_p,
-                     const int   Width,
-                     const int   Height)
+static int
+ListActiveTiles(BitsGame_t* Game_p);
+
+static void
+EvolveTile(void* Context_p, const int Task, const int ThreadIndex);
+
+static void
+EvolveUints(const uint_t* const PrevRow_p,
+            const uint_t* const CurrentRow_p,
+            const uint_t* const NextRow_p,
+            uint_t* const       EvolvedRow_p,
+            const int           FirstUint,
+            const int           EndUint,
+            const int           NumberOfUints,
+            const int           Width);
+
+static void
+SaveBandBordersInPlace(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+static void
+EvolveBandInPlace(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+static int
+GetRowStats(const uint_t* const Row_p,
+            const int           NumberOfUints,
+            int* const          MinColumn_p,
+            int* const          MaxColumn_p);
+
+static void
+GetBandActiveRows(BitsGame_t* Game_p,
+                  const int   ThreadIndex,
+                  const int   NumberOfThreads,
+                  int*        Start_p,
+                  int*        End_p,
+                  int*        ActiveStart_p,
+                  int*        ActiveEnd_p);
+
+
+int
+BITS_InitializeWorld(BitsGame_t*     Game_p,
+                     const int       Width,
+                     const int       Height,
+                     const int       InPlace,
+                     THREADS_Pool_t* Pool_p)
 {
     /*
      * The world is made one bit wider than the given Width and Height.
@@ -34,21 +78,113 @@ BITS_InitializeWorld(BitsGame_t* Game_p,
     int WidthInUints  = (Width + 2 + (UintInBits - 1)) / UintInBits;  // Number of Uints per row
     int NumberOfUints = (Height + 2) * WidthInUints;
 
-    printf("We need %d uints for Width. Total: %d uints.\n", WidthInUints, NumberOfUints);
     Game_p->NumberOfUintsPerRow = WidthInUints;
     Game_p->Width  = Width;
     Game_p->Height = Height;
-    Game_p->CurrentWorld_p = malloc(NumberOfUints * sizeof(uint_t));
-    Game_p->EvolvingWorld_p = malloc(NumberOfUints * sizeof(uint_t));
-    memset(Game_p->CurrentWorld_p, 0, NumberOfUints * sizeof(uint_t));
+    Game_p->Pool_p = Pool_p;
+    Game_p->BandStats_p = malloc(THREADS_GetNumberOfThreads(Pool_p) * sizeof(STATS_t));
+    STATS_Reset(&Game_p->Stats);
+    Game_p->StatsValid = 1;
+
+    Game_p->TilesX = (WidthInUints + BITS_TILE_UINTS - 1) / BITS_TILE_UINTS;
+    Game_p->TilesY = (Height + BITS_TILE_ROWS - 1) / BITS_TILE_ROWS;
+    Game_p->TileChanged_p         = calloc(Game_p->TilesX * Game_p->TilesY, 1);
+    Game_p->EvolvingTileChanged_p = calloc(Game_p->TilesX * Game_p->TilesY, 1);
+    Game_p->TileStats_p           = malloc(Game_p->TilesX * Game_p->TilesY * sizeof(STATS_t));
+    Game_p->ActiveTiles_p         = malloc(Game_p->TilesX * Game_p->TilesY * sizeof(int));
+    Game_p->EvolveAllTiles        = 1;
+
+    Game_p->CurrentWorld_p  = SNAPSHOT_AllocateBuffer((size_t)NumberOfUints * sizeof(uint_t));
+    Game_p->EvolvingWorld_p = InPlace ? NULL : SNAPSHOT_AllocateBuffer((size_t)NumberOfUints * sizeof(uint_t));
+    Game_p->RowBuffers_p    = InPlace ?
+        malloc((size_t)4 * WidthInUints * sizeof(uint_t) * THREADS_GetNumberOfThreads(Pool_p)) : NULL;
+
+    if (Game_p->CurrentWorld_p == NULL || (Game_p->EvolvingWorld_p == NULL && !InPlace) ||
+        (Game_p->RowBuffers_p == NULL && InPlace) || Game_p->BandStats_p == NULL ||
+        Game_p->TileChanged_p == NULL || Game_p->EvolvingTileChanged_p == NULL ||
+        Game_p->TileStats_p == NULL || Game_p->ActiveTiles_p == NULL)
+    {
+        BITS_DestroyWorld(Game_p);
+        return -1;
+    }
+
+    // Instead of one memset() here, each worker clears (and so places) the
+    // rows it is going to evolve. Both worlds are cleared, halo included.
+    THREADS_Run(Pool_p, FirstTouchBand, Game_p);
+    return 0;
 }
 
 
 void
 BITS_DestroyWorld(BitsGame_t* Game_p)
 {
-    free(Game_p->CurrentWorld_p);
-    free(Game_p->EvolvingWorld_p);
+    SNAPSHOT_ReleaseBuffer(Game_p->CurrentWorld_p);
+    SNAPSHOT_ReleaseBuffer(Game_p->EvolvingWorld_p);
+    free(Game_p->RowBuffers_p);
+    free(Game_p->BandStats_p);
+    free(Game_p->TileChanged_p);
+    free(Game_p->EvolvingTileChanged_p);
+    free(Game_p->TileStats_p);
+    free(Game_p->ActiveTiles_p);
+}
+
+
+int
+BITS_ResizeWorld(BitsGame_t* Game_p,
+                 const int   NewWidth,
+                 const int   NewHeight,
+                 const int   ColumnShift,
+                 const int   RowShift)
+{
+    const int UintInBits = sizeof(uint_t) * 8;
+    const int UintShift = ColumnShift / UintInBits;
+    BitsGame_t OldGame = *Game_p;
+    int FirstUint;
+    int EndUint;
+    STATS_t Stats;
+
+    BITS_GetStats(&OldGame, &Stats);
+    if (BITS_InitializeWorld(Game_p, NewWidth, NewHeight, OldGame.EvolvingWorld_p == NULL, OldGame.Pool_p) != 0)
+    {
+        *Game_p = OldGame;
+        return -1;
+    }
+
+    FirstUint = (UintShift < 0) ? -UintShift : 0;
+    EndUint   = (OldGame.NumberOfUintsPerRow + UintShift > Game_p->NumberOfUintsPerRow) ?
+                Game_p->NumberOfUintsPerRow - UintShift : OldGame.NumberOfUintsPerRow;
+
+    for (int Row = 0; Row < OldGame.Height && EndUint > FirstUint; Row++)
+    {
+        int NewRow = Row + RowShift;
+        if (NewRow >= 0 && NewRow < NewHeight)
+        {
+            uint_t* Target_p = Game_p->CurrentWorld_p + (size_t)(NewRow + 1) * Game_p->NumberOfUintsPerRow;
+            const int LastBit = NewWidth + 1;
+
+            memcpy(Target_p + FirstUint + UintShift,
+                   OldGame.CurrentWorld_p + (size_t)(Row + 1) * OldGame.NumberOfUintsPerRow + FirstUint,
+                   (EndUint - FirstUint) * sizeof(uint_t));
+
+            // Cells may have been moved onto the halo or the padding
+            Target_p[0] &= ~1u;
+            Target_p[LastBit / UintInBits] &= (1u << (LastBit % UintInBits)) - 1;
+            for (int i = LastBit / UintInBits + 1; i < Game_p->NumberOfUintsPerRow; i++)
+            {
+                Target_p[i] = 0;
+            }
+        }
+    }
+
+    // The stats still hold unless live cells were dropped
+    STATS_Shift(&Stats, ColumnShift, RowShift);
+    Game_p->Stats = Stats;
+    Game_p->StatsValid = (Stats.Population == 0) ||
+                         (Stats.MinColumn >= 0 && Stats.MaxColumn < NewWidth &&
+                          Stats.MinRow >= 0 && Stats.MaxRow < NewHeight);
+
+    BITS_DestroyWorld(&OldGame);
+    return 0;
 }
 
 
@@ -104,6 +240,8 @@ BITS_SetCellStateInCurrent(BitsGame_t* Game_p,
     {
         *Target_p &= ~(1<<BitPos);
     }
+    Game_p->StatsValid     = 0;
+    Game_p->EvolveAllTiles = 1;
 }
 
 
@@ -131,33 +269,191 @@ BITS_GetCellState(BitsGame_t* Game_p,
 }
 
 
-void
+int
 BITS_EvolveWorld(BitsGame_t* Game_p)
 {
-#ifdef ENABLE_VERBOSE_LOGGING
-    printf("\n-------------------- NEIGHBORS...\n");
-#endif
-    for (int Row = 0; Row < Game_p->Height; Row++)
+    if (Game_p->EvolvingWorld_p == NULL)
     {
-#ifdef ENABLE_VERBOSE_LOGGING
-        printf("|");
-#endif
-        for (int Column = 0; Column < Game_p->Width; Column++)
+        const int NumberOfThreads = THREADS_GetNumberOfThreads(Game_p->Pool_p);
+
+        // A snapshot still reading this generation keeps it to itself
+        if (SNAPSHOT_UnshareBuffer((void**)&Game_p->CurrentWorld_p, 1) < 0)
         {
-            int NewCellState = CalculateNewCellState(Game_p, Column, Row);
-            BITS_SetCellState(Game_p, Column, Row, NewCellState);
+            return -1;
+        }
+
+        // Only rows next to a live row can be alive in the next generation
+        if (!Game_p->StatsValid)
+        {
+            Game_p->ActiveStart = 0;
+            Game_p->ActiveEnd   = Game_p->Height;
+        }
+        else if (Game_p->Stats.Population == 0)
+        {
+            Game_p->ActiveStart = 0;
+            Game_p->ActiveEnd   = 0;
+        }
+        else
+        {
+            Game_p->ActiveStart = (Game_p->Stats.MinRow > 0) ? Game_p->Stats.MinRow - 1 : 0;
+            Game_p->ActiveEnd   = (Game_p->Stats.MaxRow + 2 < Game_p->Height) ?
+                                  Game_p->Stats.MaxRow + 2 : Game_p->Height;
+        }
+
+        // The rows just outside each band must be saved before any band
+        // starts to overwrite its rows
+        THREADS_Run(Game_p->Pool_p, SaveBandBordersInPlace, Game_p);
+        THREADS_Run(Game_p->Pool_p, EvolveBandInPlace, Game_p);
+
+        STATS_Reset(&Game_p->Stats);
+        for (int i = 0; i < NumberOfThreads; i++)
+        {
+            STATS_Merge(&Game_p->Stats, &Game_p->BandStats_p[i]);
         }
-#ifdef ENABLE_VERBOSE_LOGGING
-        printf("\n");
-#endif
     }
+    else
+    {
 #ifdef ENABLE_VERBOSE_LOGGING
-    printf("\n--------------------\n");
+        // Cell by cell, so that the neighbour counts can be printed
+        printf("\n-------------------- NEIGHBORS...\n");
+        for (int Row = 0; Row < Game_p->Height; Row++)
+        {
+            printf("|");
+            for (int Column = 0; Column < Game_p->Width; Column++)
+            {
+                CalculateNewCellState(Game_p, Column, Row);
+            }
+            printf("\n");
+        }
+        printf("\n--------------------\n");
 #endif
+        // Skipped tiles rely on the evolving world holding the generation
+        // before, which a new buffer (if a snapshot holds the old one) does not
+        switch (SNAPSHOT_UnshareBuffer((void**)&Game_p->EvolvingWorld_p, 0))
+        {
+        case 0:
+            break;
+
+        case 1:
+            Game_p->EvolveAllTiles = 1;
+            break;
+
+        default:
+            return -1;
+        }
+
+        // Busy and dead regions take very different times, so the tiles
+        // are shared out by work stealing rather than in fixed bands
+        THREADS_RunTasks(Game_p->Pool_p, ListActiveTiles(Game_p), EvolveTile, Game_p);
+
+        uint_t* TempWorld_p = Game_p->CurrentWorld_p;
+        Game_p->CurrentWorld_p = Game_p->EvolvingWorld_p;
+        Game_p->EvolvingWorld_p = TempWorld_p;
+
+        unsigned char* TempChanged_p = Game_p->TileChanged_p;
+        Game_p->TileChanged_p = Game_p->EvolvingTileChanged_p;
+        Game_p->EvolvingTileChanged_p = TempChanged_p;
+        Game_p->EvolveAllTiles = 0;
+
+        STATS_Reset(&Game_p->Stats);
+        for (int Tile = 0; Tile < Game_p->TilesX * Game_p->TilesY; Tile++)
+        {
+            STATS_Merge(&Game_p->Stats, &Game_p->TileStats_p[Tile]);
+        }
+    }
+    Game_p->StatsValid = 1;
+    return 0;
+}
+
+
+void
+BITS_GetStats(BitsGame_t* Game_p, STATS_t* Stats_p)
+{
+    if (!Game_p->StatsValid)
+    {
+        STATS_Reset(&Game_p->Stats);
+        for (int Row = 0; Row < Game_p->Height; Row++)
+        {
+            int MinColumn;
+            int MaxColumn;
+            int Population = GetRowStats(Game_p->CurrentWorld_p + (size_t)(Row + 1) * Game_p->NumberOfUintsPerRow,
+                                         Game_p->NumberOfUintsPerRow, &MinColumn, &MaxColumn);
+            STATS_AddRow(&Game_p->Stats, Row, Population, MinColumn, MaxColumn);
+        }
+        Game_p->StatsValid = 1;
+    }
+    *Stats_p = Game_p->Stats;
+}
+
+
+void
+BITS_SetRowInCurrent(BitsGame_t*           Game_p,
+                     const int             Row,
+                     const uint64_t* const Cells_p)
+{
+    const int NumberOfWords = (Game_p->Width + 63) / 64;
+    uint_t* Row_p = Game_p->CurrentWorld_p + (size_t)(Row + 1) * Game_p->NumberOfUintsPerRow;
+
+    // Storage bit b is column b - 1, so everything moves up one bit
+    for (int i = 0; i < Game_p->NumberOfUintsPerRow; i += 2)
+    {
+        uint64_t Word  = (i / 2 < NumberOfWords) ? Cells_p[i / 2] : 0;
+        uint64_t Below = (i > 0 && i / 2 - 1 < NumberOfWords) ? Cells_p[i / 2 - 1] : 0;
+        uint64_t Shifted = (Word << 1) | (Below >> 63);
+
+        Row_p[i] = (uint_t)Shifted;
+        if (i + 1 < Game_p->NumberOfUintsPerRow)
+        {
+            Row_p[i + 1] = (uint_t)(Shifted >> 32);
+        }
+    }
+}
+
+
+void
+BITS_StampRowInCurrent(BitsGame_t*           Game_p,
+                       const int             Row,
+                       const int             Column,
+                       const uint64_t* const Cells_p,
+                       const int             NumberOfColumns,
+                       const PATTERN_Mode_t  Mode)
+{
+    const int NumberOfUints = Game_p->NumberOfUintsPerRow;
+    uint_t* Row_p = Game_p->CurrentWorld_p + (size_t)(Row + 1) * NumberOfUints;
+    // Column c is storage bit c + 1, only the uints the cells fall in are touched
+    const int FirstUint = (Column + 1 > 0) ? (Column + 1) / 32 : 0;
+    const int LastUint  = (Column + NumberOfColumns) / 32;
+
+    for (int i = FirstUint; i <= LastUint && i < NumberOfUints; i++)
+    {
+        // Storage bit 0 of uint i is column i * 32 - 1
+        const int First = i * 32 - 1 - Column;
+        const uint_t Mask = (uint_t)(PATTERN_GetMask(NumberOfColumns, First) &
+                                     PATTERN_GetMask(Game_p->Width, i * 32 - 1));
+
+        Row_p[i] = (uint_t)PATTERN_Combine(Row_p[i], PATTERN_GetBits(Cells_p, NumberOfColumns, First),
+                                           Mask, Mode);
+    }
+}
+
+
+void
+BITS_InvalidateStats(BitsGame_t* Game_p)
+{
+    Game_p->StatsValid     = 0;
+    Game_p->EvolveAllTiles = 1;
+}
+
 
-    uint_t* TempWorld_p = Game_p->CurrentWorld_p;
-    Game_p->CurrentWorld_p = Game_p->EvolvingWorld_p;
-    Game_p->EvolvingWorld_p = TempWorld_p;
+void
+BITS_EvolveRow(const uint_t* const PrevRow_p,
+               const uint_t* const CurrentRow_p,
+               const uint_t* const NextRow_p,
+               uint_t* const       EvolvedRow_p,
+               const int           NumberOfUints,
+               const int           Width)
+{
+    EvolveUints(PrevRow_p, CurrentRow_p, NextRow_p, EvolvedRow_p, 0, NumberOfUints, NumberOfUints, Width);
 }
 
 
@@ -175,6 +471,290 @@ BITS_GetWorldHeight(BitsGame_t* Game_p)
 }
 
 
+// BITS_EvolveRow() for uints FirstUint .. EndUint - 1 of the row only
+static void
+EvolveUints(const uint_t* const PrevRow_p,
+            const uint_t* const CurrentRow_p,
+            const uint_t* const NextRow_p,
+            uint_t* const       EvolvedRow_p,
+            const int           FirstUint,
+            const int           EndUint,
+            const int           NumberOfUints,
+            const int           Width)
+{
+    const int UintInBits = sizeof(uint_t) * 8;
+
+    for (int i = FirstUint; i < EndUint; i++)
+    {
+        uint_t Rows[3][3];
+        const uint_t* Source_p[3] = { PrevRow_p, CurrentRow_p, NextRow_p };
+        uint_t Ones, Twos, Fours, Carry, Carry2, Sum;
+        uint_t UpperOnes, UpperTwos, LowerOnes, LowerTwos, MiddleOnes, MiddleTwos;
+        uint_t Mask = ~0u;
+        int FirstBit = i * UintInBits;
+
+        // For each of the three rows: left neighbours, the cells, right neighbours
+        for (int r = 0; r < 3; r++)
+        {
+            uint_t Left  = (i > 0) ? Source_p[r][i - 1] : 0;
+            uint_t Right = (i < NumberOfUints - 1) ? Source_p[r][i + 1] : 0;
+            Rows[r][0] = (Source_p[r][i] << 1) | (Left >> (UintInBits - 1));
+            Rows[r][1] = Source_p[r][i];
+            Rows[r][2] = (Source_p[r][i] >> 1) | (Right << (UintInBits - 1));
+        }
+
+        // Bit-sliced adders, one lane per cell
+        Sum        = Rows[0][0] ^ Rows[0][1];
+        UpperOnes  = Sum ^ Rows[0][2];
+        UpperTwos  = (Rows[0][0] & Rows[0][1]) | (Sum & Rows[0][2]);
+        Sum        = Rows[2][0] ^ Rows[2][1];
+        LowerOnes  = Sum ^ Rows[2][2];
+        LowerTwos  = (Rows[2][0] & Rows[2][1]) | (Sum & Rows[2][2]);
+        MiddleOnes = Rows[1][0] ^ Rows[1][2];
+        MiddleTwos = Rows[1][0] & Rows[1][2];
+
+        Sum   = UpperOnes ^ LowerOnes;
+        Ones  = Sum ^ MiddleOnes;
+        Carry = (UpperOnes & LowerOnes) | (Sum & MiddleOnes);
+
+        Sum    = UpperTwos ^ LowerTwos;
+        Twos   = Sum ^ MiddleTwos;
+        Carry2 = (UpperTwos & LowerTwos) | (Sum & MiddleTwos);
+        Fours  = Carry2 ^ (Twos & Carry);
+        Twos   = Twos ^ Carry;
+
+        // Only bits 1..Width hold cells, the rest is halo or padding
+        if (i == 0)
+        {
+            Mask &= ~1u;
+        }
+        if (FirstBit + UintInBits > Width + 1)
+        {
+            int ValidBits = Width + 1 - FirstBit;
+            Mask &= (ValidBits <= 0) ? 0 : (~0u >> (UintInBits - ValidBits));
+        }
+
+        EvolvedRow_p[i] = Twos & ~Fours & (Ones | Rows[1][1]) & Mask;
+    }
+}
+
+
+static void
+FirstTouchBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    BitsGame_t* Game_p = (BitsGame_t*)Context_p;
+    const size_t BytesPerRow = Game_p->NumberOfUintsPerRow * sizeof(uint_t);
+    int Start;
+    int End;
+
+    THREADS_GetBand(Game_p->Height, ThreadIndex, NumberOfThreads, &Start, &End);
+
+    // Translate to storage rows, the first and last band also own the halo
+    Start = (Start == 0) ? 0 : Start + 1;
+    End   = (End == Game_p->Height) ? Game_p->Height + 2 : End + 1;
+
+    memset(Game_p->CurrentWorld_p + (size_t)Start * Game_p->NumberOfUintsPerRow, 0,
+           (End - Start) * BytesPerRow);
+    if (Game_p->EvolvingWorld_p != NULL)
+    {
+        memset(Game_p->EvolvingWorld_p + (size_t)Start * Game_p->NumberOfUintsPerRow, 0,
+               (End - Start) * BytesPerRow);
+    }
+}
+
+
+// Tiles that can change are those next to a tile that changed last time
+static int
+ListActiveTiles(BitsGame_t* Game_p)
+{
+    int NumberOfActiveTiles = 0;
+
+    for (int TileY = 0; TileY < Game_p->TilesY; TileY++)
+    {
+        for (int TileX = 0; TileX < Game_p->TilesX; TileX++)
+        {
+            const int Tile = TileY * Game_p->TilesX + TileX;
+            int Active = Game_p->EvolveAllTiles;
+
+            for (int y = TileY - 1; y <= TileY + 1 && !Active; y++)
+            {
+                for (int x = TileX - 1; x <= TileX + 1 && !Active; x++)
+                {
+                    Active = (x >= 0 && x < Game_p->TilesX && y >= 0 && y < Game_p->TilesY &&
+                              Game_p->TileChanged_p[y * Game_p->TilesX + x]);
+                }
+            }
+
+            if (Active)
+            {
+                Game_p->ActiveTiles_p[NumberOfActiveTiles++] = Tile;
+            }
+            else
+            {
+                // The evolving world still holds the previous generation,
+                // which is the same as the current one in this tile
+                Game_p->EvolvingTileChanged_p[Tile] = 0;
+            }
+        }
+    }
+    return NumberOfActiveTiles;
+}
+
+
+static void
+EvolveTile(void* Context_p, const int Task, const int ThreadIndex)
+{
+    BitsGame_t* Game_p = (BitsGame_t*)Context_p;
+    const int UintInBits = sizeof(uint_t) * 8;
+    const size_t Stride = Game_p->NumberOfUintsPerRow;
+    const int Tile = Game_p->ActiveTiles_p[Task];
+    const int FirstRow  = (Tile / Game_p->TilesX) * BITS_TILE_ROWS;
+    const int FirstUint = (Tile % Game_p->TilesX) * BITS_TILE_UINTS;
+    const int EndRow    = (FirstRow + BITS_TILE_ROWS < Game_p->Height) ?
+                          FirstRow + BITS_TILE_ROWS : Game_p->Height;
+    const int EndUint   = (FirstUint + BITS_TILE_UINTS < Game_p->NumberOfUintsPerRow) ?
+                          FirstUint + BITS_TILE_UINTS : Game_p->NumberOfUintsPerRow;
+    STATS_t* Stats_p = &Game_p->TileStats_p[Tile];
+    int Changed = 0;
+
+    STATS_Reset(Stats_p);
+
+    for (int Row = FirstRow; Row < EndRow; Row++)
+    {
+        const uint_t* Row_p = Game_p->CurrentWorld_p + (Row + 1) * Stride;
+        uint_t* Evolved_p = Game_p->EvolvingWorld_p + (Row + 1) * Stride;
+        int MinColumn;
+        int MaxColumn;
+        int Population;
+
+        EvolveUints(Row_p - Stride, Row_p, Row_p + Stride, Evolved_p,
+                    FirstUint, EndUint, Game_p->NumberOfUintsPerRow, Game_p->Width);
+        Population = GetRowStats(Evolved_p + FirstUint, EndUint - FirstUint, &MinColumn, &MaxColumn);
+        STATS_AddRow(Stats_p, Row, Population,
+                     FirstUint * UintInBits + MinColumn, FirstUint * UintInBits + MaxColumn);
+        if (!Changed)
+        {
+            Changed = (memcmp(Evolved_p + FirstUint, Row_p + FirstUint,
+                              (EndUint - FirstUint) * sizeof(uint_t)) != 0);
+        }
+    }
+
+    Game_p->EvolvingTileChanged_p[Tile] = Changed;
+}
+
+
+/*
+ * Each thread has four rows in RowBuffers_p: the original row above its
+ * band, the original row below it, and a ring of two for the original
+ * versions of the rows it has already overwritten.
+ */
+static void
+SaveBandBordersInPlace(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    BitsGame_t* Game_p = (BitsGame_t*)Context_p;
+    const size_t Stride = Game_p->NumberOfUintsPerRow;
+    uint_t* Buffers_p = Game_p->RowBuffers_p + 4 * Stride * ThreadIndex;
+    int Start;
+    int End;
+
+    THREADS_GetBand(Game_p->Height, ThreadIndex, NumberOfThreads, &Start, &End);
+
+    // Storage row Start holds world row Start - 1, the halo for the first band
+    memcpy(Buffers_p, Game_p->CurrentWorld_p + Start * Stride, Stride * sizeof(uint_t));
+    memcpy(Buffers_p + Stride, Game_p->CurrentWorld_p + (End + 1) * Stride, Stride * sizeof(uint_t));
+}
+
+
+static void
+EvolveBandInPlace(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    BitsGame_t* Game_p = (BitsGame_t*)Context_p;
+    const size_t Stride = Game_p->NumberOfUintsPerRow;
+    uint_t* Buffers_p = Game_p->RowBuffers_p + 4 * Stride * ThreadIndex;
+    const uint_t* Below_p = Buffers_p + Stride;
+    uint_t* Ring_p[2] = { Buffers_p + 2 * Stride, Buffers_p + 3 * Stride };
+    STATS_t* Stats_p = &Game_p->BandStats_p[ThreadIndex];
+    const uint_t* Prev_p;
+    int Start;
+    int End;
+    int ActiveStart;
+    int ActiveEnd;
+
+    GetBandActiveRows(Game_p, ThreadIndex, NumberOfThreads, &Start, &End, &ActiveStart, &ActiveEnd);
+    STATS_Reset(Stats_p);
+
+    // Rows above the active ones are left untouched, so they are still original
+    Prev_p = (ActiveStart == Start) ? Buffers_p : Game_p->CurrentWorld_p + ActiveStart * Stride;
+
+    for (int Row = ActiveStart; Row < ActiveEnd; Row++)
+    {
+        uint_t* Row_p = Game_p->CurrentWorld_p + (Row + 1) * Stride;
+        uint_t* Saved_p = Ring_p[Row & 1];
+        const uint_t* Next_p = (Row + 1 < End) ? Row_p + Stride : Below_p;
+        int MinColumn;
+        int MaxColumn;
+        int Population;
+
+        memcpy(Saved_p, Row_p, Stride * sizeof(uint_t));
+        BITS_EvolveRow(Prev_p, Saved_p, Next_p, Row_p, Game_p->NumberOfUintsPerRow, Game_p->Width);
+        Population = GetRowStats(Row_p, Game_p->NumberOfUintsPerRow, &MinColumn, &MaxColumn);
+        STATS_AddRow(Stats_p, Row, Population, MinColumn, MaxColumn);
+        Prev_p = Saved_p;
+    }
+}
+
+
+// Population by popcount, and the columns spanned by the live cells in a row
+static int
+GetRowStats(const uint_t* const Row_p,
+            const int           NumberOfUints,
+            int* const          MinColumn_p,
+            int* const          MaxColumn_p)
+{
+    const int UintInBits = sizeof(uint_t) * 8;
+    int Population = 0;
+
+    *MinColumn_p = 0;
+    *MaxColumn_p = 0;
+
+    for (int i = 0; i < NumberOfUints; i++)
+    {
+        if (Row_p[i] != 0)
+        {
+            // Bit 0 of the first uint is the halo, so bit b is column b - 1
+            if (Population == 0)
+            {
+                *MinColumn_p = i * UintInBits + __builtin_ctz(Row_p[i]) - 1;
+            }
+            *MaxColumn_p = i * UintInBits + (UintInBits - 1 - __builtin_clz(Row_p[i])) - 1;
+            Population += __builtin_popcount(Row_p[i]);
+        }
+    }
+    return Population;
+}
+
+
+static void
+GetBandActiveRows(BitsGame_t* Game_p,
+                  const int   ThreadIndex,
+                  const int   NumberOfThreads,
+                  int*        Start_p,
+                  int*        End_p,
+                  int*        ActiveStart_p,
+                  int*        ActiveEnd_p)
+{
+    THREADS_GetBand(Game_p->Height, ThreadIndex, NumberOfThreads, Start_p, End_p);
+
+    *ActiveStart_p = (Game_p->ActiveStart > *Start_p) ? Game_p->ActiveStart : *Start_p;
+    *ActiveEnd_p   = (Game_p->ActiveEnd < *End_p) ? Game_p->ActiveEnd : *End_p;
+    if (*ActiveEnd_p < *ActiveStart_p)
+    {
+        *ActiveEnd_p = *ActiveStart_p;
+    }
+}
+
+
+#ifdef ENABLE_VERBOSE_LOGGING
 static int
 CalculateNewCellState(BitsGame_t* Game_p,
                       const int   Column,
@@ -244,3 +824,4 @@ CalculateNewCellState(BitsGame_t* Game_p,
 #endif
     return NewState;
 }
+#endif // ENABLE_VERBOSE_LOGGING
@@ -6,30 +6,79 @@
 #ifndef GOL_BITS_H_
 #define GOL_BITS_H_
 
+#include <stdint.h>
+
+#include "gol_threads.h"
+#include "gol_stats.h"
+#include "gol_pattern.h"
+
 
 typedef unsigned int uint_t;
 
 
+// Worlds with two buffers are evolved in tiles of this many rows and
+// uints, and only tiles next to a tile that changed last time are evolved
+#ifndef BITS_TILE_ROWS
+#define BITS_TILE_ROWS    64
+#endif
+#ifndef BITS_TILE_UINTS
+#define BITS_TILE_UINTS   8
+#endif
+
+
 typedef struct
 {
-    int     Width;
-    int     Height;
-    int     NumberOfUintsPerRow;
-    uint_t* CurrentWorld_p;
-    uint_t* EvolvingWorld_p;
+    int             Width;
+    int             Height;
+    int             NumberOfUintsPerRow;
+    uint_t*         CurrentWorld_p;
+    uint_t*         EvolvingWorld_p;  // NULL when evolving in place
+    uint_t*         RowBuffers_p;     // In place: four saved rows per thread
+    THREADS_Pool_t* Pool_p;
+    STATS_t         Stats;            // Live cells in CurrentWorld_p
+    int             StatsValid;
+    STATS_t*        BandStats_p;      // One per thread, merged after evolve
+    int             ActiveStart;      // In place: rows that may change in this evolve
+    int             ActiveEnd;
+    int             TilesX;
+    int             TilesY;
+    unsigned char*  TileChanged_p;    // Per tile: changed in the last evolve
+    unsigned char*  EvolvingTileChanged_p;
+    STATS_t*        TileStats_p;      // Per tile: live cells in CurrentWorld_p
+    int*            ActiveTiles_p;    // Tiles to evolve in this evolve
+    int             EvolveAllTiles;   // Set when CurrentWorld_p is changed directly
 } BitsGame_t;
 
 
-void
-BITS_InitializeWorld(BitsGame_t* Game_p,
-                     const int   Width,
-                     const int   Height);
+// Rows are split into one band per thread in Pool_p (which may be NULL),
+// and each worker zeroes its own band so that its pages are placed locally.
+// With InPlace set only one world is allocated and it is evolved row by
+// row, keeping the original rows that are still needed in a small ring.
+// Returns 0, or -1 if out of memory, with nothing left allocated.
+int
+BITS_InitializeWorld(BitsGame_t*     Game_p,
+                     const int       Width,
+                     const int       Height,
+                     const int       InPlace,
+                     THREADS_Pool_t* Pool_p);
 
 
 void
 BITS_DestroyWorld(BitsGame_t* Game_p);
 
 
+// Reallocates the world and moves cell (Column, Row) to (Column +
+// ColumnShift, Row + RowShift). Cells that end up outside are dropped.
+// Returns 0, or -1 if out of memory, with the world left as it was.
+// ColumnShift must be a multiple of 32, so that rows move as whole uints.
+int
+BITS_ResizeWorld(BitsGame_t* Game_p,
+                 const int   NewWidth,
+                 const int   NewHeight,
+                 const int   ColumnShift,
+                 const int   RowShift);
+
+
 void
 BITS_SetCellState(BitsGame_t* Game_p,
                   const int   Column,
@@ -50,10 +99,57 @@ BITS_GetCellState(BitsGame_t* Game_p,
                   const int   Row);
 
 
-void
+// Returns 0, or -1 if out of memory, with the world left as it was
+int
 BITS_EvolveWorld(BitsGame_t* Game_p);
 
 
+/*
+ * Computes one row of the next generation, 32 cells at a time, from the
+ * three rows around it. Rows use the world layout (bit 0 of the first uint
+ * is the left halo), and halo and padding bits of NextRow_p are left clear.
+ */
+void
+BITS_EvolveRow(const uint_t* const PrevRow_p,
+               const uint_t* const CurrentRow_p,
+               const uint_t* const NextRow_p,
+               uint_t* const       EvolvedRow_p,
+               const int           NumberOfUints,
+               const int           Width);
+
+
+// Stats come for free after an evolve, otherwise the world is scanned
+void
+BITS_GetStats(BitsGame_t* Game_p, STATS_t* Stats_p);
+
+
+// Sets a whole row of the current world, bit c % 64 of word c / 64 is
+// column c. Bits for columns >= Width must be clear. Rows may be set from
+// several threads at once, BITS_InvalidateStats() must be called after.
+void
+BITS_SetRowInCurrent(BitsGame_t*           Game_p,
+                     const int             Row,
+                     const uint64_t* const Cells_p);
+
+
+// Combines NumberOfColumns packed cells, laid out as for
+// BITS_SetRowInCurrent(), into the current world from (Column, Row) on.
+// Column may be negative, cells outside the world are dropped.
+// BITS_InvalidateStats() must be called after.
+void
+BITS_StampRowInCurrent(BitsGame_t*           Game_p,
+                       const int             Row,
+                       const int             Column,
+                       const uint64_t* const Cells_p,
+                       const int             NumberOfColumns,
+                       const PATTERN_Mode_t  Mode);
+
+
+// Must be called after the current world is modified directly
+void
+BITS_InvalidateStats(BitsGame_t* Game_p);
+
+
 int
 BITS_GetWorldWidth(BitsGame_t* Game_p);
 
@@ -0,0 +1,1610 @@
+/*
+ * Game of Life - CENSUS Implementation
+ *
+ */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gol_census.h"
+#include "gol_random.h"
+
+
+// Spaceships are tried in a 64 x 64 world of their own, at least this far
+// from its edges
+#define SCRATCH_SIZE     64
+#define SCRATCH_MARGIN   8
+
+// Soups are 16 x 16, in the middle of a world big enough for most of them
+// to settle in. Spaceships are taken out once they get within SOUP_BAND
+// cells of its edges, and the soup moves to a world twice as large when
+// anything else does, up to SOUP_MAX_WORLD_SIZE.
+#define SOUP_SIZE             16
+#define SOUP_WORLD_SIZE       128
+#define SOUP_NUMBER_OF_SIZES  4
+#define SOUP_MAX_WORLD_SIZE   (SOUP_WORLD_SIZE << (SOUP_NUMBER_OF_SIZES - 1))
+#define SOUP_MAX_WORDS        (SOUP_MAX_WORLD_SIZE * (SOUP_MAX_WORLD_SIZE / 64))
+#define SOUP_BAND             8
+#define SOUP_MAX_PERIOD       60
+#define SOUP_MAX_GENERATIONS  20000
+#define SOUPS_PER_TASK        16
+
+
+// The rows and words of a soup world that hold all of its live cells
+typedef struct
+{
+    int FirstRow;
+    int EndRow;
+    int FirstWord;
+    int EndWord;
+} SoupBox_t;
+
+
+// The worlds of one worker, one of each size, made when first needed and
+// left empty between soups, and its own census
+typedef struct
+{
+    THREADS_Pool_t Pool;                            // Without threads, for the worlds
+    void*          Worlds_p[SOUP_NUMBER_OF_SIZES];  // SOUP_WORLD_SIZE square, doubling
+    CENSUS_Table_t Table;
+    uint64_t*      Boxes_p;            // Two boxes of the largest world, then a row of it
+    uint64_t*      Generations_p;      // One period, in the box of all of it
+    size_t         GenerationsSize;    // In words
+    int            Failed;
+} SoupWorker_t;
+
+
+typedef struct
+{
+    const VARIANT_Ops_t* Ops_p;
+    uint64_t             Seed;
+    long long            NumberOfSoups;
+    long long            SoupsPerTask;
+    SoupWorker_t*        Workers_p;
+} SoupSearch_t;
+
+
+static const char Digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+
+static uint64_t
+HashCode(const char* Code_p);
+
+static int
+GrowTable(CENSUS_Table_t* Table_p);
+
+static int
+CompareEntries(const void* Entry1_p, const void* Entry2_p);
+
+static int
+AddCell(CENSUS_Object_t* Object_p, const int Column, const int Row);
+
+static int
+FindGroup(int* Groups_p, int Object);
+
+static int
+GetGroup(const CENSUS_Object_t* Objects_p,
+         const int              NumberOfObjects,
+         int*                   Groups_p,
+         const int              Root,
+         CENSUS_Object_t*       Group_p);
+
+static int
+GetPhases(const CENSUS_Object_t* Object_p,
+          const uint64_t* const  Generations_p,
+          const int              Period,
+          const int              Height,
+          const int              WordsPerRow,
+          CENSUS_Object_t*       Phases_p);
+
+static int
+GetPeriod(const CENSUS_Object_t* Phases_p, const int Period);
+
+static int
+IsIndependent(const CENSUS_Object_t* Phases_p, const int Period);
+
+static int
+GetCode(const CENSUS_Object_t* Phases_p,
+        const int              NumberOfPhases,
+        const char             Kind,
+        const int              Number,
+        char**                 Code_pp);
+
+static char*
+GetWechsler(const CENSUS_Object_t* Object_p, const int Transform);
+
+static char*
+AppendZeros(char* End_p, int NumberOfZeros);
+
+static void
+EvolveScratch(const uint64_t* Rows_p, uint64_t* NextRows_p);
+
+static int
+GetScratchBounds(const uint64_t* Rows_p, int* MinColumn_p, int* MinRow_p, int* MaxColumn_p, int* MaxRow_p);
+
+static void
+SearchSoups(void* Context_p, const int Task, const int ThreadIndex);
+
+static int
+SearchSoup(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, const uint64_t Seed);
+
+static int
+EvolveSoup(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, int* Level_p, const uint64_t Seed);
+
+static void*
+GetSoupWorld(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, const int Level);
+
+static int
+GrowSoupWorld(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, int* Level_p);
+
+static void
+EmptySoupWorld(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, void* World_p);
+
+static int
+FindPeriod(SoupSearch_t*  Search_p,
+           SoupWorker_t*  Worker_p,
+           void*          World_p,
+           const int      Size,
+           const STATS_t* Stats_p,
+           SoupBox_t*     Box_p,
+           int*           Evolved_p);
+
+static int
+RemoveSpaceships(SoupSearch_t*  Search_p,
+                 SoupWorker_t*  Worker_p,
+                 void*          World_p,
+                 const int      Size,
+                 const STATS_t* Stats_p);
+
+static int
+IsNearEdge(const STATS_t* Stats_p, const int Size);
+
+static void
+GetBox(const STATS_t* Stats_p, SoupBox_t* Box_p);
+
+static void
+PackBox(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, void* World_p, const SoupBox_t* Box_p, uint64_t* Rows_p);
+
+static void
+SetBoxRow(SoupSearch_t*         Search_p,
+          SoupWorker_t*         Worker_p,
+          void*                 World_p,
+          const SoupBox_t*      Box_p,
+          const int             Row,
+          const uint64_t* const Cells_p);
+
+
+void
+CENSUS_Initialize(CENSUS_Table_t* Table_p)
+{
+    memset(Table_p, 0, sizeof(*Table_p));
+}
+
+
+void
+CENSUS_Destroy(CENSUS_Table_t* Table_p)
+{
+    for (int i = 0; i < Table_p->Capacity; i++)
+    {
+        free(Table_p->Entries_p[i].Code_p);
+    }
+    free(Table_p->Entries_p);
+    CENSUS_Initialize(Table_p);
+}
+
+
+int
+CENSUS_Add(CENSUS_Table_t* Table_p, const char* const Code_p, const long long Count)
+{
+    int Slot;
+
+    if ((Table_p->NumberOfEntries + 1) * 2 > Table_p->Capacity && GrowTable(Table_p) != 0)
+    {
+        return -1;
+    }
+
+    Slot = (int)(HashCode(Code_p) & (Table_p->Capacity - 1));
+    while (Table_p->Entries_p[Slot].Code_p != NULL && strcmp(Table_p->Entries_p[Slot].Code_p, Code_p) != 0)
+    {
+        Slot = (Slot + 1) & (Table_p->Capacity - 1);
+    }
+
+    if (Table_p->Entries_p[Slot].Code_p == NULL)
+    {
+        if ((Table_p->Entries_p[Slot].Code_p = malloc(strlen(Code_p) + 1)) == NULL)
+        {
+            return -1;
+        }
+        strcpy(Table_p->Entries_p[Slot].Code_p, Code_p);
+        Table_p->NumberOfEntries++;
+    }
+    Table_p->Entries_p[Slot].Count += Count;
+    return 0;
+}
+
+
+int
+CENSUS_Merge(CENSUS_Table_t* Table_p, const CENSUS_Table_t* Source_p)
+{
+    for (int i = 0; i < Source_p->Capacity; i++)
+    {
+        if (Source_p->Entries_p[i].Code_p != NULL &&
+            CENSUS_Add(Table_p, Source_p->Entries_p[i].Code_p, Source_p->Entries_p[i].Count) != 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+CENSUS_Entry_t*
+CENSUS_Sort(const CENSUS_Table_t* Table_p)
+{
+    CENSUS_Entry_t* Entries_p = malloc((Table_p->NumberOfEntries + 1) * sizeof(CENSUS_Entry_t));
+    int NumberOfEntries = 0;
+
+    if (Entries_p == NULL)
+    {
+        return NULL;
+    }
+
+    for (int i = 0; i < Table_p->Capacity; i++)
+    {
+        if (Table_p->Entries_p[i].Code_p != NULL)
+        {
+            Entries_p[NumberOfEntries++] = Table_p->Entries_p[i];
+        }
+    }
+    qsort(Entries_p, NumberOfEntries, sizeof(CENSUS_Entry_t), CompareEntries);
+    return Entries_p;
+}
+
+
+int
+CENSUS_AddWorld(CENSUS_Table_t*       Table_p,
+                const uint64_t* const Generations_p,
+                const int             Period,
+                const int             Width,
+                const int             Height,
+                const int             WordsPerRow)
+{
+    const size_t WordsPerGeneration = (size_t)Height * WordsPerRow;
+    uint64_t* Union_p = malloc(WordsPerGeneration * sizeof(uint64_t));
+    int* Labels_p = malloc((size_t)Width * Height * sizeof(int));
+    CENSUS_Object_t* Phases_p = calloc(Period, sizeof(CENSUS_Object_t));
+    CENSUS_Object_t* Objects_p = NULL;
+    int* Groups_p = NULL;
+    int NumberOfObjects = 0;
+    CENSUS_Object_t Group = { NULL, 0, 0 };
+    int Merged = 1;
+    int Result = (Union_p != NULL && Labels_p != NULL && Phases_p != NULL) ? 0 : -1;
+
+    // Objects are made of the cells alive in any phase, so that the
+    // phases of an oscillator that fall apart still make one object
+    if (Result == 0)
+    {
+        memset(Labels_p, 0xFF, (size_t)Width * Height * sizeof(int));
+    }
+    for (size_t i = 0; i < WordsPerGeneration && Result == 0; i++)
+    {
+        Union_p[i] = Generations_p[i];
+        for (int t = 1; t < Period; t++)
+        {
+            Union_p[i] |= Generations_p[t * WordsPerGeneration + i];
+        }
+    }
+
+    for (size_t i = 0; i < WordsPerGeneration && Result == 0; i++)
+    {
+        while (Union_p[i] != 0 && Result == 0)
+        {
+            const int Row    = (int)(i / WordsPerRow);
+            const int Column = (int)(i % WordsPerRow) * 64 + __builtin_ctzll(Union_p[i]);
+            CENSUS_Object_t* NewObjects_p;
+
+            if ((NumberOfObjects & (NumberOfObjects - 1)) == 0)
+            {
+                // Grown at each power of 2
+                NewObjects_p = realloc(Objects_p, 2 * (NumberOfObjects + 1) * sizeof(CENSUS_Object_t));
+                if (NewObjects_p == NULL)
+                {
+                    Result = -1;
+                    break;
+                }
+                Objects_p = NewObjects_p;
+            }
+            memset(&Objects_p[NumberOfObjects], 0, sizeof(CENSUS_Object_t));
+            NumberOfObjects++;
+            Result = CENSUS_TakeObject(Union_p, Width, Height, WordsPerRow, Column, Row, 1,
+                                       &Objects_p[NumberOfObjects - 1]);
+        }
+    }
+
+    if (Result == 0 && (Groups_p = malloc((NumberOfObjects + 1) * sizeof(int))) == NULL)
+    {
+        Result = -1;
+    }
+    for (int o = 0; o < NumberOfObjects && Result == 0; o++)
+    {
+        Groups_p[o] = o;
+        for (int c = 0; c < Objects_p[o].NumberOfCells; c++)
+        {
+            Labels_p[(size_t)Objects_p[o].Cells_p[2 * c + 1] * Width + Objects_p[o].Cells_p[2 * c]] = o;
+        }
+    }
+
+    // Objects that do not evolve as they do in the world on their own, as
+    // the quarters of a pulsar, are merged with the objects close enough
+    // to touch them, until they all do
+    while (Merged && Result == 0)
+    {
+        Merged = 0;
+        for (int o = 0; o < NumberOfObjects && Result == 0; o++)
+        {
+            if (Groups_p[o] != o ||
+                (Result = GetGroup(Objects_p, NumberOfObjects, Groups_p, o, &Group)) != 0 ||
+                (Result = GetPhases(&Group, Generations_p, Period, Height, WordsPerRow, Phases_p)) != 0 ||
+                IsIndependent(Phases_p, Period))
+            {
+                continue;
+            }
+
+            for (int c = 0; c < Group.NumberOfCells; c++)
+            {
+                for (int y = Group.Cells_p[2 * c + 1] - 2; y <= Group.Cells_p[2 * c + 1] + 2; y++)
+                {
+                    for (int x = Group.Cells_p[2 * c] - 2; x <= Group.Cells_p[2 * c] + 2; x++)
+                    {
+                        int Other;
+
+                        if (x < 0 || y < 0 || x >= Width || y >= Height || Labels_p[(size_t)y * Width + x] < 0)
+                        {
+                            continue;
+                        }
+                        if ((Other = FindGroup(Groups_p, Labels_p[(size_t)y * Width + x])) != o)
+                        {
+                            Groups_p[Other] = o;
+                            Merged = 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (int o = 0; o < NumberOfObjects && Result == 0; o++)
+    {
+        int ObjectPeriod;
+        char* Code_p;
+
+        if (Groups_p[o] != o ||
+            (Result = GetGroup(Objects_p, NumberOfObjects, Groups_p, o, &Group)) != 0 ||
+            (Result = GetPhases(&Group, Generations_p, Period, Height, WordsPerRow, Phases_p)) != 0)
+        {
+            continue;
+        }
+
+        ObjectPeriod = GetPeriod(Phases_p, Period);
+        if (GetCode(Phases_p, ObjectPeriod, (ObjectPeriod == 1) ? 's' : 'p',
+                    (ObjectPeriod == 1) ? Phases_p[0].NumberOfCells : ObjectPeriod, &Code_p) != 0)
+        {
+            Result = -1;
+            break;
+        }
+        Result = CENSUS_Add(Table_p, Code_p, 1);
+        free(Code_p);
+    }
+
+    for (int t = 0; Phases_p != NULL && t < Period; t++)
+    {
+        CENSUS_FreeObject(&Phases_p[t]);
+    }
+    for (int o = 0; o < NumberOfObjects; o++)
+    {
+        CENSUS_FreeObject(&Objects_p[o]);
+    }
+    CENSUS_FreeObject(&Group);
+    free(Objects_p);
+    free(Groups_p);
+    free(Phases_p);
+    free(Labels_p);
+    free(Union_p);
+    return Result;
+}
+
+
+void
+CENSUS_FreeObject(CENSUS_Object_t* Object_p)
+{
+    free(Object_p->Cells_p);
+    Object_p->Cells_p       = NULL;
+    Object_p->NumberOfCells = 0;
+    Object_p->Capacity      = 0;
+}
+
+
+int
+CENSUS_TakeObject(uint64_t* const  Rows_p,
+                  const int        Width,
+                  const int        Height,
+                  const int        WordsPerRow,
+                  const int        Column,
+                  const int        Row,
+                  const int        Radius,
+                  CENSUS_Object_t* Object_p)
+{
+    // The cells found are the queue of cells to look around
+    Object_p->NumberOfCells = 0;
+    Rows_p[(size_t)Row * WordsPerRow + Column / 64] &= ~(1ULL << (Column % 64));
+    if (AddCell(Object_p, Column, Row) != 0)
+    {
+        return -1;
+    }
+
+    for (int c = 0; c < Object_p->NumberOfCells; c++)
+    {
+        const int x = Object_p->Cells_p[2 * c];
+        const int y = Object_p->Cells_p[2 * c + 1];
+
+        for (int j = y - Radius; j <= y + Radius; j++)
+        {
+            for (int i = x - Radius; i <= x + Radius; i++)
+            {
+                uint64_t* Word_p;
+
+                if (i < 0 || j < 0 || i >= Width || j >= Height)
+                {
+                    continue;
+                }
+                Word_p = &Rows_p[(size_t)j * WordsPerRow + i / 64];
+                if ((*Word_p >> (i % 64)) & 1)
+                {
+                    *Word_p &= ~(1ULL << (i % 64));
+                    if (AddCell(Object_p, i, j) != 0)
+                    {
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+
+int
+CENSUS_GetSpaceshipCode(const CENSUS_Object_t* Object_p, const int MaxPeriod, char** Code_pp)
+{
+    uint64_t* Generations_p;
+    CENSUS_Object_t* Phases_p;
+    int MinColumn = Object_p->Cells_p[0];
+    int MinRow    = Object_p->Cells_p[1];
+    int MaxColumn = MinColumn;
+    int MaxRow    = MinRow;
+    int Period    = 0;
+    int Result    = 0;
+
+    for (int c = 1; c < Object_p->NumberOfCells; c++)
+    {
+        const int x = Object_p->Cells_p[2 * c];
+        const int y = Object_p->Cells_p[2 * c + 1];
+
+        MinColumn = (x < MinColumn) ? x : MinColumn;
+        MaxColumn = (x > MaxColumn) ? x : MaxColumn;
+        MinRow    = (y < MinRow) ? y : MinRow;
+        MaxRow    = (y > MaxRow) ? y : MaxRow;
+    }
+    if (MaxColumn - MinColumn >= SCRATCH_SIZE - 2 * SCRATCH_MARGIN ||
+        MaxRow - MinRow >= SCRATCH_SIZE - 2 * SCRATCH_MARGIN)
+    {
+        return 0;
+    }
+
+    if ((Generations_p = calloc((size_t)(MaxPeriod + 1) * SCRATCH_SIZE, sizeof(uint64_t))) == NULL)
+    {
+        return -1;
+    }
+    for (int c = 0; c < Object_p->NumberOfCells; c++)
+    {
+        const int x = Object_p->Cells_p[2 * c] - MinColumn + SCRATCH_MARGIN;
+        const int y = Object_p->Cells_p[2 * c + 1] - MinRow + SCRATCH_MARGIN;
+
+        Generations_p[y] |= 1ULL << x;
+    }
+
+    // Until it comes back as it was, wherever it is
+    for (int t = 1; t <= MaxPeriod && Period == 0; t++)
+    {
+        const uint64_t* Rows_p = Generations_p + (size_t)t * SCRATCH_SIZE;
+        int Column;
+        int Row;
+        int LastColumn;
+        int LastRow;
+        int Same;
+
+        EvolveScratch(Rows_p - SCRATCH_SIZE, Generations_p + (size_t)t * SCRATCH_SIZE);
+        if (!GetScratchBounds(Rows_p, &Column, &Row, &LastColumn, &LastRow) ||
+            Column == 0 || Row == 0 || LastColumn == SCRATCH_SIZE - 1 || LastRow == SCRATCH_SIZE - 1)
+        {
+            break;
+        }
+
+        Same = (LastColumn - Column == MaxColumn - MinColumn && LastRow - Row == MaxRow - MinRow);
+        for (int r = 0; r <= LastRow - Row && Same; r++)
+        {
+            Same = ((Rows_p[Row + r] >> Column) == (Generations_p[SCRATCH_MARGIN + r] >> SCRATCH_MARGIN));
+        }
+        if (Same)
+        {
+            // Oscillators come back where they were
+            Period = (Column != SCRATCH_MARGIN || Row != SCRATCH_MARGIN) ? t : -1;
+        }
+    }
+
+    if (Period > 0)
+    {
+        Phases_p = calloc(Period, sizeof(CENSUS_Object_t));
+        Result = (Phases_p != NULL) ? 1 : -1;
+        for (int t = 0; t < Period && Result == 1; t++)
+        {
+            for (int y = 0; y < SCRATCH_SIZE && Result == 1; y++)
+            {
+                for (uint64_t Row = Generations_p[(size_t)t * SCRATCH_SIZE + y]; Row != 0 && Result == 1; Row &= Row - 1)
+                {
+                    Result = (AddCell(&Phases_p[t], __builtin_ctzll(Row), y) == 0) ? 1 : -1;
+                }
+            }
+        }
+        if (Result == 1 && GetCode(Phases_p, Period, 'q', Period, Code_pp) != 0)
+        {
+            Result = -1;
+        }
+        for (int t = 0; Phases_p != NULL && t < Period; t++)
+        {
+            CENSUS_FreeObject(&Phases_p[t]);
+        }
+        free(Phases_p);
+    }
+
+    free(Generations_p);
+    return Result;
+}
+
+
+/*
+ * Soups are shared out in tasks of SOUPS_PER_TASK, or more if there would
+ * be too many tasks, soup i drawn from Seed and i. Each worker evolves its soups one after the other in worlds of its
+ * own, single threaded, and keeps a census of its own, and the censuses
+ * are added up at the end.
+ */
+int
+CENSUS_SearchSoups(CENSUS_Table_t*            Table_p,
+                   const VARIANT_Ops_t* const Ops_p,
+                   const long long            NumberOfSoups,
+                   const uint64_t             Seed,
+                   THREADS_Pool_t*            Pool_p)
+{
+    const long long SoupsPerTask = (NumberOfSoups / SOUPS_PER_TASK >= INT_MAX) ?
+                                   NumberOfSoups / INT_MAX + 1 : SOUPS_PER_TASK;
+    const int NumberOfTasks   = (int)((NumberOfSoups + SoupsPerTask - 1) / SoupsPerTask);
+    const int NumberOfWorkers = THREADS_GetNumberOfThreads(Pool_p);
+    SoupSearch_t Search;
+    int Failed = 0;
+
+    Search.Ops_p         = Ops_p;
+    Search.Seed          = Seed;
+    Search.NumberOfSoups = NumberOfSoups;
+    Search.SoupsPerTask  = SoupsPerTask;
+    if ((Search.Workers_p = calloc(NumberOfWorkers, sizeof(SoupWorker_t))) == NULL)
+    {
+        return -1;
+    }
+    for (int i = 0; i < NumberOfWorkers; i++)
+    {
+        SoupWorker_t* Worker_p = &Search.Workers_p[i];
+
+        THREADS_CreatePool(&Worker_p->Pool, 1, 0);
+        CENSUS_Initialize(&Worker_p->Table);
+        Worker_p->Boxes_p = malloc((2 * (size_t)SOUP_MAX_WORDS + SOUP_MAX_WORLD_SIZE / 64) * sizeof(uint64_t));
+        Failed = Failed || (Worker_p->Boxes_p == NULL);
+    }
+
+    if (!Failed)
+    {
+        THREADS_RunTasks(Pool_p, NumberOfTasks, SearchSoups, &Search);
+    }
+
+    for (int i = 0; i < NumberOfWorkers; i++)
+    {
+        SoupWorker_t* Worker_p = &Search.Workers_p[i];
+
+        Failed = Failed || Worker_p->Failed || CENSUS_Merge(Table_p, &Worker_p->Table) != 0;
+        CENSUS_Destroy(&Worker_p->Table);
+        for (int Level = 0; Level < SOUP_NUMBER_OF_SIZES; Level++)
+        {
+            if (Worker_p->Worlds_p[Level] != NULL)
+            {
+                Ops_p->Destroy(Worker_p->Worlds_p[Level]);
+                free(Worker_p->Worlds_p[Level]);
+            }
+        }
+        free(Worker_p->Boxes_p);
+        free(Worker_p->Generations_p);
+        THREADS_DestroyPool(&Worker_p->Pool);
+    }
+    free(Search.Workers_p);
+    return Failed ? -1 : 0;
+}
+
+
+// FNV-1a
+static uint64_t
+HashCode(const char* Code_p)
+{
+    uint64_t Hash = 0xCBF29CE484222325ULL;
+
+    for (; *Code_p != '\0'; Code_p++)
+    {
+        Hash = (Hash ^ (unsigned char)*Code_p) * 0x100000001B3ULL;
+    }
+    return Hash;
+}
+
+
+static int
+GrowTable(CENSUS_Table_t* Table_p)
+{
+    CENSUS_Table_t Grown;
+
+    Grown.Capacity        = (Table_p->Capacity > 0) ? 2 * Table_p->Capacity : 64;
+    Grown.NumberOfEntries = 0;
+    if ((Grown.Entries_p = calloc(Grown.Capacity, sizeof(CENSUS_Entry_t))) == NULL)
+    {
+        return -1;
+    }
+
+    // The codes move over as they are
+    for (int i = 0; i < Table_p->Capacity; i++)
+    {
+        if (Table_p->Entries_p[i].Code_p != NULL)
+        {
+            int Slot = (int)(HashCode(Table_p->Entries_p[i].Code_p) & (Grown.Capacity - 1));
+
+            while (Grown.Entries_p[Slot].Code_p != NULL)
+            {
+                Slot = (Slot + 1) & (Grown.Capacity - 1);
+            }
+            Grown.Entries_p[Slot] = Table_p->Entries_p[i];
+            Grown.NumberOfEntries++;
+        }
+    }
+
+    free(Table_p->Entries_p);
+    *Table_p = Grown;
+    return 0;
+}
+
+
+// Most common first, then by code
+static int
+CompareEntries(const void* Entry1_p, const void* Entry2_p)
+{
+    const CENSUS_Entry_t* First_p  = (const CENSUS_Entry_t*)Entry1_p;
+    const CENSUS_Entry_t* Second_p = (const CENSUS_Entry_t*)Entry2_p;
+
+    if (First_p->Count != Second_p->Count)
+    {
+        return (First_p->Count > Second_p->Count) ? -1 : 1;
+    }
+    return strcmp(First_p->Code_p, Second_p->Code_p);
+}
+
+
+static int
+AddCell(CENSUS_Object_t* Object_p, const int Column, const int Row)
+{
+    if (Object_p->NumberOfCells == Object_p->Capacity)
+    {
+        const int Capacity = (Object_p->Capacity > 0) ? 2 * Object_p->Capacity : 64;
+        int* Cells_p = realloc(Object_p->Cells_p, 2 * Capacity * sizeof(int));
+
+        if (Cells_p == NULL)
+        {
+            return -1;
+        }
+        Object_p->Cells_p  = Cells_p;
+        Object_p->Capacity = Capacity;
+    }
+
+    Object_p->Cells_p[2 * Object_p->NumberOfCells]     = Column;
+    Object_p->Cells_p[2 * Object_p->NumberOfCells + 1] = Row;
+    Object_p->NumberOfCells++;
+    return 0;
+}
+
+// The object a group of objects was merged into
+static int
+FindGroup(int* Groups_p, int Object)
+{
+    while (Groups_p[Object] != Object)
+    {
+        Groups_p[Object] = Groups_p[Groups_p[Object]];
+        Object = Groups_p[Object];
+    }
+    return Object;
+}
+
+
+// The cells of all the objects merged into Root
+static int
+GetGroup(const CENSUS_Object_t* Objects_p,
+         const int              NumberOfObjects,
+         int*                   Groups_p,
+         const int              Root,
+         CENSUS_Object_t*       Group_p)
+{
+    Group_p->NumberOfCells = 0;
+    for (int o = 0; o < NumberOfObjects; o++)
+    {
+        if (FindGroup(Groups_p, o) != Root)
+        {
+            continue;
+        }
+        for (int c = 0; c < Objects_p[o].NumberOfCells; c++)
+        {
+            if (AddCell(Group_p, Objects_p[o].Cells_p[2 * c], Objects_p[o].Cells_p[2 * c + 1]) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+
+// The cells of the object alive in each generation of the period. The
+// phases list their cells in the same order, so equal phases are equal
+// lists.
+static int
+GetPhases(const CENSUS_Object_t* Object_p,
+          const uint64_t* const  Generations_p,
+          const int              Period,
+          const int              Height,
+          const int              WordsPerRow,
+          CENSUS_Object_t*       Phases_p)
+{
+    for (int t = 0; t < Period; t++)
+    {
+        const uint64_t* Rows_p = Generations_p + (size_t)t * Height * WordsPerRow;
+
+        Phases_p[t].NumberOfCells = 0;
+        for (int c = 0; c < Object_p->NumberOfCells; c++)
+        {
+            const int x = Object_p->Cells_p[2 * c];
+            const int y = Object_p->Cells_p[2 * c + 1];
+
+            if (((Rows_p[(size_t)y * WordsPerRow + x / 64] >> (x % 64)) & 1) && AddCell(&Phases_p[t], x, y) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+
+// The object's own period, which divides the world's
+static int
+GetPeriod(const CENSUS_Object_t* Phases_p, const int Period)
+{
+    for (int p = 1; p < Period; p++)
+    {
+        int Same = (Period % p == 0);
+
+        for (int t = 0; t < Period && Same; t++)
+        {
+            const CENSUS_Object_t* Phase1_p = &Phases_p[t];
+            const CENSUS_Object_t* Phase2_p = &Phases_p[(t + p) % Period];
+
+            Same = (Phase1_p->NumberOfCells == Phase2_p->NumberOfCells &&
+                    memcmp(Phase1_p->Cells_p, Phase2_p->Cells_p, 2 * Phase1_p->NumberOfCells * sizeof(int)) == 0);
+        }
+        if (Same)
+        {
+            return p;
+        }
+    }
+    return Period;
+}
+
+
+// Whether each phase of the object, evolved in the scratch world on its
+// own, gives the next. Objects too big for the scratch world are taken to.
+static int
+IsIndependent(const CENSUS_Object_t* Phases_p, const int Period)
+{
+    uint64_t Rows[2][SCRATCH_SIZE];
+    int MinColumn = -1;
+    int MinRow    = 0;
+    int MaxColumn = 0;
+    int MaxRow    = 0;
+
+    for (int t = 0; t < Period; t++)
+    {
+        for (int c = 0; c < Phases_p[t].NumberOfCells; c++)
+        {
+            const int x = Phases_p[t].Cells_p[2 * c];
+            const int y = Phases_p[t].Cells_p[2 * c + 1];
+
+            if (MinColumn < 0)
+            {
+                MinColumn = MaxColumn = x;
+                MinRow    = MaxRow    = y;
+            }
+            MinColumn = (x < MinColumn) ? x : MinColumn;
+            MaxColumn = (x > MaxColumn) ? x : MaxColumn;
+            MinRow    = (y < MinRow) ? y : MinRow;
+            MaxRow    = (y > MaxRow) ? y : MaxRow;
+        }
+    }
+    if (MinColumn < 0 || MaxColumn - MinColumn >= SCRATCH_SIZE - 2 || MaxRow - MinRow >= SCRATCH_SIZE - 2)
+    {
+        return 1;
+    }
+
+    for (int t = 0; t < Period; t++)
+    {
+        const CENSUS_Object_t* Next_p = &Phases_p[(t + 1) % Period];
+
+        memset(Rows, 0, sizeof(Rows));
+        for (int c = 0; c < Phases_p[t].NumberOfCells; c++)
+        {
+            Rows[0][Phases_p[t].Cells_p[2 * c + 1] - MinRow + 1] |= 1ULL << (Phases_p[t].Cells_p[2 * c] - MinColumn + 1);
+        }
+        EvolveScratch(Rows[0], Rows[1]);
+        for (int c = 0; c < Next_p->NumberOfCells; c++)
+        {
+            Rows[1][Next_p->Cells_p[2 * c + 1] - MinRow + 1] ^= 1ULL << (Next_p->Cells_p[2 * c] - MinColumn + 1);
+        }
+        for (int y = 0; y < SCRATCH_SIZE; y++)
+        {
+            if (Rows[1][y] != 0)
+            {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+
+// The apgcode x<Kind><Number>_<Wechsler code>, where the Wechsler code is
+// the shortest, then lowest, of all the phases and orientations
+static int
+GetCode(const CENSUS_Object_t* Phases_p,
+        const int              NumberOfPhases,
+        const char             Kind,
+        const int              Number,
+        char**                 Code_pp)
+{
+    char* Best_p = NULL;
+    size_t BestLength = 0;
+
+    for (int t = 0; t < NumberOfPhases; t++)
+    {
+        for (int Transform = 0; Transform < 8; Transform++)
+        {
+            char* Wechsler_p = GetWechsler(&Phases_p[t], Transform);
+            size_t Length;
+
+            if (Wechsler_p == NULL)
+            {
+                free(Best_p);
+                return -1;
+            }
+
+            Length = strlen(Wechsler_p);
+            if (Best_p == NULL || Length < BestLength || (Length == BestLength && strcmp(Wechsler_p, Best_p) < 0))
+            {
+                free(Best_p);
+                Best_p     = Wechsler_p;
+                BestLength = Length;
+            }
+            else
+            {
+                free(Wechsler_p);
+            }
+        }
+    }
+
+    if ((*Code_pp = malloc(BestLength + 16)) != NULL)
+    {
+        sprintf(*Code_pp, "x%c%d_%s", Kind, Number, Best_p);
+    }
+    free(Best_p);
+    return (*Code_pp != NULL) ? 0 : -1;
+}
+
+
+/*
+ * The extended Wechsler code of the object in one of its 8 orientations.
+ * Rows are taken 5 at a time, each strip of rows as one digit per column
+ * (bit r is row r of the strip), strips separated by 'z'. Columns of zeros
+ * are shortened ('w' is 2, 'x' 3 and 'y' and a digit 4 to 39 of them) and
+ * left out at the end of a strip.
+ */
+static char*
+GetWechsler(const CENSUS_Object_t* Object_p, const int Transform)
+{
+    int MinColumn = 0;
+    int MinRow    = 0;
+    int MaxColumn = 0;
+    int MaxRow    = 0;
+    int Width;
+    int NumberOfStrips;
+    unsigned char* Digits_p;
+    char* Wechsler_p;
+    char* End_p;
+
+    for (int Pass = 0; Pass < 2; Pass++)
+    {
+        for (int c = 0; c < Object_p->NumberOfCells; c++)
+        {
+            int x = Object_p->Cells_p[2 * c];
+            int y = Object_p->Cells_p[2 * c + 1];
+
+            // Bit 0 flips columns, bit 1 flips rows, bit 2 swaps them
+            if (Transform & 4)
+            {
+                const int Swap = x;
+
+                x = y;
+                y = Swap;
+            }
+            x = (Transform & 1) ? -x : x;
+            y = (Transform & 2) ? -y : y;
+
+            if (Pass == 0)
+            {
+                MinColumn = (c == 0 || x < MinColumn) ? x : MinColumn;
+                MinRow    = (c == 0 || y < MinRow) ? y : MinRow;
+                MaxColumn = (c == 0 || x > MaxColumn) ? x : MaxColumn;
+                MaxRow    = (c == 0 || y > MaxRow) ? y : MaxRow;
+            }
+            else
+            {
+                Digits_p[((y - MinRow) / 5) * Width + (x - MinColumn)] |= 1 << ((y - MinRow) % 5);
+            }
+        }
+
+        if (Pass == 0)
+        {
+            Width          = MaxColumn - MinColumn + 1;
+            NumberOfStrips = (MaxRow - MinRow) / 5 + 1;
+            if ((Digits_p = calloc((size_t)NumberOfStrips * Width, 1)) == NULL)
+            {
+                return NULL;
+            }
+        }
+    }
+
+    // No longer than a digit per column, and the 'z's
+    if ((Wechsler_p = malloc((size_t)NumberOfStrips * (Width + 1) + 1)) == NULL)
+    {
+        free(Digits_p);
+        return NULL;
+    }
+
+    End_p = Wechsler_p;
+    for (int s = 0; s < NumberOfStrips; s++)
+    {
+        int NumberOfZeros = 0;
+
+        if (s > 0)
+        {
+            *End_p++ = 'z';
+        }
+        for (int x = 0; x < Width; x++)
+        {
+            const int Digit = Digits_p[s * Width + x];
+
+            if (Digit == 0)
+            {
+                NumberOfZeros++;
+                continue;
+            }
+            End_p = AppendZeros(End_p, NumberOfZeros);
+            NumberOfZeros = 0;
+            *End_p++ = Digits[Digit];
+        }
+    }
+    *End_p = '\0';
+
+    free(Digits_p);
+    return Wechsler_p;
+}
+
+
+static char*
+AppendZeros(char* End_p, int NumberOfZeros)
+{
+    for (; NumberOfZeros >= 4; NumberOfZeros -= (NumberOfZeros < 39) ? NumberOfZeros : 39)
+    {
+        *End_p++ = 'y';
+        *End_p++ = Digits[((NumberOfZeros < 39) ? NumberOfZeros : 39) - 4];
+    }
+    switch (NumberOfZeros)
+    {
+    case 3:
+        *End_p++ = 'x';
+        break;
+
+    case 2:
+        *End_p++ = 'w';
+        break;
+
+    case 1:
+        *End_p++ = '0';
+        break;
+    }
+    return End_p;
+}
+
+
+// One generation of the scratch world, cells past its edges are dead
+static void
+EvolveScratch(const uint64_t* Rows_p, uint64_t* NextRows_p)
+{
+    for (int y = 0; y < SCRATCH_SIZE; y++)
+    {
+        const uint64_t Above = (y > 0) ? Rows_p[y - 1] : 0;
+        const uint64_t Row   = Rows_p[y];
+        const uint64_t Below = (y < SCRATCH_SIZE - 1) ? Rows_p[y + 1] : 0;
+        const uint64_t Neighbours[8] =
+        {
+            Above << 1, Above, Above >> 1, Row << 1, Row >> 1, Below << 1, Below, Below >> 1
+        };
+        uint64_t Sum0 = 0;
+        uint64_t Sum1 = 0;
+        uint64_t Sum2 = 0;
+
+        // The neighbour count modulo 8, bit by bit; 8 neighbours is dead
+        // either way
+        for (int n = 0; n < 8; n++)
+        {
+            const uint64_t Carry0 = Sum0 & Neighbours[n];
+            const uint64_t Carry1 = Sum1 & Carry0;
+
+            Sum0 ^= Neighbours[n];
+            Sum1 ^= Carry0;
+            Sum2 ^= Carry1;
+        }
+        NextRows_p[y] = ~Sum2 & Sum1 & (Sum0 | Row);
+    }
+}
+
+
+// Returns 0 if the scratch world is empty
+static int
+GetScratchBounds(const uint64_t* Rows_p, int* MinColumn_p, int* MinRow_p, int* MaxColumn_p, int* MaxRow_p)
+{
+    uint64_t Columns = 0;
+
+    *MinRow_p = -1;
+    for (int y = 0; y < SCRATCH_SIZE; y++)
+    {
+        if (Rows_p[y] != 0)
+        {
+            *MinRow_p = (*MinRow_p < 0) ? y : *MinRow_p;
+            *MaxRow_p = y;
+            Columns |= Rows_p[y];
+        }
+    }
+    if (Columns == 0)
+    {
+        return 0;
+    }
+
+    *MinColumn_p = __builtin_ctzll(Columns);
+    *MaxColumn_p = 63 - __builtin_clzll(Columns);
+    return 1;
+}
+
+
+// Searches the soups of one task, on the worker's own worlds
+static void
+SearchSoups(void* Context_p, const int Task, const int ThreadIndex)
+{
+    SoupSearch_t* Search_p = (SoupSearch_t*)Context_p;
+    SoupWorker_t* Worker_p = &Search_p->Workers_p[ThreadIndex];
+    const long long First = Task * Search_p->SoupsPerTask;
+    const long long End   = (First + Search_p->SoupsPerTask < Search_p->NumberOfSoups) ?
+                            First + Search_p->SoupsPerTask : Search_p->NumberOfSoups;
+
+    for (long long Soup = First; Soup < End && !Worker_p->Failed; Soup++)
+    {
+        if (SearchSoup(Search_p, Worker_p, Search_p->Seed + (uint64_t)Soup * 0x9E3779B97F4A7C15ULL) != 0)
+        {
+            Worker_p->Failed = 1;
+        }
+    }
+}
+
+
+// Evolves one soup, starting in the worker's smallest world, and leaves
+// the world it ends up in empty for the next one
+static int
+SearchSoup(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, const uint64_t Seed)
+{
+    int Level = 0;
+    int Result;
+
+    if (GetSoupWorld(Search_p, Worker_p, 0) == NULL)
+    {
+        return -1;
+    }
+    Result = EvolveSoup(Search_p, Worker_p, &Level, Seed);
+    EmptySoupWorld(Search_p, Worker_p, Worker_p->Worlds_p[Level]);
+    return Result;
+}
+
+
+/*
+ * Evolves the soup for Seed until it repeats, then adds what is left to the
+ * census. Soups are taken to have settled once their population has gone
+ * through the same values with some period for two periods, and the whole
+ * world then repeats. When anything but a spaceship nears the edges, the
+ * soup moves to the worker's world twice as large (*Level_p), and soups
+ * that outgrow SOUP_MAX_WORLD_SIZE are counted as zz_EDGE. Soups that do
+ * not settle are counted as zz_UNSTABLE. Returns 0, or -1 if out of memory.
+ */
+static int
+EvolveSoup(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, int* Level_p, const uint64_t Seed)
+{
+    const VARIANT_Ops_t* Ops_p = Search_p->Ops_p;
+    const int First = (SOUP_WORLD_SIZE - SOUP_SIZE) / 2;
+    uint64_t* Row_p = Worker_p->Boxes_p + 2 * (size_t)SOUP_MAX_WORDS;
+    CENSUS_Table_t* Table_p = &Worker_p->Table;
+    long long Populations[4 * SOUP_MAX_PERIOD];
+    int NumberOfPopulations = 0;
+    STATS_t Stats;
+
+    // The soup, in the middle of the smallest world, which is empty
+    for (int r = 0; r < SOUP_SIZE; r++)
+    {
+        uint64_t Cells;
+
+        memset(Row_p, 0, (SOUP_WORLD_SIZE / 64) * sizeof(uint64_t));
+        RANDOM_GetRow(&Cells, SOUP_SIZE, r, Seed, 0.5);
+        Row_p[First / 64] |= Cells << (First % 64);
+        if (First % 64 + SOUP_SIZE > 64)
+        {
+            Row_p[First / 64 + 1] |= Cells >> (64 - First % 64);
+        }
+        Ops_p->SetRow(Worker_p->Worlds_p[0], First + r, Row_p);
+    }
+    Ops_p->InvalidateStats(Worker_p->Worlds_p[0]);
+
+    for (int Generation = 0; Generation < SOUP_MAX_GENERATIONS; Generation++)
+    {
+        void* World_p  = Worker_p->Worlds_p[*Level_p];
+        const int Size = SOUP_WORLD_SIZE << *Level_p;
+        int Period = 0;
+
+        // The worlds are never seen outside the search, so nothing else
+        // holds their buffers, but evolving may still run out of memory
+        if (Ops_p->Evolve(World_p) != 0)
+        {
+            return -1;
+        }
+        Ops_p->GetStats(World_p, &Stats);
+        if (Stats.Population == 0)
+        {
+            return 0;
+        }
+
+        if (IsNearEdge(&Stats, Size))
+        {
+            switch (RemoveSpaceships(Search_p, Worker_p, World_p, Size, &Stats))
+            {
+            case 0:
+                break;
+
+            case 1:
+                if (*Level_p == SOUP_NUMBER_OF_SIZES - 1)
+                {
+                    return CENSUS_Add(Table_p, "zz_EDGE", 1);
+                }
+                if (GrowSoupWorld(Search_p, Worker_p, Level_p) != 0)
+                {
+                    return -1;
+                }
+                break;
+
+            default:
+                return -1;
+            }
+
+            // The population went down with the spaceships
+            NumberOfPopulations = 0;
+            continue;
+        }
+
+        Populations[NumberOfPopulations++ % (4 * SOUP_MAX_PERIOD)] = Stats.Population;
+        for (int p = 1; p <= SOUP_MAX_PERIOD && Period == 0 && 3 * p <= NumberOfPopulations; p++)
+        {
+            Period = p;
+            for (int i = 0; i < 2 * p && Period != 0; i++)
+            {
+                const int Last = NumberOfPopulations - 1 - i;
+
+                if (Populations[Last % (4 * SOUP_MAX_PERIOD)] != Populations[(Last - p) % (4 * SOUP_MAX_PERIOD)])
+                {
+                    Period = 0;
+                }
+            }
+        }
+
+        // A population that repeats is checked cell by cell
+        if (Period != 0)
+        {
+            SoupBox_t Box;
+            int Evolved;
+
+            Period = FindPeriod(Search_p, Worker_p, World_p, Size, &Stats, &Box, &Evolved);
+            if (Period > 0)
+            {
+                return CENSUS_AddWorld(Table_p, Worker_p->Generations_p, Period, (Box.EndWord - Box.FirstWord) * 64,
+                                       Box.EndRow - Box.FirstRow, Box.EndWord - Box.FirstWord);
+            }
+            if (Period < 0)
+            {
+                return -1;
+            }
+            Generation += Evolved;
+            NumberOfPopulations = 0;
+        }
+    }
+    return CENSUS_Add(Table_p, "zz_UNSTABLE", 1);
+}
+
+
+// Returns the worker's world of size SOUP_WORLD_SIZE << Level, made empty
+// if there was none yet, or NULL if out of memory
+static void*
+GetSoupWorld(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, const int Level)
+{
+    const VARIANT_Ops_t* Ops_p = Search_p->Ops_p;
+    const int Size = SOUP_WORLD_SIZE << Level;
+    void* World_p;
+
+    if (Worker_p->Worlds_p[Level] != NULL)
+    {
+        return Worker_p->Worlds_p[Level];
+    }
+
+    if ((World_p = malloc(Ops_p->GameSize)) == NULL)
+    {
+        return NULL;
+    }
+    if (Ops_p->Initialize(World_p, Size, Size, (Ops_p->Flags & VARIANT_ONLY_IN_PLACE) != 0, &Worker_p->Pool) != 0)
+    {
+        free(World_p);
+        return NULL;
+    }
+    Worker_p->Worlds_p[Level] = World_p;
+    return World_p;
+}
+
+
+/*
+ * Moves the soup to the middle of the worker's world twice as large, and
+ * leaves the one it was in empty. World sizes are multiples of 128, so the
+ * soup moves by whole words. Returns 0, or -1 if out of memory, with the
+ * soup left where it was.
+ */
+static int
+GrowSoupWorld(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, int* Level_p)
+{
+    const int Size = SOUP_WORLD_SIZE << *Level_p;
+    void* World_p  = Worker_p->Worlds_p[*Level_p];
+    uint64_t* Rows_p = Worker_p->Boxes_p;
+    void* Grown_p;
+    SoupBox_t Box;
+    SoupBox_t Moved;
+    STATS_t Stats;
+
+    if ((Grown_p = GetSoupWorld(Search_p, Worker_p, *Level_p + 1)) == NULL)
+    {
+        return -1;
+    }
+
+    Search_p->Ops_p->GetStats(World_p, &Stats);
+    GetBox(&Stats, &Box);
+    PackBox(Search_p, Worker_p, World_p, &Box, Rows_p);
+
+    Moved.FirstRow  = Box.FirstRow + Size / 2;
+    Moved.EndRow    = Box.EndRow + Size / 2;
+    Moved.FirstWord = Box.FirstWord + Size / 128;
+    Moved.EndWord   = Box.EndWord + Size / 128;
+    for (int r = 0; r < Box.EndRow - Box.FirstRow; r++)
+    {
+        SetBoxRow(Search_p, Worker_p, Grown_p, &Moved, r, Rows_p + (size_t)r * (Box.EndWord - Box.FirstWord));
+    }
+    Search_p->Ops_p->InvalidateStats(Grown_p);
+
+    EmptySoupWorld(Search_p, Worker_p, World_p);
+    (*Level_p)++;
+    return 0;
+}
+
+
+// Clears the rows that have live cells in them
+static void
+EmptySoupWorld(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, void* World_p)
+{
+    const VARIANT_Ops_t* Ops_p = Search_p->Ops_p;
+    uint64_t* Row_p = Worker_p->Boxes_p + 2 * (size_t)SOUP_MAX_WORDS;
+    STATS_t Stats;
+
+    Ops_p->GetStats(World_p, &Stats);
+    if (Stats.Population == 0)
+    {
+        return;
+    }
+
+    memset(Row_p, 0, (Ops_p->GetWidth(World_p) / 64) * sizeof(uint64_t));
+    for (int Row = Stats.MinRow; Row <= Stats.MaxRow; Row++)
+    {
+        Ops_p->SetRow(World_p, Row, Row_p);
+    }
+    Ops_p->InvalidateStats(World_p);
+}
+
+
+/*
+ * Returns the period of the world, or 0 if it does not repeat within
+ * SOUP_MAX_PERIOD generations or reaches the edges, or -1 if out of
+ * memory. Only the box of the live cells is packed and compared. Once the
+ * period is found, it is evolved again to pack each generation of it into
+ * the generations of the worker, in the box of all of them (*Box_p).
+ * Evolved_p is the generations made looking for it.
+ */
+static int
+FindPeriod(SoupSearch_t*  Search_p,
+           SoupWorker_t*  Worker_p,
+           void*          World_p,
+           const int      Size,
+           const STATS_t* Stats_p,
+           SoupBox_t*     Box_p,
+           int*           Evolved_p)
+{
+    const VARIANT_Ops_t* Ops_p = Search_p->Ops_p;
+    uint64_t* First_p = Worker_p->Boxes_p;
+    uint64_t* Rows_p  = Worker_p->Boxes_p + SOUP_MAX_WORDS;
+    size_t WordsPerGeneration;
+    SoupBox_t First;
+    SoupBox_t Box;
+    STATS_t Stats;
+    int Period = 0;
+
+    GetBox(Stats_p, &First);
+    PackBox(Search_p, Worker_p, World_p, &First, First_p);
+    *Box_p = First;
+
+    for (*Evolved_p = 1; *Evolved_p <= SOUP_MAX_PERIOD && Period == 0; (*Evolved_p)++)
+    {
+        if (Ops_p->Evolve(World_p) != 0)
+        {
+            return -1;
+        }
+        Ops_p->GetStats(World_p, &Stats);
+        if (Stats.Population == 0 || IsNearEdge(&Stats, Size))
+        {
+            return 0;
+        }
+
+        GetBox(&Stats, &Box);
+        if (memcmp(&Box, &First, sizeof(Box)) == 0)
+        {
+            PackBox(Search_p, Worker_p, World_p, &Box, Rows_p);
+            if (memcmp(Rows_p, First_p, (size_t)(Box.EndRow - Box.FirstRow) * (Box.EndWord - Box.FirstWord) *
+                                        sizeof(uint64_t)) == 0)
+            {
+                Period = *Evolved_p;
+                break;
+            }
+        }
+
+        Box_p->FirstRow  = (Box.FirstRow < Box_p->FirstRow) ? Box.FirstRow : Box_p->FirstRow;
+        Box_p->EndRow    = (Box.EndRow > Box_p->EndRow) ? Box.EndRow : Box_p->EndRow;
+        Box_p->FirstWord = (Box.FirstWord < Box_p->FirstWord) ? Box.FirstWord : Box_p->FirstWord;
+        Box_p->EndWord   = (Box.EndWord > Box_p->EndWord) ? Box.EndWord : Box_p->EndWord;
+    }
+    if (Period == 0)
+    {
+        return 0;
+    }
+
+    // The world is back where it started
+    WordsPerGeneration = (size_t)(Box_p->EndRow - Box_p->FirstRow) * (Box_p->EndWord - Box_p->FirstWord);
+    if (Period * WordsPerGeneration > Worker_p->GenerationsSize)
+    {
+        uint64_t* Generations_p = realloc(Worker_p->Generations_p, Period * WordsPerGeneration * sizeof(uint64_t));
+
+        if (Generations_p == NULL)
+        {
+            return -1;
+        }
+        Worker_p->Generations_p   = Generations_p;
+        Worker_p->GenerationsSize = Period * WordsPerGeneration;
+    }
+    for (int t = 0; t < Period; t++)
+    {
+        if (t > 0 && Ops_p->Evolve(World_p) != 0)
+        {
+            return -1;
+        }
+        PackBox(Search_p, Worker_p, World_p, Box_p, Worker_p->Generations_p + t * WordsPerGeneration);
+    }
+    return Period;
+}
+
+
+/*
+ * Takes the spaceships near the edges out of the world and counts them.
+ * Returns 0, 1 if something else is near the edges, or -1 if out of
+ * memory. Objects are taken out of a copy of the box of live cells, and
+ * their cells cleared in the world if they are spaceships. The others are
+ * only noted, so that every spaceship is gone before the world grows.
+ */
+static int
+RemoveSpaceships(SoupSearch_t*  Search_p,
+                 SoupWorker_t*  Worker_p,
+                 void*          World_p,
+                 const int      Size,
+                 const STATS_t* Stats_p)
+{
+    const int WordsPerRow = Size / 64;
+    uint64_t* Cells_p = Worker_p->Boxes_p;
+    uint64_t* Left_p  = Worker_p->Boxes_p + SOUP_MAX_WORDS;
+    CENSUS_Object_t Object = { NULL, 0, 0 };
+    SoupBox_t Box;
+    int BoxRows;
+    int BoxWords;
+    int FirstChanged;
+    int EndChanged = 0;
+    int NearEdge = 0;
+    int Result = 0;
+
+    GetBox(Stats_p, &Box);
+    BoxRows  = Box.EndRow - Box.FirstRow;
+    BoxWords = Box.EndWord - Box.FirstWord;
+    FirstChanged = BoxRows;
+    PackBox(Search_p, Worker_p, World_p, &Box, Cells_p);
+    memcpy(Left_p, Cells_p, (size_t)BoxRows * BoxWords * sizeof(uint64_t));
+
+    for (int r = 0; r < BoxRows && Result == 0; r++)
+    {
+        const int Row    = Box.FirstRow + r;
+        const int InBand = (Row < SOUP_BAND || Row >= Size - SOUP_BAND);
+
+        for (int i = 0; i < BoxWords && Result == 0; i++)
+        {
+            const int Word = Box.FirstWord + i;
+            const uint64_t* Word_p = &Left_p[(size_t)r * BoxWords + i];
+            uint64_t Mask = ~0ULL;
+
+            // Objects are only looked for from cells in the band
+            if (!InBand)
+            {
+                Mask = (Word == 0) ? (1ULL << SOUP_BAND) - 1 : 0;
+                Mask |= (Word == WordsPerRow - 1) ? ~(~0ULL >> SOUP_BAND) : 0;
+            }
+
+            while ((*Word_p & Mask) != 0 && Result == 0)
+            {
+                const int Column = i * 64 + __builtin_ctzll(*Word_p & Mask);
+                char* Code_p;
+
+                // Cells within 2 of each other still meet
+                if (CENSUS_TakeObject(Left_p, BoxWords * 64, BoxRows, BoxWords, Column, r, 2, &Object) != 0 ||
+                    (Result = CENSUS_GetSpaceshipCode(&Object, SOUP_MAX_PERIOD, &Code_p)) < 0)
+                {
+                    Result = -1;
+                    break;
+                }
+                if (Result == 0)
+                {
+                    NearEdge = 1;
+                    continue;
+                }
+
+                Result = (CENSUS_Add(&Worker_p->Table, Code_p, 1) == 0) ? 0 : -1;
+                free(Code_p);
+                for (int c = 0; c < Object.NumberOfCells; c++)
+                {
+                    const int x = Object.Cells_p[2 * c];
+                    const int y = Object.Cells_p[2 * c + 1];
+
+                    Cells_p[(size_t)y * BoxWords + x / 64] &= ~(1ULL << (x % 64));
+                    FirstChanged = (y < FirstChanged) ? y : FirstChanged;
+                    EndChanged   = (y + 1 > EndChanged) ? y + 1 : EndChanged;
+                }
+            }
+        }
+    }
+    CENSUS_FreeObject(&Object);
+
+    if (Result != 0)
+    {
+        return -1;
+    }
+
+    // Only the rows the spaceships were in are written back
+    for (int r = FirstChanged; r < EndChanged; r++)
+    {
+        SetBoxRow(Search_p, Worker_p, World_p, &Box, r, Cells_p + (size_t)r * BoxWords);
+    }
+    if (FirstChanged < EndChanged)
+    {
+        Search_p->Ops_p->InvalidateStats(World_p);
+    }
+    return NearEdge;
+}
+
+
+// Whether any cell is within SOUP_BAND cells of the edges of a soup world
+static int
+IsNearEdge(const STATS_t* Stats_p, const int Size)
+{
+    return Stats_p->Population > 0 &&
+           (Stats_p->MinColumn < SOUP_BAND || Stats_p->MinRow < SOUP_BAND ||
+            Stats_p->MaxColumn >= Size - SOUP_BAND || Stats_p->MaxRow >= Size - SOUP_BAND);
+}
+
+
+// The box of the live cells of a world that has some
+static void
+GetBox(const STATS_t* Stats_p, SoupBox_t* Box_p)
+{
+    Box_p->FirstRow  = Stats_p->MinRow;
+    Box_p->EndRow    = Stats_p->MaxRow + 1;
+    Box_p->FirstWord = Stats_p->MinColumn / 64;
+    Box_p->EndWord   = Stats_p->MaxColumn / 64 + 1;
+}
+
+
+// Packs the box of the world into Rows_p, one row of it after the other
+static void
+PackBox(SoupSearch_t* Search_p, SoupWorker_t* Worker_p, void* World_p, const SoupBox_t* Box_p, uint64_t* Rows_p)
+{
+    const int BoxWords = Box_p->EndWord - Box_p->FirstWord;
+    uint64_t* Row_p = Worker_p->Boxes_p + 2 * (size_t)SOUP_MAX_WORDS;
+
+    for (int r = 0; r < Box_p->EndRow - Box_p->FirstRow; r++)
+    {
+        Search_p->Ops_p->GetRow(World_p, Box_p->FirstRow + r, Row_p);
+        memcpy(Rows_p + (size_t)r * BoxWords, Row_p + Box_p->FirstWord, BoxWords * sizeof(uint64_t));
+    }
+}
+
+
+// Sets row Row of the box from Cells_p, and the rest of that row of the
+// world dead
+static void
+SetBoxRow(SoupSearch_t*         Search_p,
+          SoupWorker_t*         Worker_p,
+          void*                 World_p,
+          const SoupBox_t*      Box_p,
+          const int             Row,
+          const uint64_t* const Cells_p)
+{
+    uint64_t* Row_p = Worker_p->Boxes_p + 2 * (size_t)SOUP_MAX_WORDS;
+
+    memset(Row_p, 0, (Search_p->Ops_p->GetWidth(World_p) / 64) * sizeof(uint64_t));
+    memcpy(Row_p + Box_p->FirstWord, Cells_p, (Box_p->EndWord - Box_p->FirstWord) * sizeof(uint64_t));
+    Search_p->Ops_p->SetRow(World_p, Box_p->FirstRow + Row, Row_p);
+}
@@ -0,0 +1,140 @@
+/*
+ * Game of Life - CENSUS Support
+ *
+ * Tallies the objects left over once a world has settled down. The world
+ * is given as the packed generations of one period of it; the cells alive
+ * in any of them are split into objects, 8-connected, and each object is
+ * named by its apgcode: xs<cells> for still lifes, xp<period> for
+ * oscillators and xq<period> for spaceships, then an underscore and the
+ * extended Wechsler code of the object. The code is taken in each phase
+ * and each of the 8 rotations and reflections, and the shortest (then
+ * lowest) one is kept, so that every copy of an object gets the same name.
+ *
+ * Objects that touch are counted as one, as are pseudo still lifes. Objects
+ * that only evolve as they do next to others, as the quarters of a pulsar
+ * do, are merged with everything within 2 cells of them.
+ *
+ * Soup searches evolve random soups until they settle, and take the census
+ * of each. They drive the worlds through the variant operations directly,
+ * as the worlds are never seen outside the search.
+ */
+
+#ifndef GOL_CENSUS_H_
+#define GOL_CENSUS_H_
+
+#include <stdint.h>
+
+#include "gol_threads.h"
+#include "gol_variant.h"
+
+
+typedef struct
+{
+    char*     Code_p;       // NULL for free slots
+    long long Count;
+} CENSUS_Entry_t;
+
+
+// Objects by code, in an open addressing hash table
+typedef struct
+{
+    CENSUS_Entry_t* Entries_p;
+    int             Capacity;      // A power of 2
+    int             NumberOfEntries;
+} CENSUS_Table_t;
+
+
+// Cells as column, row pairs
+typedef struct
+{
+    int* Cells_p;
+    int  NumberOfCells;
+    int  Capacity;
+} CENSUS_Object_t;
+
+
+void
+CENSUS_Initialize(CENSUS_Table_t* Table_p);
+
+
+void
+CENSUS_Destroy(CENSUS_Table_t* Table_p);
+
+
+// Returns 0, or -1 if out of memory
+int
+CENSUS_Add(CENSUS_Table_t* Table_p, const char* const Code_p, const long long Count);
+
+
+// Returns 0, or -1 if out of memory
+int
+CENSUS_Merge(CENSUS_Table_t* Table_p, const CENSUS_Table_t* Source_p);
+
+
+// Returns the entries, most common first, in an array to be freed by the
+// caller (the codes stay in the table), or NULL if out of memory
+CENSUS_Entry_t*
+CENSUS_Sort(const CENSUS_Table_t* Table_p);
+
+
+/*
+ * Adds the objects of a world that repeats every Period generations.
+ * Generation t of the period is Height rows of WordsPerRow words at
+ * Generations_p + t * Height * WordsPerRow, bit c % 64 of word c / 64 is
+ * column c. Returns 0, or -1 if out of memory.
+ */
+int
+CENSUS_AddWorld(CENSUS_Table_t*       Table_p,
+                const uint64_t* const Generations_p,
+                const int             Period,
+                const int             Width,
+                const int             Height,
+                const int             WordsPerRow);
+
+
+void
+CENSUS_FreeObject(CENSUS_Object_t* Object_p);
+
+
+/*
+ * Takes the object with the cell at (Column, Row) out of the packed rows:
+ * all the cells that can be reached from it in steps of up to Radius
+ * cells across and down. Returns 0, or -1 if out of memory.
+ */
+int
+CENSUS_TakeObject(uint64_t* const  Rows_p,
+                  const int        Width,
+                  const int        Height,
+                  const int        WordsPerRow,
+                  const int        Column,
+                  const int        Row,
+                  const int        Radius,
+                  CENSUS_Object_t* Object_p);
+
+
+/*
+ * Evolves the object on its own for up to MaxPeriod generations. Returns 1
+ * and its xq apgcode in *Code_pp (to be freed by the caller) if it comes
+ * back moved, as a spaceship does, 0 if not, or -1 if out of memory.
+ * Objects over 48 cells across or down are never spaceships here.
+ */
+int
+CENSUS_GetSpaceshipCode(const CENSUS_Object_t* Object_p, const int MaxPeriod, char** Code_pp);
+
+
+/*
+ * Adds the objects left over by NumberOfSoups random soups to Table_p, see
+ * GOL_SearchSoups(). The soups are shared out among the workers of Pool_p,
+ * each evolving them in worlds of Ops_p of its own. Returns 0, or -1 if
+ * out of memory.
+ */
+int
+CENSUS_SearchSoups(CENSUS_Table_t*            Table_p,
+                   const VARIANT_Ops_t* const Ops_p,
+                   const long long            NumberOfSoups,
+                   const uint64_t             Seed,
+                   THREADS_Pool_t*            Pool_p);
+
+
+
+#endif // GOL_CENSUS_H_
@@ -0,0 +1,328 @@
+/*
+ * Game of Life - COMPARE Implementation
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gol_compare.h"
+
+
+static int
+StartEngine(COMPARE_Engine_t*    Engine_p,
+            const COMPARE_Step_t Step,
+            void* const          Context_p,
+            const int            NumberOfGenerations,
+            const int            QueueLength);
+
+static void
+StopEngine(COMPARE_Engine_t* Engine_p);
+
+static void*
+RunEngine(void* Context_p);
+
+static SNAPSHOT_t*
+TakeSnapshot(COMPARE_Engine_t* Engine_p);
+
+static void
+GetMovedRow(const COMPARE_World_t* World_p,
+            const int              y,
+            const int              FirstColumn,
+            uint64_t* const        Scratch_p,
+            uint64_t* const        Cells_p);
+
+static void
+GetRowOfSnapshot(void* Context_p, const int Row, uint64_t* const Cells_p);
+
+
+int
+COMPARE_Run(const COMPARE_Step_t Step,
+            void* const          Context1_p,
+            void* const          Context2_p,
+            const int            NumberOfGenerations,
+            const int            QueueLength,
+            long long* const     Generation_p,
+            int* const           Column_p,
+            int* const           Row_p)
+{
+    COMPARE_Engine_t Engine1;
+    COMPARE_Engine_t Engine2;
+    int Result = 0;
+
+    if (StartEngine(&Engine1, Step, Context1_p, NumberOfGenerations, QueueLength) != 0)
+    {
+        return -1;
+    }
+    if (StartEngine(&Engine2, Step, Context2_p, NumberOfGenerations, QueueLength) != 0)
+    {
+        StopEngine(&Engine1);
+        return -1;
+    }
+
+    for (int Generation = 1; Generation <= NumberOfGenerations && Result == 0; Generation++)
+    {
+        SNAPSHOT_t* Snapshot1_p = TakeSnapshot(&Engine1);
+        SNAPSHOT_t* Snapshot2_p = TakeSnapshot(&Engine2);
+
+        if (Snapshot1_p == NULL || Snapshot2_p == NULL)
+        {
+            Result = -1;
+        }
+        else if ((Result = COMPARE_Snapshots(Snapshot1_p, Snapshot2_p, Column_p, Row_p)) == 1)
+        {
+            *Generation_p = Generation;
+        }
+        SNAPSHOT_Release(Snapshot1_p);
+        SNAPSHOT_Release(Snapshot2_p);
+    }
+
+    StopEngine(&Engine1);
+    StopEngine(&Engine2);
+    return Result;
+}
+
+
+int
+COMPARE_Rows(const COMPARE_World_t* World1_p,
+             const COMPARE_World_t* World2_p,
+             int* const             Column_p,
+             int* const             Row_p)
+{
+    const int End1Column = World1_p->OriginColumn + World1_p->Width;
+    const int End2Column = World2_p->OriginColumn + World2_p->Width;
+    const int End1Row    = World1_p->OriginRow + World1_p->Height;
+    const int End2Row    = World2_p->OriginRow + World2_p->Height;
+    const int FirstColumn = (World1_p->OriginColumn < World2_p->OriginColumn) ? World1_p->OriginColumn : World2_p->OriginColumn;
+    const int FirstRow    = (World1_p->OriginRow < World2_p->OriginRow) ? World1_p->OriginRow : World2_p->OriginRow;
+    const int EndColumn   = (End1Column > End2Column) ? End1Column : End2Column;
+    const int EndRow      = (End1Row > End2Row) ? End1Row : End2Row;
+    const int MaxWidth    = (World1_p->Width > World2_p->Width) ? World1_p->Width : World2_p->Width;
+    const int NumberOfWords = (EndColumn - FirstColumn + 63) / 64;
+    uint64_t* Cells1_p;
+    uint64_t* Cells2_p;
+    uint64_t* Scratch_p;
+
+    if ((Cells1_p = malloc((2 * NumberOfWords + (MaxWidth + 63) / 64) * sizeof(uint64_t))) == NULL)
+    {
+        return -1;
+    }
+    Cells2_p = Cells1_p + NumberOfWords;
+    Scratch_p = Cells2_p + NumberOfWords;
+
+    for (int y = FirstRow; y < EndRow; y++)
+    {
+        memset(Cells1_p, 0, 2 * NumberOfWords * sizeof(uint64_t));
+        GetMovedRow(World1_p, y, FirstColumn, Scratch_p, Cells1_p);
+        GetMovedRow(World2_p, y, FirstColumn, Scratch_p, Cells2_p);
+
+        for (int i = 0; i < NumberOfWords; i++)
+        {
+            if (Cells1_p[i] != Cells2_p[i])
+            {
+                if (Column_p != NULL && Row_p != NULL)
+                {
+                    *Column_p = FirstColumn + i * 64 + __builtin_ctzll(Cells1_p[i] ^ Cells2_p[i]);
+                    *Row_p    = y;
+                }
+                free(Cells1_p);
+                return 1;
+            }
+        }
+    }
+
+    free(Cells1_p);
+    return 0;
+}
+
+
+int
+COMPARE_Snapshots(const SNAPSHOT_t* Snapshot1_p,
+                  const SNAPSHOT_t* Snapshot2_p,
+                  int* const        Column_p,
+                  int* const        Row_p)
+{
+    const COMPARE_World_t World1 =
+    {
+        Snapshot1_p->Width, Snapshot1_p->Height, Snapshot1_p->OriginColumn, Snapshot1_p->OriginRow,
+        GetRowOfSnapshot, (void*)Snapshot1_p
+    };
+    const COMPARE_World_t World2 =
+    {
+        Snapshot2_p->Width, Snapshot2_p->Height, Snapshot2_p->OriginColumn, Snapshot2_p->OriginRow,
+        GetRowOfSnapshot, (void*)Snapshot2_p
+    };
+
+    return COMPARE_Rows(&World1, &World2, Column_p, Row_p);
+}
+
+
+// ORs row y (relative to the origins) of a world into Cells_p, whose bit 0
+// is column FirstColumn, unpacking it into Scratch_p first. Rows outside
+// the world are left dead.
+static void
+GetMovedRow(const COMPARE_World_t* World_p,
+            const int              y,
+            const int              FirstColumn,
+            uint64_t* const        Scratch_p,
+            uint64_t* const        Cells_p)
+{
+    const int Row = y - World_p->OriginRow;
+    const int Offset = World_p->OriginColumn - FirstColumn;
+    const int NumberOfWords = (World_p->Width + 63) / 64;
+
+    if (Row < 0 || Row >= World_p->Height || World_p->Width == 0)
+    {
+        return;
+    }
+
+    World_p->GetRow(World_p->Context_p, Row, Scratch_p);
+    if (World_p->Width % 64 != 0)
+    {
+        Scratch_p[NumberOfWords - 1] &= (1ULL << (World_p->Width % 64)) - 1;
+    }
+
+    for (int i = 0; i < NumberOfWords; i++)
+    {
+        const int Word  = Offset / 64 + i;
+        const int Shift = Offset % 64;
+
+        Cells_p[Word] |= Scratch_p[i] << Shift;
+        if (Shift != 0 && (Scratch_p[i] >> (64 - Shift)) != 0)
+        {
+            Cells_p[Word + 1] |= Scratch_p[i] >> (64 - Shift);
+        }
+    }
+}
+
+
+static int
+StartEngine(COMPARE_Engine_t*    Engine_p,
+            const COMPARE_Step_t Step,
+            void* const          Context_p,
+            const int            NumberOfGenerations,
+            const int            QueueLength)
+{
+    memset(Engine_p, 0, sizeof(*Engine_p));
+    Engine_p->Step                = Step;
+    Engine_p->Context_p           = Context_p;
+    Engine_p->NumberOfGenerations = NumberOfGenerations;
+    Engine_p->QueueLength         = (QueueLength > 0) ? QueueLength : 1;
+    if ((Engine_p->Queue_p = malloc(Engine_p->QueueLength * sizeof(SNAPSHOT_t*))) == NULL)
+    {
+        return -1;
+    }
+
+    pthread_mutex_init(&Engine_p->Lock, NULL);
+    pthread_cond_init(&Engine_p->Added, NULL);
+    pthread_cond_init(&Engine_p->Taken, NULL);
+
+    if (pthread_create(&Engine_p->Thread, NULL, RunEngine, Engine_p) != 0)
+    {
+        pthread_mutex_destroy(&Engine_p->Lock);
+        pthread_cond_destroy(&Engine_p->Added);
+        pthread_cond_destroy(&Engine_p->Taken);
+        free(Engine_p->Queue_p);
+        return -1;
+    }
+    return 0;
+}
+
+
+// Waits for the world to finish the generation it is on, and lets go of
+// the snapshots it queued that were not compared
+static void
+StopEngine(COMPARE_Engine_t* Engine_p)
+{
+    pthread_mutex_lock(&Engine_p->Lock);
+    Engine_p->Stopping = 1;
+    pthread_cond_signal(&Engine_p->Taken);
+    pthread_mutex_unlock(&Engine_p->Lock);
+    pthread_join(Engine_p->Thread, NULL);
+
+    for (; Engine_p->Count > 0; Engine_p->Count--)
+    {
+        SNAPSHOT_Release(Engine_p->Queue_p[Engine_p->First]);
+        Engine_p->First = (Engine_p->First + 1) % Engine_p->QueueLength;
+    }
+
+    pthread_mutex_destroy(&Engine_p->Lock);
+    pthread_cond_destroy(&Engine_p->Added);
+    pthread_cond_destroy(&Engine_p->Taken);
+    free(Engine_p->Queue_p);
+}
+
+
+// The thread of one world. A NULL snapshot is queued too, and ends it, so
+// that the comparison never waits for good.
+static void*
+RunEngine(void* Context_p)
+{
+    COMPARE_Engine_t* Engine_p = (COMPARE_Engine_t*)Context_p;
+
+    for (int Generation = 0; Generation < Engine_p->NumberOfGenerations; Generation++)
+    {
+        SNAPSHOT_t* Snapshot_p;
+        int Stopping;
+
+        pthread_mutex_lock(&Engine_p->Lock);
+        Stopping = Engine_p->Stopping;
+        pthread_mutex_unlock(&Engine_p->Lock);
+        if (Stopping)
+        {
+            break;
+        }
+
+        Snapshot_p = Engine_p->Step(Engine_p->Context_p);
+
+        pthread_mutex_lock(&Engine_p->Lock);
+        while (Engine_p->Count == Engine_p->QueueLength && !Engine_p->Stopping)
+        {
+            pthread_cond_wait(&Engine_p->Taken, &Engine_p->Lock);
+        }
+        if (Engine_p->Stopping)
+        {
+            pthread_mutex_unlock(&Engine_p->Lock);
+            SNAPSHOT_Release(Snapshot_p);
+            break;
+        }
+        Engine_p->Queue_p[(Engine_p->First + Engine_p->Count) % Engine_p->QueueLength] = Snapshot_p;
+        Engine_p->Count++;
+        pthread_cond_signal(&Engine_p->Added);
+        pthread_mutex_unlock(&Engine_p->Lock);
+
+        if (Snapshot_p == NULL)
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+
+// Waits for the next generation of a world
+static SNAPSHOT_t*
+TakeSnapshot(COMPARE_Engine_t* Engine_p)
+{
+    SNAPSHOT_t* Snapshot_p;
+
+    pthread_mutex_lock(&Engine_p->Lock);
+    while (Engine_p->Count == 0)
+    {
+        pthread_cond_wait(&Engine_p->Added, &Engine_p->Lock);
+    }
+    Snapshot_p = Engine_p->Queue_p[Engine_p->First];
+    Engine_p->First = (Engine_p->First + 1) % Engine_p->QueueLength;
+    Engine_p->Count--;
+    pthread_cond_signal(&Engine_p->Taken);
+    pthread_mutex_unlock(&Engine_p->Lock);
+
+    return Snapshot_p;
+}
+
+
+static void
+GetRowOfSnapshot(void* Context_p, const int Row, uint64_t* const Cells_p)
+{
+    SNAPSHOT_GetRow((const SNAPSHOT_t*)Context_p, Row, Cells_p);
+}
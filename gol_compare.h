@@ -0,0 +1,101 @@
+/*
+ * Game of Life - COMPARE Support
+ *
+ * Evolves two worlds in lockstep and compares them generation by
+ * generation. Each world is evolved on a thread of its own, which queues a
+ * snapshot of every generation it makes. The calling thread takes the two
+ * snapshots of a generation and compares them while the worlds go on to
+ * the next ones. A full queue holds its world up, so neither gets more
+ * than the queue length ahead of the comparison.
+ */
+
+#ifndef GOL_COMPARE_H_
+#define GOL_COMPARE_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "gol_snapshot.h"
+
+
+// Unpacks one row of a world into Cells_p, one bit per cell
+typedef void (*COMPARE_GetRow_t)(void* Context_p, const int Row, uint64_t* const Cells_p);
+
+
+// A world to compare, row by row
+typedef struct
+{
+    int              Width;
+    int              Height;
+    int              OriginColumn;   // Of cell (0, 0), see GOL_GetWorldOrigin()
+    int              OriginRow;
+    COMPARE_GetRow_t GetRow;
+    void*            Context_p;
+} COMPARE_World_t;
+
+
+// Evolves a world one generation and returns a snapshot of it, holding a
+// reference, or NULL if memory runs out
+typedef SNAPSHOT_t* (*COMPARE_Step_t)(void* Context_p);
+
+
+typedef struct
+{
+    COMPARE_Step_t  Step;
+    void*           Context_p;
+    int             NumberOfGenerations;
+    pthread_t       Thread;
+    pthread_mutex_t Lock;
+    pthread_cond_t  Added;
+    pthread_cond_t  Taken;
+    SNAPSHOT_t**    Queue_p;         // A ring of QueueLength snapshots
+    int             QueueLength;
+    int             First;
+    int             Count;
+    int             Stopping;
+} COMPARE_Engine_t;
+
+
+/*
+ * Evolves both worlds NumberOfGenerations times with Step and compares
+ * every generation. Returns 0 if they are all the same, 1 if they differ,
+ * with the number of generations evolved up to the first that differs in
+ * *Generation_p and its first cell that differs, or -1 if memory runs out
+ * or a thread can not be started. Cells outside the smaller world are
+ * dead.
+ */
+int
+COMPARE_Run(const COMPARE_Step_t Step,
+            void* const          Context1_p,
+            void* const          Context2_p,
+            const int            NumberOfGenerations,
+            const int            QueueLength,
+            long long* const     Generation_p,
+            int* const           Column_p,
+            int* const           Row_p);
+
+
+/*
+ * Compares two worlds row by row, each moved by its origin, so that worlds
+ * that grew are compared where their cells are and not where they are
+ * stored. Cells outside a world are dead. Returns 0 if they hold the same
+ * cells, 1 and the first cell that differs, relative to the origins,
+ * (unless Column_p or Row_p is NULL) if not, -1 if memory runs out.
+ */
+int
+COMPARE_Rows(const COMPARE_World_t* World1_p,
+             const COMPARE_World_t* World2_p,
+             int* const             Column_p,
+             int* const             Row_p);
+
+
+// Compares the snapshots as COMPARE_Rows() does
+int
+COMPARE_Snapshots(const SNAPSHOT_t* Snapshot1_p,
+                  const SNAPSHOT_t* Snapshot2_p,
+                  int* const        Column_p,
+                  int* const        Row_p);
+
+
+
+#endif // GOL_COMPARE_H_
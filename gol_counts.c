@@ -0,0 +1,327 @@
+/*
+ * Game of Life - COUNTS Implementation
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "gol_counts.h"
+#include "gol_snapshot.h"
+
+
+static void
+CountAll(CountsGame_t* Game_p);
+
+static int
+ListCandidates(CountsGame_t* Game_p);
+
+static void
+ApplyChanges(CountsGame_t* Game_p);
+
+static void
+GetNeighbourOffsets(const CountsGame_t* Game_p, int* const Offsets_p);
+
+
+int
+COUNTS_InitializeWorld(CountsGame_t* Game_p,
+                       const int     Width,
+                       const int     Height)
+{
+    const size_t BytesPerRow = Width + 2;
+    const size_t NumberOfBytes = BytesPerRow * (Height + 2);
+
+    Game_p->Width  = Width;
+    Game_p->Height = Height;
+
+    Game_p->CurrentWorld_p = SNAPSHOT_AllocateBuffer(NumberOfBytes);
+    Game_p->Counts_p       = calloc(NumberOfBytes, 1);
+    Game_p->Marked_p       = malloc(NumberOfBytes);
+    Game_p->Changes_p      = malloc((size_t)Width * Height * sizeof(int));
+    Game_p->Candidates_p   = malloc((size_t)Width * Height * sizeof(int));
+    if (Game_p->CurrentWorld_p == NULL || Game_p->Counts_p == NULL || Game_p->Marked_p == NULL ||
+        Game_p->Changes_p == NULL || Game_p->Candidates_p == NULL)
+    {
+        COUNTS_DestroyWorld(Game_p);
+        return -1;
+    }
+    memset(Game_p->CurrentWorld_p, 0, NumberOfBytes);
+
+    // Halo cells look as if they were listed already, so they never are
+    memset(Game_p->Marked_p, 1, NumberOfBytes);
+    for (int Row = 1; Row <= Height; Row++)
+    {
+        memset(Game_p->Marked_p + Row * BytesPerRow + 1, 0, Width);
+    }
+
+    Game_p->NumberOfChanges = 0;
+    Game_p->StatsValid      = 0;
+    Game_p->CountAll        = 1;
+    return 0;
+}
+
+
+void
+COUNTS_DestroyWorld(CountsGame_t* Game_p)
+{
+    SNAPSHOT_ReleaseBuffer(Game_p->CurrentWorld_p);
+    free(Game_p->Counts_p);
+    free(Game_p->Marked_p);
+    free(Game_p->Changes_p);
+    free(Game_p->Candidates_p);
+}
+
+
+void
+COUNTS_SetCellStateInCurrent(CountsGame_t* Game_p,
+                             const int     Column,
+                             const int     Row,
+                             const int     State)
+{
+    int Pos = (1 + Row) * (Game_p->Width + 2) + (1 + Column);
+    *(Game_p->CurrentWorld_p + Pos) = State;
+    Game_p->StatsValid = 0;
+    Game_p->CountAll   = 1;
+}
+
+
+int
+COUNTS_GetCellState(CountsGame_t* Game_p,
+                    const int     Column,
+                    const int     Row)
+{
+    int Pos = (1 + Row) * (Game_p->Width + 2) + (1 + Column);
+    return *(Game_p->CurrentWorld_p + Pos);
+}
+
+
+int
+COUNTS_EvolveWorld(CountsGame_t* Game_p)
+{
+    // A snapshot still reading this generation keeps it to itself
+    if (SNAPSHOT_UnshareBuffer((void**)&Game_p->CurrentWorld_p, 1) < 0)
+    {
+        return -1;
+    }
+
+    if (Game_p->CountAll)
+    {
+        CountAll(Game_p);
+        Game_p->CountAll = 0;
+    }
+    else
+    {
+        const unsigned char* World_p  = Game_p->CurrentWorld_p;
+        const unsigned char* Counts_p = Game_p->Counts_p;
+        const int NumberOfCandidates = ListCandidates(Game_p);
+
+        // The counts are those of this generation until the changes are
+        // applied, so the new changes can be listed over the old ones
+        Game_p->NumberOfChanges = 0;
+        for (int i = 0; i < NumberOfCandidates; i++)
+        {
+            const int Pos = Game_p->Candidates_p[i];
+            const int Alive = (Counts_p[Pos] == 3) || (World_p[Pos] && Counts_p[Pos] == 2);
+
+            Game_p->Marked_p[Pos] = 0;
+            if (Alive != World_p[Pos])
+            {
+                Game_p->Changes_p[Game_p->NumberOfChanges++] = Pos;
+            }
+        }
+    }
+
+    ApplyChanges(Game_p);
+
+    // Still holds if nothing was born and nothing died
+    Game_p->StatsValid = Game_p->StatsValid && (Game_p->NumberOfChanges == 0);
+    return 0;
+}
+
+
+void
+COUNTS_GetStats(CountsGame_t* Game_p, STATS_t* Stats_p)
+{
+    if (!Game_p->StatsValid)
+    {
+        const size_t BytesPerRow = Game_p->Width + 2;
+
+        STATS_Reset(&Game_p->Stats);
+        for (int Row = 0; Row < Game_p->Height; Row++)
+        {
+            const unsigned char* Row_p = Game_p->CurrentWorld_p + (Row + 1) * BytesPerRow;
+            int Population = 0;
+            int MinColumn = 0;
+            int MaxColumn = 0;
+
+            for (int Column = 0; Column < Game_p->Width; Column++)
+            {
+                if (Row_p[1 + Column])
+                {
+                    MinColumn = (Population == 0) ? Column : MinColumn;
+                    MaxColumn = Column;
+                    Population++;
+                }
+            }
+            STATS_AddRow(&Game_p->Stats, Row, Population, MinColumn, MaxColumn);
+        }
+        Game_p->StatsValid = 1;
+    }
+    *Stats_p = Game_p->Stats;
+}
+
+
+void
+COUNTS_SetRowInCurrent(CountsGame_t*         Game_p,
+                       const int             Row,
+                       const uint64_t* const Cells_p)
+{
+    unsigned char* Row_p = Game_p->CurrentWorld_p + (size_t)(Row + 1) * (Game_p->Width + 2) + 1;
+
+    for (int Column = 0; Column < Game_p->Width; Column++)
+    {
+        Row_p[Column] = (Cells_p[Column / 64] >> (Column % 64)) & 1;
+    }
+}
+
+
+void
+COUNTS_StampRowInCurrent(CountsGame_t*         Game_p,
+                         const int             Row,
+                         const int             Column,
+                         const uint64_t* const Cells_p,
+                         const int             NumberOfColumns,
+                         const PATTERN_Mode_t  Mode)
+{
+    unsigned char* Row_p = Game_p->CurrentWorld_p + (size_t)(Row + 1) * (Game_p->Width + 2) + 1;
+    const int FirstColumn = (Column > 0) ? Column : 0;
+    const int EndColumn   = (Column + NumberOfColumns < Game_p->Width) ? Column + NumberOfColumns : Game_p->Width;
+
+    for (int i = FirstColumn; i < EndColumn; i++)
+    {
+        const int j = i - Column;
+
+        Row_p[i] = (unsigned char)PATTERN_Combine(Row_p[i], (Cells_p[j / 64] >> (j % 64)) & 1, 1, Mode);
+    }
+}
+
+
+void
+COUNTS_InvalidateStats(CountsGame_t* Game_p)
+{
+    Game_p->StatsValid = 0;
+    Game_p->CountAll   = 1;
+}
+
+
+int
+COUNTS_GetWorldWidth(CountsGame_t* Game_p)
+{
+    return Game_p->Width;
+}
+
+
+int
+COUNTS_GetWorldHeight(CountsGame_t* Game_p)
+{
+    return Game_p->Height;
+}
+
+
+// Works out every count from the cells, and lists every cell that changes
+static void
+CountAll(CountsGame_t* Game_p)
+{
+    const size_t BytesPerRow = Game_p->Width + 2;
+    const unsigned char* World_p = Game_p->CurrentWorld_p;
+    unsigned char* Counts_p = Game_p->Counts_p;
+
+    Game_p->NumberOfChanges = 0;
+    for (int Row = 1; Row <= Game_p->Height; Row++)
+    {
+        for (int Column = 1; Column <= Game_p->Width; Column++)
+        {
+            const size_t Pos = Row * BytesPerRow + Column;
+            const int Count = World_p[Pos - BytesPerRow - 1] + World_p[Pos - BytesPerRow] +
+                              World_p[Pos - BytesPerRow + 1] + World_p[Pos - 1] +
+                              World_p[Pos + 1] + World_p[Pos + BytesPerRow - 1] +
+                              World_p[Pos + BytesPerRow] + World_p[Pos + BytesPerRow + 1];
+            const int Alive = (Count == 3) || (World_p[Pos] && Count == 2);
+
+            Counts_p[Pos] = (unsigned char)Count;
+            if (Alive != World_p[Pos])
+            {
+                Game_p->Changes_p[Game_p->NumberOfChanges++] = (int)Pos;
+            }
+        }
+    }
+}
+
+
+// Only a cell that changed, or one of its neighbours, can change next.
+// Each is listed once, Marked_p is cleared again as they are evolved.
+static int
+ListCandidates(CountsGame_t* Game_p)
+{
+    int Offsets[8];
+    int NumberOfCandidates = 0;
+
+    GetNeighbourOffsets(Game_p, Offsets);
+    for (int i = 0; i < Game_p->NumberOfChanges; i++)
+    {
+        const int Pos = Game_p->Changes_p[i];
+
+        if (!Game_p->Marked_p[Pos])
+        {
+            Game_p->Marked_p[Pos] = 1;
+            Game_p->Candidates_p[NumberOfCandidates++] = Pos;
+        }
+        for (int n = 0; n < 8; n++)
+        {
+            if (!Game_p->Marked_p[Pos + Offsets[n]])
+            {
+                Game_p->Marked_p[Pos + Offsets[n]] = 1;
+                Game_p->Candidates_p[NumberOfCandidates++] = Pos + Offsets[n];
+            }
+        }
+    }
+    return NumberOfCandidates;
+}
+
+
+// Flips the listed cells and adds or takes one from their neighbours'
+// counts. Counts in the halo are kept too, but never read.
+static void
+ApplyChanges(CountsGame_t* Game_p)
+{
+    int Offsets[8];
+
+    GetNeighbourOffsets(Game_p, Offsets);
+    for (int i = 0; i < Game_p->NumberOfChanges; i++)
+    {
+        const int Pos = Game_p->Changes_p[i];
+        const unsigned char Delta = Game_p->CurrentWorld_p[Pos] ? (unsigned char)-1 : 1;
+
+        Game_p->CurrentWorld_p[Pos] ^= 1;
+        for (int n = 0; n < 8; n++)
+        {
+            Game_p->Counts_p[Pos + Offsets[n]] += Delta;
+        }
+    }
+}
+
+
+static void
+GetNeighbourOffsets(const CountsGame_t* Game_p, int* const Offsets_p)
+{
+    const int BytesPerRow = Game_p->Width + 2;
+
+    Offsets_p[0] = -BytesPerRow - 1;
+    Offsets_p[1] = -BytesPerRow;
+    Offsets_p[2] = -BytesPerRow + 1;
+    Offsets_p[3] = -1;
+    Offsets_p[4] = 1;
+    Offsets_p[5] = BytesPerRow - 1;
+    Offsets_p[6] = BytesPerRow;
+    Offsets_p[7] = BytesPerRow + 1;
+}
@@ -0,0 +1,105 @@
+/*
+ * Game of Life - COUNTS Variant
+ *
+ * Every cell keeps the number of its live neighbours next to its state,
+ * and a generation only looks at the cells around those that changed in
+ * the generation before. A birth or death adds or takes one from the
+ * counts of its eight neighbours, so the work done follows the activity
+ * in the world rather than its area.
+ */
+
+#ifndef GOL_COUNTS_H_
+#define GOL_COUNTS_H_
+
+#include <stdint.h>
+
+#include "gol_stats.h"
+#include "gol_pattern.h"
+
+
+typedef struct
+{
+    int            Width;
+    int            Height;
+    unsigned char* CurrentWorld_p;   // One byte per cell, laid out as for ARRAY
+    unsigned char* Counts_p;         // Live neighbours, laid out as CurrentWorld_p
+    unsigned char* Marked_p;         // Listed as a candidate, always set in the halo
+    int*           Changes_p;        // Cells that changed in the last evolve
+    int            NumberOfChanges;
+    int*           Candidates_p;     // Cells that may change in this evolve
+    STATS_t        Stats;            // Live cells in CurrentWorld_p
+    int            StatsValid;
+    int            CountAll;         // Set when CurrentWorld_p is changed directly
+} CountsGame_t;
+
+
+// The world is always evolved in place, as the counts are only right for
+// one generation. Returns 0, or -1 if out of memory, with nothing left
+// allocated.
+int
+COUNTS_InitializeWorld(CountsGame_t* Game_p,
+                       const int     Width,
+                       const int     Height);
+
+
+void
+COUNTS_DestroyWorld(CountsGame_t* Game_p);
+
+
+// Changes made directly have all the counts worked out again in the next
+// evolve, which then looks at every cell once
+void
+COUNTS_SetCellStateInCurrent(CountsGame_t* Game_p,
+                             const int     Column,
+                             const int     Row,
+                             const int     State);
+
+
+int
+COUNTS_GetCellState(CountsGame_t* Game_p,
+                    const int     Column,
+                    const int     Row);
+
+
+// Returns 0, or -1 if out of memory, with the world left as it was
+int
+COUNTS_EvolveWorld(CountsGame_t* Game_p);
+
+
+// The world is scanned when it changed since the stats were last asked for
+void
+COUNTS_GetStats(CountsGame_t* Game_p, STATS_t* Stats_p);
+
+
+// As ARRAY_SetRowInCurrent(), COUNTS_InvalidateStats() must be called after
+void
+COUNTS_SetRowInCurrent(CountsGame_t*         Game_p,
+                       const int             Row,
+                       const uint64_t* const Cells_p);
+
+
+// As ARRAY_StampRowInCurrent(), COUNTS_InvalidateStats() must be called after
+void
+COUNTS_StampRowInCurrent(CountsGame_t*         Game_p,
+                         const int             Row,
+                         const int             Column,
+                         const uint64_t* const Cells_p,
+                         const int             NumberOfColumns,
+                         const PATTERN_Mode_t  Mode);
+
+
+// Must be called after the current world is modified directly
+void
+COUNTS_InvalidateStats(CountsGame_t* Game_p);
+
+
+int
+COUNTS_GetWorldWidth(CountsGame_t* Game_p);
+
+
+int
+COUNTS_GetWorldHeight(CountsGame_t* Game_p);
+
+
+
+#endif // GOL_COUNTS_H_
@@ -0,0 +1,543 @@
+/*
+ * Game of Life - FRAMES Implementation
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "gol_frames.h"
+
+
+// Alive cells are black in every format
+#define PIXEL_ALIVE   0
+#define PIXEL_DEAD    255
+
+// GIF frames are shown for this many hundredths of a second
+#define GIF_DELAY     10
+
+// GIF codes: pixels are 0 (dead) and 1 (alive), which needs the smallest
+// code size GIF allows
+#define GIF_MIN_CODE_SIZE   2
+#define GIF_CLEAR_CODE      4
+#define GIF_END_CODE        5
+#define GIF_FIRST_CODE      6
+#define GIF_MAX_CODE        4095
+
+
+static void
+FreeRecorder(FRAMES_Recorder_t* Recorder_p);
+
+static void*
+EncodeFrames(void* Context_p);
+
+static int
+EncodeFrame(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p);
+
+static int
+WriteNetpbm(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p);
+
+static int
+WriteRaw(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p);
+
+static int
+WriteGifHeader(FRAMES_Recorder_t* Recorder_p);
+
+static int
+WriteGifImage(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p);
+
+static void
+PutGifCode(FRAMES_Recorder_t* Recorder_p, const int Code, const int CodeSize);
+
+static void
+PutGifByte(FRAMES_Recorder_t* Recorder_p, const unsigned char Byte);
+
+static int
+GetPixelRow(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p, const int Row, const int Width);
+
+static void
+PutUint16(FILE* File_p, const int Value);
+
+
+FRAMES_Recorder_t*
+FRAMES_Start(const char* const     Path_p,
+             const FRAMES_Format_t Format,
+             const int             QueueLength)
+{
+    FRAMES_Recorder_t* Recorder_p;
+
+    if ((Recorder_p = calloc(1, sizeof(FRAMES_Recorder_t))) == NULL)
+    {
+        return NULL;
+    }
+
+    Recorder_p->Format      = Format;
+    Recorder_p->QueueLength = (QueueLength > 0) ? QueueLength : 1;
+    Recorder_p->Path_p      = malloc(strlen(Path_p) + 1);
+    Recorder_p->Queue_p     = malloc(Recorder_p->QueueLength * sizeof(SNAPSHOT_t*));
+    if (Format == FRAMES_FORMAT_GIF)
+    {
+        Recorder_p->Codes_p = malloc((GIF_MAX_CODE + 1) * 2 * sizeof(uint16_t));
+    }
+
+    if (Recorder_p->Path_p == NULL || Recorder_p->Queue_p == NULL ||
+        (Format == FRAMES_FORMAT_GIF && Recorder_p->Codes_p == NULL))
+    {
+        FreeRecorder(Recorder_p);
+        return NULL;
+    }
+    strcpy(Recorder_p->Path_p, Path_p);
+
+    if ((Format == FRAMES_FORMAT_GIF || Format == FRAMES_FORMAT_RAW) &&
+        (Recorder_p->File_p = fopen(Path_p, "wb")) == NULL)
+    {
+        FreeRecorder(Recorder_p);
+        return NULL;
+    }
+
+    pthread_mutex_init(&Recorder_p->Lock, NULL);
+    pthread_cond_init(&Recorder_p->Added, NULL);
+    pthread_cond_init(&Recorder_p->Taken, NULL);
+
+    if (pthread_create(&Recorder_p->Encoder, NULL, EncodeFrames, Recorder_p) != 0)
+    {
+        pthread_mutex_destroy(&Recorder_p->Lock);
+        pthread_cond_destroy(&Recorder_p->Added);
+        pthread_cond_destroy(&Recorder_p->Taken);
+        if (Recorder_p->File_p != NULL)
+        {
+            fclose(Recorder_p->File_p);
+        }
+        FreeRecorder(Recorder_p);
+        return NULL;
+    }
+
+    return Recorder_p;
+}
+
+
+int
+FRAMES_Add(FRAMES_Recorder_t* Recorder_p, SNAPSHOT_t* Snapshot_p)
+{
+    int Failed;
+
+    pthread_mutex_lock(&Recorder_p->Lock);
+    while (Recorder_p->Count == Recorder_p->QueueLength)
+    {
+        pthread_cond_wait(&Recorder_p->Taken, &Recorder_p->Lock);
+    }
+    Recorder_p->Queue_p[(Recorder_p->First + Recorder_p->Count) % Recorder_p->QueueLength] = Snapshot_p;
+    Recorder_p->Count++;
+    Failed = Recorder_p->Failed;
+    pthread_cond_signal(&Recorder_p->Added);
+    pthread_mutex_unlock(&Recorder_p->Lock);
+
+    return Failed ? -1 : 0;
+}
+
+
+int
+FRAMES_Stop(FRAMES_Recorder_t* Recorder_p)
+{
+    int Failed;
+
+    pthread_mutex_lock(&Recorder_p->Lock);
+    Recorder_p->Stopping = 1;
+    pthread_cond_signal(&Recorder_p->Added);
+    pthread_mutex_unlock(&Recorder_p->Lock);
+    pthread_join(Recorder_p->Encoder, NULL);
+
+    Failed = Recorder_p->Failed;
+    if (Recorder_p->File_p != NULL)
+    {
+        // GIF trailer, only if a frame made the header
+        if (Recorder_p->Format == FRAMES_FORMAT_GIF && Recorder_p->Width > 0 && fputc(0x3B, Recorder_p->File_p) == EOF)
+        {
+            Failed = 1;
+        }
+        if (fclose(Recorder_p->File_p) != 0)
+        {
+            Failed = 1;
+        }
+    }
+
+    pthread_mutex_destroy(&Recorder_p->Lock);
+    pthread_cond_destroy(&Recorder_p->Added);
+    pthread_cond_destroy(&Recorder_p->Taken);
+    FreeRecorder(Recorder_p);
+
+    return Failed ? -1 : 0;
+}
+
+
+// Frees the memory of a recorder, which has no encoder thread or file
+static void
+FreeRecorder(FRAMES_Recorder_t* Recorder_p)
+{
+    free(Recorder_p->Path_p);
+    free(Recorder_p->Queue_p);
+    free(Recorder_p->Codes_p);
+    free(Recorder_p->Cells_p);
+    free(Recorder_p->Pixels_p);
+    free(Recorder_p);
+}
+
+
+// The encoder thread. Frames are still taken and released after a
+// failure, so that FRAMES_Add() never waits for good.
+static void*
+EncodeFrames(void* Context_p)
+{
+    FRAMES_Recorder_t* Recorder_p = (FRAMES_Recorder_t*)Context_p;
+
+    for (;;)
+    {
+        SNAPSHOT_t* Snapshot_p;
+        int Failed;
+
+        pthread_mutex_lock(&Recorder_p->Lock);
+        while (Recorder_p->Count == 0 && !Recorder_p->Stopping)
+        {
+            pthread_cond_wait(&Recorder_p->Added, &Recorder_p->Lock);
+        }
+        if (Recorder_p->Count == 0)
+        {
+            pthread_mutex_unlock(&Recorder_p->Lock);
+            break;
+        }
+        Snapshot_p = Recorder_p->Queue_p[Recorder_p->First];
+        Recorder_p->First = (Recorder_p->First + 1) % Recorder_p->QueueLength;
+        Recorder_p->Count--;
+        Failed = Recorder_p->Failed;
+        pthread_cond_signal(&Recorder_p->Taken);
+        pthread_mutex_unlock(&Recorder_p->Lock);
+
+        if (!Failed && EncodeFrame(Recorder_p, Snapshot_p) != 0)
+        {
+            pthread_mutex_lock(&Recorder_p->Lock);
+            Recorder_p->Failed = 1;
+            pthread_mutex_unlock(&Recorder_p->Lock);
+        }
+        SNAPSHOT_Release(Snapshot_p);
+    }
+    return NULL;
+}
+
+
+static int
+EncodeFrame(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p)
+{
+    // The first frame sets the size of single file recordings
+    if (Recorder_p->Width == 0)
+    {
+        Recorder_p->Width  = Snapshot_p->Width;
+        Recorder_p->Height = Snapshot_p->Height;
+        if (Recorder_p->Format == FRAMES_FORMAT_GIF)
+        {
+            // The screen size is 16 bits
+            Recorder_p->Width  = (Recorder_p->Width < 0xFFFF) ? Recorder_p->Width : 0xFFFF;
+            Recorder_p->Height = (Recorder_p->Height < 0xFFFF) ? Recorder_p->Height : 0xFFFF;
+            if (WriteGifHeader(Recorder_p) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    switch (Recorder_p->Format)
+    {
+    case FRAMES_FORMAT_PBM:
+    case FRAMES_FORMAT_PGM:
+        return WriteNetpbm(Recorder_p, Snapshot_p);
+    case FRAMES_FORMAT_GIF:
+        return WriteGifImage(Recorder_p, Snapshot_p);
+    case FRAMES_FORMAT_RAW:
+        return WriteRaw(Recorder_p, Snapshot_p);
+    default:
+        return -1;
+    }
+}
+
+
+// PBM packs eight cells per byte, first cell in the top bit, 1 is black
+static int
+WriteNetpbm(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p)
+{
+    const int Pbm = (Recorder_p->Format == FRAMES_FORMAT_PBM);
+    const int Width  = Snapshot_p->Width;
+    const int Height = Snapshot_p->Height;
+    char* Filename_p;
+    FILE* File_p;
+    int Result = 0;
+
+    if ((Filename_p = malloc(strlen(Recorder_p->Path_p) + 32)) == NULL)
+    {
+        return -1;
+    }
+    sprintf(Filename_p, "%s%06lld.%s", Recorder_p->Path_p, Snapshot_p->Generation, Pbm ? "pbm" : "pgm");
+    File_p = fopen(Filename_p, "wb");
+    free(Filename_p);
+    if (File_p == NULL)
+    {
+        return -1;
+    }
+
+    fprintf(File_p, Pbm ? "P4\n%d %d\n" : "P5\n%d %d\n255\n", Width, Height);
+    for (int Row = 0; Row < Height && Result == 0; Row++)
+    {
+        if (GetPixelRow(Recorder_p, Snapshot_p, Row, Width) != 0)
+        {
+            Result = -1;
+        }
+        else if (Pbm)
+        {
+            for (int Byte = 0; Byte < (Width + 7) / 8; Byte++)
+            {
+                int Value = 0;
+
+                for (int Bit = 0; Bit < 8; Bit++)
+                {
+                    const int Column = Byte * 8 + Bit;
+
+                    Value |= (Column < Width && Recorder_p->Pixels_p[Column] == PIXEL_ALIVE) << (7 - Bit);
+                }
+                fputc(Value, File_p);
+            }
+        }
+        else
+        {
+            fwrite(Recorder_p->Pixels_p, 1, Width, File_p);
+        }
+    }
+
+    if (ferror(File_p))
+    {
+        Result = -1;
+    }
+    if (fclose(File_p) != 0)
+    {
+        Result = -1;
+    }
+    return Result;
+}
+
+
+static int
+WriteRaw(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p)
+{
+    for (int Row = 0; Row < Recorder_p->Height; Row++)
+    {
+        if (GetPixelRow(Recorder_p, Snapshot_p, Row, Recorder_p->Width) != 0)
+        {
+            return -1;
+        }
+        fwrite(Recorder_p->Pixels_p, 1, Recorder_p->Width, Recorder_p->File_p);
+    }
+    return ferror(Recorder_p->File_p) ? -1 : 0;
+}
+
+
+// A two colour palette, and an application extension to loop for ever
+static int
+WriteGifHeader(FRAMES_Recorder_t* Recorder_p)
+{
+    FILE* File_p = Recorder_p->File_p;
+    static const unsigned char Palette[6] = { 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00 };
+    static const unsigned char Loop[19] = { 0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E',
+                                            '2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00 };
+
+    fwrite("GIF89a", 1, 6, File_p);
+    PutUint16(File_p, Recorder_p->Width);
+    PutUint16(File_p, Recorder_p->Height);
+    fputc(0x80, File_p);  // Global colour table of two entries
+    fputc(0, File_p);     // Background colour
+    fputc(0, File_p);     // Aspect ratio
+    fwrite(Palette, 1, sizeof(Palette), File_p);
+    fwrite(Loop, 1, sizeof(Loop), File_p);
+
+    return ferror(File_p) ? -1 : 0;
+}
+
+
+/*
+ * The image is LZW compressed as GIF wants it: codes grow by a bit each
+ * time the next free code no longer fits, and the table is cleared when
+ * it is full. Codes_p holds the code for each code followed by a pixel,
+ * 0 if there is none yet.
+ */
+static int
+WriteGifImage(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p)
+{
+    FILE* File_p = Recorder_p->File_p;
+    int CodeSize = GIF_MIN_CODE_SIZE + 1;
+    int NextCode = GIF_FIRST_CODE;
+    int Prefix = -1;
+
+    // Graphic control extension with the delay, then the image descriptor
+    fputc(0x21, File_p);
+    fputc(0xF9, File_p);
+    fputc(4, File_p);
+    fputc(0, File_p);
+    PutUint16(File_p, GIF_DELAY);
+    fputc(0, File_p);
+    fputc(0, File_p);
+    fputc(0x2C, File_p);
+    PutUint16(File_p, 0);
+    PutUint16(File_p, 0);
+    PutUint16(File_p, Recorder_p->Width);
+    PutUint16(File_p, Recorder_p->Height);
+    fputc(0, File_p);
+    fputc(GIF_MIN_CODE_SIZE, File_p);
+
+    Recorder_p->BlockLength  = 0;
+    Recorder_p->Bits         = 0;
+    Recorder_p->NumberOfBits = 0;
+    memset(Recorder_p->Codes_p, 0, (GIF_MAX_CODE + 1) * 2 * sizeof(uint16_t));
+    PutGifCode(Recorder_p, GIF_CLEAR_CODE, CodeSize);
+
+    for (int Row = 0; Row < Recorder_p->Height; Row++)
+    {
+        if (GetPixelRow(Recorder_p, Snapshot_p, Row, Recorder_p->Width) != 0)
+        {
+            return -1;
+        }
+        for (int Column = 0; Column < Recorder_p->Width; Column++)
+        {
+            const int Pixel = (Recorder_p->Pixels_p[Column] == PIXEL_ALIVE);
+            const int Code = (Prefix < 0) ? 0 : Recorder_p->Codes_p[Prefix * 2 + Pixel];
+
+            if (Prefix < 0)
+            {
+                Prefix = Pixel;
+            }
+            else if (Code != 0)
+            {
+                Prefix = Code;
+            }
+            else
+            {
+                PutGifCode(Recorder_p, Prefix, CodeSize);
+                if (NextCode >= (1 << CodeSize) && CodeSize < 12)
+                {
+                    CodeSize++;
+                }
+
+                if (NextCode >= GIF_MAX_CODE)
+                {
+                    PutGifCode(Recorder_p, GIF_CLEAR_CODE, CodeSize);
+                    CodeSize = GIF_MIN_CODE_SIZE + 1;
+                    NextCode = GIF_FIRST_CODE;
+                    memset(Recorder_p->Codes_p, 0, (GIF_MAX_CODE + 1) * 2 * sizeof(uint16_t));
+                }
+                else
+                {
+                    Recorder_p->Codes_p[Prefix * 2 + Pixel] = (uint16_t)NextCode++;
+                }
+                Prefix = Pixel;
+            }
+        }
+    }
+
+    if (Prefix >= 0)
+    {
+        PutGifCode(Recorder_p, Prefix, CodeSize);
+        if (NextCode >= (1 << CodeSize) && CodeSize < 12)
+        {
+            CodeSize++;
+        }
+    }
+    PutGifCode(Recorder_p, GIF_END_CODE, CodeSize);
+
+    // The last bits, the last sub-block and the block terminator
+    if (Recorder_p->NumberOfBits > 0)
+    {
+        PutGifByte(Recorder_p, (unsigned char)Recorder_p->Bits);
+    }
+    if (Recorder_p->BlockLength > 0)
+    {
+        fputc(Recorder_p->BlockLength, File_p);
+        fwrite(Recorder_p->Block, 1, Recorder_p->BlockLength, File_p);
+    }
+    fputc(0, File_p);
+
+    return ferror(File_p) ? -1 : 0;
+}
+
+
+// Codes are packed from the lowest bit up
+static void
+PutGifCode(FRAMES_Recorder_t* Recorder_p, const int Code, const int CodeSize)
+{
+    Recorder_p->Bits |= (uint32_t)Code << Recorder_p->NumberOfBits;
+    Recorder_p->NumberOfBits += CodeSize;
+    while (Recorder_p->NumberOfBits >= 8)
+    {
+        PutGifByte(Recorder_p, (unsigned char)Recorder_p->Bits);
+        Recorder_p->Bits >>= 8;
+        Recorder_p->NumberOfBits -= 8;
+    }
+}
+
+
+static void
+PutGifByte(FRAMES_Recorder_t* Recorder_p, const unsigned char Byte)
+{
+    Recorder_p->Block[Recorder_p->BlockLength++] = Byte;
+    if (Recorder_p->BlockLength == sizeof(Recorder_p->Block))
+    {
+        fputc(Recorder_p->BlockLength, Recorder_p->File_p);
+        fwrite(Recorder_p->Block, 1, Recorder_p->BlockLength, Recorder_p->File_p);
+        Recorder_p->BlockLength = 0;
+    }
+}
+
+
+// Fills Pixels_p with Width pixels of Row, dead outside the snapshot
+static int
+GetPixelRow(FRAMES_Recorder_t* Recorder_p, const SNAPSHOT_t* Snapshot_p, const int Row, const int Width)
+{
+    const int Columns = (Width > Snapshot_p->Width) ? Width : Snapshot_p->Width;
+
+    if (Columns > Recorder_p->RowCapacity)
+    {
+        uint64_t* Cells_p = realloc(Recorder_p->Cells_p, ((Columns + 63) / 64) * sizeof(uint64_t));
+        unsigned char* Pixels_p;
+
+        if (Cells_p == NULL)
+        {
+            return -1;
+        }
+        Recorder_p->Cells_p = Cells_p;
+        if ((Pixels_p = realloc(Recorder_p->Pixels_p, Columns)) == NULL)
+        {
+            return -1;
+        }
+        Recorder_p->Pixels_p = Pixels_p;
+        Recorder_p->RowCapacity = Columns;
+    }
+
+    if (Row >= Snapshot_p->Height)
+    {
+        memset(Recorder_p->Pixels_p, PIXEL_DEAD, Width);
+        return 0;
+    }
+
+    SNAPSHOT_GetRow(Snapshot_p, Row, Recorder_p->Cells_p);
+    for (int Column = 0; Column < Width; Column++)
+    {
+        const int Alive = (Column < Snapshot_p->Width) &&
+                          ((Recorder_p->Cells_p[Column / 64] >> (Column % 64)) & 1);
+
+        Recorder_p->Pixels_p[Column] = Alive ? PIXEL_ALIVE : PIXEL_DEAD;
+    }
+    return 0;
+}
+
+
+// Little endian, as GIF wants
+static void
+PutUint16(FILE* File_p, const int Value)
+{
+    fputc(Value & 0xFF, File_p);
+    fputc((Value >> 8) & 0xFF, File_p);
+}
@@ -0,0 +1,80 @@
+/*
+ * Game of Life - FRAMES Support
+ *
+ * Writes generations out as images, for looking at a run afterwards. The
+ * frames are snapshots, so the world is not copied to record it: frames
+ * are queued as they are added and encoded on a thread of their own, and
+ * the world goes on evolving meanwhile. Only a full queue holds it up.
+ */
+
+#ifndef GOL_FRAMES_H_
+#define GOL_FRAMES_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "gol_snapshot.h"
+
+
+typedef enum
+{
+    FRAMES_FORMAT_PBM,   // One file per frame, PATH000042.pbm
+    FRAMES_FORMAT_PGM,   // One file per frame, PATH000042.pgm
+    FRAMES_FORMAT_GIF,   // One animated GIF in PATH
+    FRAMES_FORMAT_RAW,   // 8-bit grey frames back to back in PATH
+
+    FRAMES_FORMAT_LAST_ENTRY
+} FRAMES_Format_t;
+
+
+typedef struct
+{
+    FRAMES_Format_t Format;
+    char*           Path_p;
+    FILE*           File_p;          // GIF and RAW
+    int             Width;           // GIF and RAW: of the first frame, which
+    int             Height;          // all the others are clipped or padded to
+    pthread_t       Encoder;
+    pthread_mutex_t Lock;
+    pthread_cond_t  Added;
+    pthread_cond_t  Taken;
+    SNAPSHOT_t**    Queue_p;         // A ring of QueueLength frames
+    int             QueueLength;
+    int             First;
+    int             Count;
+    int             Stopping;
+    int             Failed;          // A frame could not be written
+    uint64_t*       Cells_p;         // Encoder: one packed row
+    unsigned char*  Pixels_p;        // Encoder: one row of pixels
+    int             RowCapacity;     // Columns Cells_p and Pixels_p hold
+    uint16_t*       Codes_p;         // GIF: the LZW table, two codes per code
+    unsigned char   Block[255];      // GIF: the data sub-block being filled
+    int             BlockLength;
+    uint32_t        Bits;            // GIF: codes not yet whole bytes
+    int             NumberOfBits;
+} FRAMES_Recorder_t;
+
+
+// Returns NULL if the output can not be opened (errno tells why), memory
+// runs out or the encoder thread can not be started
+FRAMES_Recorder_t*
+FRAMES_Start(const char* const     Path_p,
+             const FRAMES_Format_t Format,
+             const int             QueueLength);
+
+
+// Takes over the reference to Snapshot_p and queues it, waiting while the
+// queue is full. Returns 0, or -1 once a frame could not be written.
+int
+FRAMES_Add(FRAMES_Recorder_t* Recorder_p, SNAPSHOT_t* Snapshot_p);
+
+
+// Writes the frames still queued and frees the recorder. Returns 0, or -1
+// if any frame could not be written.
+int
+FRAMES_Stop(FRAMES_Recorder_t* Recorder_p);
+
+
+
+#endif // GOL_FRAMES_H_
@@ -0,0 +1,382 @@
+/*
+ * Game of Life - HISTORY Implementation
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "gol_history.h"
+
+
+#define HISTORY_DEFAULT_KEYFRAME_INTERVAL   64
+
+
+static HISTORY_Segment_t*
+GetSegment(const HISTORY_t* History_p, const int Segment);
+
+static long long
+GetLastGeneration(const HISTORY_t* History_p);
+
+static void
+FreeSegment(HISTORY_Segment_t* Segment_p);
+
+static void
+DropNewerSegments(HISTORY_t* History_p, const int NumberOfSegments);
+
+static int
+ResizeBuffer(void** Buffer_pp, const size_t Size);
+
+static int
+AddKeyframe(HISTORY_t*             History_p,
+            const long long        Generation,
+            const int              Width,
+            const int              Height,
+            const int              OriginColumn,
+            const int              OriginRow,
+            const HISTORY_GetRow_t GetRow,
+            void*                  Context_p);
+
+static int
+AddDelta(HISTORY_t* History_p, const HISTORY_GetRow_t GetRow, void* Context_p);
+
+
+int
+HISTORY_Initialize(HISTORY_t* History_p, const int Length, const int KeyframeInterval)
+{
+    memset(History_p, 0, sizeof(*History_p));
+    if (Length <= 0)
+    {
+        return 0;
+    }
+
+    History_p->Length           = Length;
+    History_p->KeyframeInterval = (KeyframeInterval > 0) ? KeyframeInterval : HISTORY_DEFAULT_KEYFRAME_INTERVAL;
+    // Enough for Length generations, plus the newest segment filling up
+    History_p->MaxSegments      = Length / History_p->KeyframeInterval + 2;
+    History_p->Segments_p       = calloc(History_p->MaxSegments, sizeof(HISTORY_Segment_t));
+    if (History_p->Segments_p == NULL)
+    {
+        memset(History_p, 0, sizeof(*History_p));
+        return -1;
+    }
+    return 0;
+}
+
+
+void
+HISTORY_Destroy(HISTORY_t* History_p)
+{
+    DropNewerSegments(History_p, 0);
+    free(History_p->Segments_p);
+    free(History_p->Last_p);
+    free(History_p->Row_p);
+    free(History_p->ScratchIndex_p);
+    free(History_p->ScratchXor_p);
+    memset(History_p, 0, sizeof(*History_p));
+}
+
+
+int
+HISTORY_GetRange(const HISTORY_t* History_p, long long* const First_p, long long* const Last_p)
+{
+    if (History_p->NumberOfSegments == 0)
+    {
+        return -1;
+    }
+    *First_p = GetSegment(History_p, 0)->Generation;
+    *Last_p  = GetLastGeneration(History_p);
+    return 0;
+}
+
+
+int
+HISTORY_Record(HISTORY_t*             History_p,
+               const long long        Generation,
+               const int              Width,
+               const int              Height,
+               const int              OriginColumn,
+               const int              OriginRow,
+               const HISTORY_GetRow_t GetRow,
+               void*                  Context_p)
+{
+    HISTORY_Segment_t* Newest_p;
+    int Result;
+
+    if (History_p->Length <= 0)
+    {
+        return 0;
+    }
+
+    if (History_p->NumberOfSegments > 0 && Generation <= GetLastGeneration(History_p))
+    {
+        // Not a continuation, what is kept can not be reached from here
+        DropNewerSegments(History_p, 0);
+    }
+
+    Newest_p = (History_p->NumberOfSegments > 0) ?
+               GetSegment(History_p, History_p->NumberOfSegments - 1) : NULL;
+    if (Newest_p == NULL ||
+        Generation != GetLastGeneration(History_p) + 1 ||
+        Width != Newest_p->Width || Height != Newest_p->Height ||
+        OriginColumn != Newest_p->OriginColumn || OriginRow != Newest_p->OriginRow ||
+        Newest_p->NumberOfDeltas + 1 >= History_p->KeyframeInterval)
+    {
+        Result = AddKeyframe(History_p, Generation, Width, Height, OriginColumn, OriginRow, GetRow, Context_p);
+    }
+    else
+    {
+        Result = AddDelta(History_p, GetRow, Context_p);
+    }
+    if (Result != 0)
+    {
+        DropNewerSegments(History_p, 0);
+        return -1;
+    }
+
+    // Drop the oldest segment once the others keep enough on their own
+    while (History_p->NumberOfSegments > 1 &&
+           GetLastGeneration(History_p) - GetSegment(History_p, 1)->Generation + 1 >= History_p->Length)
+    {
+        FreeSegment(GetSegment(History_p, 0));
+        History_p->FirstSegment = (History_p->FirstSegment + 1) % History_p->MaxSegments;
+        History_p->NumberOfSegments--;
+    }
+    return 0;
+}
+
+
+int
+HISTORY_Seek(HISTORY_t*       History_p,
+             const long long  Generation,
+             const uint64_t** Cells_pp,
+             int* const       Width_p,
+             int* const       Height_p,
+             int* const       OriginColumn_p,
+             int* const       OriginRow_p)
+{
+    for (int i = 0; i < History_p->NumberOfSegments; i++)
+    {
+        HISTORY_Segment_t* Segment_p = GetSegment(History_p, i);
+        const size_t NumberOfWords = (size_t)((Segment_p->Width + 63) / 64) * Segment_p->Height;
+        const int NumberOfDeltas = (int)(Generation - Segment_p->Generation);
+
+        if (Generation < Segment_p->Generation || NumberOfDeltas > Segment_p->NumberOfDeltas)
+        {
+            continue;
+        }
+
+        // Last_p already has the size of the newest keyframe, which may
+        // differ. Recording goes on from this segment, with scratch space
+        // to match.
+        if (ResizeBuffer((void**)&History_p->Last_p, NumberOfWords * sizeof(uint64_t)) != 0 ||
+            ResizeBuffer((void**)&History_p->Row_p, ((Segment_p->Width + 63) / 64) * sizeof(uint64_t)) != 0 ||
+            ResizeBuffer((void**)&History_p->ScratchIndex_p, NumberOfWords * sizeof(uint32_t)) != 0 ||
+            ResizeBuffer((void**)&History_p->ScratchXor_p, NumberOfWords * sizeof(uint64_t)) != 0)
+        {
+            DropNewerSegments(History_p, 0);
+            return -1;
+        }
+        memcpy(History_p->Last_p, Segment_p->Keyframe_p, NumberOfWords * sizeof(uint64_t));
+        for (int d = 0; d < NumberOfDeltas; d++)
+        {
+            const HISTORY_Delta_t* Delta_p = &Segment_p->Deltas_p[d];
+            for (int w = 0; w < Delta_p->NumberOfWords; w++)
+            {
+                History_p->Last_p[Delta_p->Index_p[w]] ^= Delta_p->Xor_p[w];
+            }
+        }
+
+        for (int d = NumberOfDeltas; d < Segment_p->NumberOfDeltas; d++)
+        {
+            free(Segment_p->Deltas_p[d].Index_p);
+            free(Segment_p->Deltas_p[d].Xor_p);
+        }
+        Segment_p->NumberOfDeltas = NumberOfDeltas;
+        DropNewerSegments(History_p, i + 1);
+
+        *Cells_pp       = History_p->Last_p;
+        *Width_p        = Segment_p->Width;
+        *Height_p       = Segment_p->Height;
+        *OriginColumn_p = Segment_p->OriginColumn;
+        *OriginRow_p    = Segment_p->OriginRow;
+        return 0;
+    }
+    return 1;
+}
+
+
+static HISTORY_Segment_t*
+GetSegment(const HISTORY_t* History_p, const int Segment)
+{
+    return &History_p->Segments_p[(History_p->FirstSegment + Segment) % History_p->MaxSegments];
+}
+
+
+static long long
+GetLastGeneration(const HISTORY_t* History_p)
+{
+    const HISTORY_Segment_t* Newest_p = GetSegment(History_p, History_p->NumberOfSegments - 1);
+    return Newest_p->Generation + Newest_p->NumberOfDeltas;
+}
+
+
+static void
+FreeSegment(HISTORY_Segment_t* Segment_p)
+{
+    for (int d = 0; d < Segment_p->NumberOfDeltas; d++)
+    {
+        free(Segment_p->Deltas_p[d].Index_p);
+        free(Segment_p->Deltas_p[d].Xor_p);
+    }
+    free(Segment_p->Deltas_p);
+    free(Segment_p->Keyframe_p);
+    memset(Segment_p, 0, sizeof(*Segment_p));
+}
+
+
+// Keeps the NumberOfSegments oldest segments
+static void
+DropNewerSegments(HISTORY_t* History_p, const int NumberOfSegments)
+{
+    while (History_p->NumberOfSegments > NumberOfSegments)
+    {
+        FreeSegment(GetSegment(History_p, History_p->NumberOfSegments - 1));
+        History_p->NumberOfSegments--;
+    }
+    if (History_p->NumberOfSegments == 0)
+    {
+        History_p->FirstSegment = 0;
+    }
+}
+
+
+// Reallocates the buffer to Size bytes, or frees it for 0. Returns -1 if
+// out of memory, with the buffer as it was.
+static int
+ResizeBuffer(void** Buffer_pp, const size_t Size)
+{
+    void* Buffer_p;
+
+    if (Size == 0)
+    {
+        free(*Buffer_pp);
+        *Buffer_pp = NULL;
+        return 0;
+    }
+    if ((Buffer_p = realloc(*Buffer_pp, Size)) == NULL)
+    {
+        return -1;
+    }
+    *Buffer_pp = Buffer_p;
+    return 0;
+}
+
+
+static int
+AddKeyframe(HISTORY_t*             History_p,
+            const long long        Generation,
+            const int              Width,
+            const int              Height,
+            const int              OriginColumn,
+            const int              OriginRow,
+            const HISTORY_GetRow_t GetRow,
+            void*                  Context_p)
+{
+    const int WordsPerRow = (Width + 63) / 64;
+    const size_t NumberOfWords = (size_t)WordsPerRow * Height;
+    HISTORY_Segment_t* Segment_p;
+    uint64_t* Keyframe_p;
+    HISTORY_Delta_t* Deltas_p = NULL;
+
+    if (ResizeBuffer((void**)&History_p->Last_p, NumberOfWords * sizeof(uint64_t)) != 0 ||
+        ResizeBuffer((void**)&History_p->Row_p, WordsPerRow * sizeof(uint64_t)) != 0 ||
+        ResizeBuffer((void**)&History_p->ScratchIndex_p, NumberOfWords * sizeof(uint32_t)) != 0 ||
+        ResizeBuffer((void**)&History_p->ScratchXor_p, NumberOfWords * sizeof(uint64_t)) != 0 ||
+        (Keyframe_p = malloc(NumberOfWords * sizeof(uint64_t))) == NULL)
+    {
+        return -1;
+    }
+
+    // Keyframes every generation have no deltas in between
+    if (History_p->KeyframeInterval > 1 &&
+        (Deltas_p = malloc((History_p->KeyframeInterval - 1) * sizeof(HISTORY_Delta_t))) == NULL)
+    {
+        free(Keyframe_p);
+        return -1;
+    }
+
+    if (History_p->NumberOfSegments == History_p->MaxSegments)
+    {
+        // Only when resizes cut segments short, keep memory bounded anyway
+        FreeSegment(GetSegment(History_p, 0));
+        History_p->FirstSegment = (History_p->FirstSegment + 1) % History_p->MaxSegments;
+        History_p->NumberOfSegments--;
+    }
+
+    Segment_p = GetSegment(History_p, History_p->NumberOfSegments);
+    History_p->NumberOfSegments++;
+
+    Segment_p->Generation     = Generation;
+    Segment_p->Width          = Width;
+    Segment_p->Height         = Height;
+    Segment_p->OriginColumn   = OriginColumn;
+    Segment_p->OriginRow      = OriginRow;
+    Segment_p->Keyframe_p     = Keyframe_p;
+    Segment_p->NumberOfDeltas = 0;
+    Segment_p->Deltas_p       = Deltas_p;
+
+    for (int Row = 0; Row < Height; Row++)
+    {
+        GetRow(Context_p, Row, Segment_p->Keyframe_p + (size_t)Row * WordsPerRow);
+    }
+    memcpy(History_p->Last_p, Segment_p->Keyframe_p, NumberOfWords * sizeof(uint64_t));
+    return 0;
+}
+
+
+static int
+AddDelta(HISTORY_t* History_p, const HISTORY_GetRow_t GetRow, void* Context_p)
+{
+    HISTORY_Segment_t* Segment_p = GetSegment(History_p, History_p->NumberOfSegments - 1);
+    HISTORY_Delta_t* Delta_p = &Segment_p->Deltas_p[Segment_p->NumberOfDeltas];
+    const int WordsPerRow = (Segment_p->Width + 63) / 64;
+    int NumberOfWords = 0;
+
+    for (int Row = 0; Row < Segment_p->Height; Row++)
+    {
+        uint64_t* Last_p = History_p->Last_p + (size_t)Row * WordsPerRow;
+
+        GetRow(Context_p, Row, History_p->Row_p);
+        for (int i = 0; i < WordsPerRow; i++)
+        {
+            const uint64_t Xor = History_p->Row_p[i] ^ Last_p[i];
+            if (Xor != 0)
+            {
+                History_p->ScratchIndex_p[NumberOfWords] = (uint32_t)(Row * WordsPerRow + i);
+                History_p->ScratchXor_p[NumberOfWords]   = Xor;
+                NumberOfWords++;
+                Last_p[i] = History_p->Row_p[i];
+            }
+        }
+    }
+
+    // Generations that change nothing keep no words at all
+    Delta_p->NumberOfWords = NumberOfWords;
+    Delta_p->Index_p       = NULL;
+    Delta_p->Xor_p         = NULL;
+    if (NumberOfWords > 0)
+    {
+        Delta_p->Index_p = malloc(NumberOfWords * sizeof(uint32_t));
+        Delta_p->Xor_p   = malloc(NumberOfWords * sizeof(uint64_t));
+        if (Delta_p->Index_p == NULL || Delta_p->Xor_p == NULL)
+        {
+            free(Delta_p->Index_p);
+            free(Delta_p->Xor_p);
+            return -1;
+        }
+        memcpy(Delta_p->Index_p, History_p->ScratchIndex_p, NumberOfWords * sizeof(uint32_t));
+        memcpy(Delta_p->Xor_p, History_p->ScratchXor_p, NumberOfWords * sizeof(uint64_t));
+    }
+    Segment_p->NumberOfDeltas++;
+    return 0;
+}
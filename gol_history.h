@@ -0,0 +1,106 @@
+/*
+ * Game of Life - HISTORY Support
+ *
+ * A bounded record of past generations. Every KeyframeInterval generations
+ * the whole world is kept, packed one bit per cell, and each generation in
+ * between is kept as the words that changed since the one before: their
+ * index and their XOR. Worlds that settle down cost little more than
+ * their keyframes. Old keyframes and their deltas are dropped once more
+ * than Length generations are kept.
+ */
+
+#ifndef GOL_HISTORY_H_
+#define GOL_HISTORY_H_
+
+#include <stdint.h>
+
+
+// Packs row Row of the world being recorded, bit c % 64 of word c / 64
+// is column c
+typedef void (*HISTORY_GetRow_t)(void* Context_p, const int Row, uint64_t* const Cells_p);
+
+
+typedef struct
+{
+    int       NumberOfWords;
+    uint32_t* Index_p;     // Word index in the packed world
+    uint64_t* Xor_p;       // Changed bits of that word
+} HISTORY_Delta_t;
+
+
+typedef struct
+{
+    long long        Generation;      // Of the keyframe
+    int              Width;
+    int              Height;
+    int              OriginColumn;
+    int              OriginRow;
+    uint64_t*        Keyframe_p;
+    int              NumberOfDeltas;  // Delta i takes generation + i to + i + 1
+    HISTORY_Delta_t* Deltas_p;
+} HISTORY_Segment_t;
+
+
+typedef struct
+{
+    int                Length;             // 0 when disabled
+    int                KeyframeInterval;
+    int                MaxSegments;
+    int                FirstSegment;       // A ring of segments, oldest first
+    int                NumberOfSegments;
+    HISTORY_Segment_t* Segments_p;
+    uint64_t*          Last_p;             // The newest generation kept, unpacked
+    uint64_t*          Row_p;
+    uint32_t*          ScratchIndex_p;     // Delta being built
+    uint64_t*          ScratchXor_p;
+} HISTORY_t;
+
+
+// Returns 0, or -1 if out of memory
+int
+HISTORY_Initialize(HISTORY_t* History_p, const int Length, const int KeyframeInterval);
+
+
+void
+HISTORY_Destroy(HISTORY_t* History_p);
+
+
+// Returns 0 and the first and last generations kept, -1 if none are
+int
+HISTORY_GetRange(const HISTORY_t* History_p, long long* const First_p, long long* const Last_p);
+
+
+/*
+ * Records Generation. A generation that does not follow the last one
+ * recorded, or a world of another size or origin, starts a new keyframe.
+ * Returns 0, or -1 if out of memory, with every generation dropped.
+ */
+int
+HISTORY_Record(HISTORY_t*             History_p,
+               const long long        Generation,
+               const int              Width,
+               const int              Height,
+               const int              OriginColumn,
+               const int              OriginRow,
+               const HISTORY_GetRow_t GetRow,
+               void*                  Context_p);
+
+
+/*
+ * Rebuilds Generation and drops every generation after it, so that
+ * recording goes on from there. Returns 0 and the packed world, which is
+ * valid until the next call, 1 if Generation is not kept, or -1 if out of
+ * memory, with every generation dropped.
+ */
+int
+HISTORY_Seek(HISTORY_t*       History_p,
+             const long long  Generation,
+             const uint64_t** Cells_pp,
+             int* const       Width_p,
+             int* const       Height_p,
+             int* const       OriginColumn_p,
+             int* const       OriginRow_p);
+
+
+
+#endif // GOL_HISTORY_H_
@@ -0,0 +1,738 @@
+/*
+ * Game of Life - MACROCELL Implementation
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "gol_macrocell.h"
+
+
+#define LEAF_LEVEL          3
+
+// Node and leaf lines are short, comment lines are skipped unread
+#define MAX_LINE_LENGTH     256
+
+#define INITIAL_NODES       1024
+
+
+// Live cells of a node, from its top left cell
+typedef struct
+{
+    long long MinColumn;
+    long long MinRow;
+    long long MaxColumn;
+    long long MaxRow;
+} Bounds_t;
+
+
+/*
+ * Nodes are written as they are made, leaves first and then each level
+ * from the rows of nodes below it, and equal nodes are made only once.
+ * Each level keeps the row of nodes that is waiting for the row below it.
+ */
+typedef struct
+{
+    FILE*             File_p;
+    MACROCELL_Node_t* Nodes_p;                           // Numbered as written
+    uint32_t          NumberOfNodes;                     // Node 0 included
+    uint32_t          Capacity;
+    uint32_t*         Table_p;                           // Node numbers, 0 is free
+    uint32_t          TableSize;                         // A power of two
+    int               Level;                             // Of the root
+    uint32_t          Root;
+    int               NumberOfColumns[MACROCELL_MAX_LEVEL + 1];
+    uint32_t*         Pending_p[MACROCELL_MAX_LEVEL + 1];  // Top row waiting
+    int               HasPending[MACROCELL_MAX_LEVEL + 1];
+    uint32_t*         Made_p[MACROCELL_MAX_LEVEL + 1];     // Row just made
+    int               Failed;                            // -2 once memory ran out
+} Writer_t;
+
+
+static size_t
+GetNextLine(const char* const Text_p, const size_t Size, const size_t Position);
+
+static int
+ParseLeaf(const char* Line_p, MACROCELL_Node_t* Node_p);
+
+static int
+ParseNode(const MACROCELL_Tree_t* Tree_p, const char* Line_p, MACROCELL_Node_t* Node_p);
+
+static void
+GetBounds(const MACROCELL_Tree_t* Tree_p, Bounds_t* Bounds_p, const uint32_t Node);
+
+static void
+IncludeCell(Bounds_t* Bounds_p, const long long Column, const long long Row);
+
+static void
+AddRow(const MACROCELL_Tree_t* Tree_p,
+       const uint32_t          Node,
+       const int               Level,
+       const long long         Row,
+       const long long         Column,
+       const int               Width,
+       uint64_t* const         Cells_p);
+
+static void
+PushRow(Writer_t* Writer_p, int Level, const uint32_t* Row_p);
+
+static uint32_t
+MakeNode(Writer_t* Writer_p, const int Level, const uint32_t* const Children_p, const uint64_t Cells);
+
+static int
+GrowTable(Writer_t* Writer_p);
+
+static uint64_t
+HashNode(const int Level, const uint32_t* const Children_p, const uint64_t Cells);
+
+static void
+WriteNode(Writer_t* Writer_p, const MACROCELL_Node_t* Node_p);
+
+
+int
+MACROCELL_IsMacrocell(const char* const Text_p, const size_t Size)
+{
+    const size_t Length = strlen(MACROCELL_MAGIC);
+
+    return Size >= Length && memcmp(Text_p, MACROCELL_MAGIC, Length) == 0;
+}
+
+
+int
+MACROCELL_Parse(MACROCELL_Tree_t* Tree_p, const char* const Text_p, const size_t Size)
+{
+    Bounds_t* Bounds_p = NULL;
+    uint32_t Capacity = 0;
+    size_t Position;
+    int Result = 0;
+
+    memset(Tree_p, 0, sizeof(*Tree_p));
+    if (!MACROCELL_IsMacrocell(Text_p, Size))
+    {
+        return -1;
+    }
+
+    Tree_p->NumberOfNodes = 1;
+    for (Position = GetNextLine(Text_p, Size, 0); Result == 0 && Position < Size; )
+    {
+        const size_t Next = GetNextLine(Text_p, Size, Position);
+        size_t Length = Next - Position;
+        char Line[MAX_LINE_LENGTH];
+
+        while (Length > 0 && (Text_p[Position + Length - 1] == '\n' || Text_p[Position + Length - 1] == '\r'))
+        {
+            Length--;
+        }
+        if (Length == 0 || Text_p[Position] == '#')
+        {
+            Position = Next;
+            continue;
+        }
+        if (Length >= MAX_LINE_LENGTH)
+        {
+            Result = -1;
+            break;
+        }
+        memcpy(Line, Text_p + Position, Length);
+        Line[Length] = '\0';
+        Position = Next;
+
+        if (Tree_p->NumberOfNodes >= Capacity)
+        {
+            const uint32_t NewCapacity = (Capacity == 0) ? INITIAL_NODES : Capacity * 2;
+            MACROCELL_Node_t* Nodes_p = realloc(Tree_p->Nodes_p, NewCapacity * sizeof(MACROCELL_Node_t));
+            Bounds_t* NewBounds_p = NULL;
+
+            if (Nodes_p != NULL)
+            {
+                Tree_p->Nodes_p = Nodes_p;
+                NewBounds_p = realloc(Bounds_p, NewCapacity * sizeof(Bounds_t));
+            }
+            if (NewCapacity <= Capacity || NewBounds_p == NULL)
+            {
+                Result = -2;
+                break;
+            }
+            Bounds_p = NewBounds_p;
+            if (Capacity == 0)
+            {
+                memset(&Tree_p->Nodes_p[0], 0, sizeof(MACROCELL_Node_t));
+                GetBounds(Tree_p, Bounds_p, 0);
+            }
+            Capacity = NewCapacity;
+        }
+
+        if (Line[0] == '.' || Line[0] == '*' || Line[0] == '$')
+        {
+            Result = ParseLeaf(Line, &Tree_p->Nodes_p[Tree_p->NumberOfNodes]);
+        }
+        else
+        {
+            Result = ParseNode(Tree_p, Line, &Tree_p->Nodes_p[Tree_p->NumberOfNodes]);
+        }
+        if (Result == 0)
+        {
+            GetBounds(Tree_p, Bounds_p, Tree_p->NumberOfNodes);
+            Tree_p->NumberOfNodes++;
+        }
+    }
+
+    if (Result == 0)
+    {
+        // A file without nodes is an empty world
+        Tree_p->Root  = Tree_p->NumberOfNodes - 1;
+        Tree_p->Level = (Tree_p->Root > 0) ? Tree_p->Nodes_p[Tree_p->Root].Level : LEAF_LEVEL;
+        if (Tree_p->Root > 0)
+        {
+            Tree_p->MinColumn = Bounds_p[Tree_p->Root].MinColumn;
+            Tree_p->MinRow    = Bounds_p[Tree_p->Root].MinRow;
+            Tree_p->MaxColumn = Bounds_p[Tree_p->Root].MaxColumn;
+            Tree_p->MaxRow    = Bounds_p[Tree_p->Root].MaxRow;
+        }
+        else
+        {
+            Tree_p->MinColumn = 0;
+            Tree_p->MinRow    = 0;
+            Tree_p->MaxColumn = -1;
+            Tree_p->MaxRow    = -1;
+        }
+    }
+
+    free(Bounds_p);
+    if (Result != 0)
+    {
+        MACROCELL_Destroy(Tree_p);
+    }
+    return Result;
+}
+
+
+void
+MACROCELL_Destroy(MACROCELL_Tree_t* Tree_p)
+{
+    free(Tree_p->Nodes_p);
+    memset(Tree_p, 0, sizeof(*Tree_p));
+}
+
+
+void
+MACROCELL_GetRow(const MACROCELL_Tree_t* Tree_p,
+                 const long long         Row,
+                 const long long         Column,
+                 const int               Width,
+                 uint64_t* const         Cells_p)
+{
+    const int NumberOfWords = (Width + 63) / 64;
+
+    memset(Cells_p, 0, NumberOfWords * sizeof(uint64_t));
+    if (Row >= 0 && Row < ((long long)1 << Tree_p->Level))
+    {
+        AddRow(Tree_p, Tree_p->Root, Tree_p->Level, Row, -Column, Width, Cells_p);
+    }
+    if (Width % 64 != 0)
+    {
+        Cells_p[NumberOfWords - 1] &= ((uint64_t)1 << (Width % 64)) - 1;
+    }
+}
+
+
+int
+MACROCELL_Write(FILE*                    File_p,
+                const int                Width,
+                const int                Height,
+                const MACROCELL_GetRow_t GetRow,
+                void*                    Context_p)
+{
+    const int NumberOfWords = (Width + 63) / 64;
+    Writer_t Writer;
+    uint64_t* Rows_p;
+    int Result = 0;
+
+    memset(&Writer, 0, sizeof(Writer));
+    Writer.File_p = File_p;
+    Writer.Level  = LEAF_LEVEL;
+    while (((long long)1 << Writer.Level) < Width || ((long long)1 << Writer.Level) < Height)
+    {
+        Writer.Level++;
+    }
+
+    Rows_p = malloc(8 * (size_t)NumberOfWords * sizeof(uint64_t));
+    Writer.Failed = (Rows_p == NULL || GrowTable(&Writer) != 0) ? -2 : 0;
+    for (int Level = LEAF_LEVEL; Writer.Failed == 0 && Level <= Writer.Level; Level++)
+    {
+        const long long Size = (long long)1 << Level;
+
+        Writer.NumberOfColumns[Level] = (int)((Width + Size - 1) / Size);
+        Writer.Pending_p[Level] = malloc(Writer.NumberOfColumns[Level] * sizeof(uint32_t));
+        Writer.Made_p[Level]    = malloc(Writer.NumberOfColumns[Level] * sizeof(uint32_t));
+        if (Writer.Pending_p[Level] == NULL || Writer.Made_p[Level] == NULL)
+        {
+            Writer.Failed = -2;
+        }
+    }
+
+    if (Writer.Failed == 0)
+    {
+        fprintf(File_p, "%s (gol)\n#R B3/S23\n", MACROCELL_MAGIC);
+    }
+
+    // A row of leaves from every 8 rows of the world
+    for (int Top = 0; Writer.Failed == 0 && Top < Height; Top += 8)
+    {
+        uint32_t* Leaves_p = Writer.Made_p[LEAF_LEVEL];
+
+        memset(Rows_p, 0, 8 * (size_t)NumberOfWords * sizeof(uint64_t));
+        for (int r = 0; r < 8 && Top + r < Height; r++)
+        {
+            uint64_t* Row_p = Rows_p + (size_t)r * NumberOfWords;
+
+            GetRow(Context_p, Top + r, Row_p);
+            if (Width % 64 != 0)
+            {
+                Row_p[NumberOfWords - 1] &= ((uint64_t)1 << (Width % 64)) - 1;
+            }
+        }
+
+        for (int Column = 0; Column < Writer.NumberOfColumns[LEAF_LEVEL]; Column++)
+        {
+            uint64_t Cells = 0;
+
+            for (int r = 0; r < 8; r++)
+            {
+                Cells |= ((Rows_p[(size_t)r * NumberOfWords + Column / 8] >> (Column % 8 * 8)) & 0xFF) << (8 * r);
+            }
+            Leaves_p[Column] = MakeNode(&Writer, LEAF_LEVEL, NULL, Cells);
+        }
+        PushRow(&Writer, LEAF_LEVEL, Leaves_p);
+    }
+
+    // Rows still waiting are at the bottom of the world, below them is empty
+    for (int Level = LEAF_LEVEL; Writer.Failed == 0 && Level < Writer.Level; Level++)
+    {
+        if (Writer.HasPending[Level])
+        {
+            memset(Writer.Made_p[Level], 0, Writer.NumberOfColumns[Level] * sizeof(uint32_t));
+            PushRow(&Writer, Level, Writer.Made_p[Level]);
+        }
+    }
+
+    if (Writer.Failed == 0 && Writer.Root == 0)
+    {
+        // An empty leaf, as a file must have a root
+        fputs("$\n", File_p);
+    }
+
+    if (Writer.Failed != 0)
+    {
+        Result = Writer.Failed;
+    }
+    else if (fflush(File_p) != 0 || ferror(File_p))
+    {
+        Result = -1;
+    }
+
+    for (int Level = LEAF_LEVEL; Level <= Writer.Level; Level++)
+    {
+        free(Writer.Pending_p[Level]);
+        free(Writer.Made_p[Level]);
+    }
+    free(Writer.Nodes_p);
+    free(Writer.Table_p);
+    free(Rows_p);
+    return Result;
+}
+
+
+// Returns the offset of the line after the one at Position
+static size_t
+GetNextLine(const char* const Text_p, const size_t Size, const size_t Position)
+{
+    const char* Newline_p = memchr(Text_p + Position, '\n', Size - Position);
+
+    return (Newline_p != NULL) ? (size_t)(Newline_p - Text_p) + 1 : Size;
+}
+
+
+static int
+ParseLeaf(const char* Line_p, MACROCELL_Node_t* Node_p)
+{
+    int Column = 0;
+    int Row = 0;
+
+    memset(Node_p, 0, sizeof(*Node_p));
+    Node_p->Level = LEAF_LEVEL;
+    for (; *Line_p != '\0'; Line_p++)
+    {
+        if (*Line_p == '$')
+        {
+            Row++;
+            Column = 0;
+            continue;
+        }
+        if ((*Line_p != '.' && *Line_p != '*') || Row >= 8 || Column >= 8)
+        {
+            return -1;
+        }
+        if (*Line_p == '*')
+        {
+            Node_p->Cells |= (uint64_t)1 << (8 * Row + Column);
+        }
+        Column++;
+    }
+    return 0;
+}
+
+
+// Nodes up to the level of a leaf are turned into leaves of their size
+static int
+ParseNode(const MACROCELL_Tree_t* Tree_p, const char* Line_p, MACROCELL_Node_t* Node_p)
+{
+    unsigned long Children[4];
+    char* End_p;
+    long Level;
+
+    memset(Node_p, 0, sizeof(*Node_p));
+    Level = strtol(Line_p, &End_p, 10);
+    if (End_p == Line_p || Level < 1 || Level > MACROCELL_MAX_LEVEL)
+    {
+        return -1;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        Line_p = End_p;
+        Children[i] = strtoul(Line_p, &End_p, 10);
+        if (End_p == Line_p || *Line_p == '-')
+        {
+            return -1;
+        }
+        // Level 1 quadrants are cells, the others nodes one level down
+        if (Level > 1 && Children[i] != 0 &&
+            (Children[i] >= Tree_p->NumberOfNodes || Tree_p->Nodes_p[Children[i]].Level != Level - 1))
+        {
+            return -1;
+        }
+    }
+    while (*End_p == ' ' || *End_p == '\t')
+    {
+        End_p++;
+    }
+    if (*End_p != '\0')
+    {
+        return -1;
+    }
+
+    Node_p->Level = (int)Level;
+    if (Level > LEAF_LEVEL)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            Node_p->Children[i] = (uint32_t)Children[i];
+        }
+    }
+    else
+    {
+        const int Half = 1 << (Level - 1);
+
+        for (int i = 0; i < 4; i++)
+        {
+            const uint64_t Cells = (Level == 1) ? (Children[i] != 0) : Tree_p->Nodes_p[Children[i]].Cells;
+
+            Node_p->Cells |= Cells << ((i / 2) * 8 * Half + (i % 2) * Half);
+        }
+    }
+    return 0;
+}
+
+
+// Bounds of Node, from those of its children, which come before it
+static void
+GetBounds(const MACROCELL_Tree_t* Tree_p, Bounds_t* Bounds_p, const uint32_t Node)
+{
+    const MACROCELL_Node_t* Node_p = &Tree_p->Nodes_p[Node];
+    Bounds_t Bounds = { LLONG_MAX, LLONG_MAX, LLONG_MIN, LLONG_MIN };
+
+    if (Node != 0 && Node_p->Level <= LEAF_LEVEL)
+    {
+        for (int Bit = 0; Bit < 64; Bit++)
+        {
+            if ((Node_p->Cells >> Bit) & 1)
+            {
+                IncludeCell(&Bounds, Bit % 8, Bit / 8);
+            }
+        }
+    }
+    else if (Node != 0)
+    {
+        const long long Half = (long long)1 << (Node_p->Level - 1);
+
+        // Node 0 has no cells, so empty quadrants are left out too
+        for (int i = 0; i < 4; i++)
+        {
+            const Bounds_t* Child_p = &Bounds_p[Node_p->Children[i]];
+
+            if (Child_p->MinColumn <= Child_p->MaxColumn)
+            {
+                IncludeCell(&Bounds, Child_p->MinColumn + (i % 2) * Half, Child_p->MinRow + (i / 2) * Half);
+                IncludeCell(&Bounds, Child_p->MaxColumn + (i % 2) * Half, Child_p->MaxRow + (i / 2) * Half);
+            }
+        }
+    }
+    Bounds_p[Node] = Bounds;
+}
+
+
+static void
+IncludeCell(Bounds_t* Bounds_p, const long long Column, const long long Row)
+{
+    Bounds_p->MinColumn = (Column < Bounds_p->MinColumn) ? Column : Bounds_p->MinColumn;
+    Bounds_p->MinRow    = (Row < Bounds_p->MinRow) ? Row : Bounds_p->MinRow;
+    Bounds_p->MaxColumn = (Column > Bounds_p->MaxColumn) ? Column : Bounds_p->MaxColumn;
+    Bounds_p->MaxRow    = (Row > Bounds_p->MaxRow) ? Row : Bounds_p->MaxRow;
+}
+
+
+// ORs row Row of Node, whose left column is Column in Cells_p, into the
+// Width cells of Cells_p. Only the nodes that overlap them are visited.
+static void
+AddRow(const MACROCELL_Tree_t* Tree_p,
+       const uint32_t          Node,
+       const int               Level,
+       const long long         Row,
+       const long long         Column,
+       const int               Width,
+       uint64_t* const         Cells_p)
+{
+    const long long Size = (long long)1 << Level;
+    const MACROCELL_Node_t* Node_p;
+
+    if (Node == 0 || Column >= Width || Column + Size <= 0)
+    {
+        return;
+    }
+    Node_p = &Tree_p->Nodes_p[Node];
+
+    if (Level <= LEAF_LEVEL)
+    {
+        uint64_t Cells = (Node_p->Cells >> (8 * Row)) & 0xFF;
+        long long First = Column;
+
+        if (First < 0)
+        {
+            Cells >>= -First;
+            First = 0;
+        }
+        Cells_p[First / 64] |= Cells << (First % 64);
+        if (First % 64 > 56 && First / 64 + 1 < (Width + 63) / 64)
+        {
+            Cells_p[First / 64 + 1] |= Cells >> (64 - First % 64);
+        }
+    }
+    else
+    {
+        const long long Half = Size / 2;
+        const int Quadrant = (Row < Half) ? 0 : 2;
+        const long long QuadrantRow = (Row < Half) ? Row : Row - Half;
+
+        AddRow(Tree_p, Node_p->Children[Quadrant], Level - 1, QuadrantRow, Column, Width, Cells_p);
+        AddRow(Tree_p, Node_p->Children[Quadrant + 1], Level - 1, QuadrantRow, Column + Half, Width, Cells_p);
+    }
+}
+
+
+// Takes a row of nodes of Level: the top halves of the nodes one level up
+// wait for it, or are completed by it, and so on up to the root
+static void
+PushRow(Writer_t* Writer_p, int Level, const uint32_t* Row_p)
+{
+    for (; Writer_p->Failed == 0; Level++)
+    {
+        const int NumberOfColumns = Writer_p->NumberOfColumns[Level];
+        const uint32_t* Top_p = Writer_p->Pending_p[Level];
+        uint32_t* Made_p;
+
+        if (Level == Writer_p->Level)
+        {
+            Writer_p->Root = Row_p[0];
+            return;
+        }
+        if (!Writer_p->HasPending[Level])
+        {
+            memcpy(Writer_p->Pending_p[Level], Row_p, NumberOfColumns * sizeof(uint32_t));
+            Writer_p->HasPending[Level] = 1;
+            return;
+        }
+
+        Made_p = Writer_p->Made_p[Level + 1];
+        for (int Column = 0; Column < Writer_p->NumberOfColumns[Level + 1]; Column++)
+        {
+            const int Left  = 2 * Column;
+            const int Right = 2 * Column + 1;
+            const uint32_t Children[4] =
+            {
+                Top_p[Left],
+                (Right < NumberOfColumns) ? Top_p[Right] : 0,
+                Row_p[Left],
+                (Right < NumberOfColumns) ? Row_p[Right] : 0
+            };
+
+            Made_p[Column] = MakeNode(Writer_p, Level + 1, Children, 0);
+        }
+        Writer_p->HasPending[Level] = 0;
+        Row_p = Made_p;
+    }
+}
+
+
+// Returns the number of the node, writing it if it is new. Empty nodes are
+// node 0 and never written, as is every node once memory has run out.
+static uint32_t
+MakeNode(Writer_t* Writer_p, const int Level, const uint32_t* const Children_p, const uint64_t Cells)
+{
+    const uint32_t Mask = Writer_p->TableSize - 1;
+    MACROCELL_Node_t* Node_p;
+    uint32_t Slot;
+
+    if (Writer_p->Failed != 0 || ((Level <= LEAF_LEVEL) ? (Cells == 0) :
+        (Children_p[0] | Children_p[1] | Children_p[2] | Children_p[3]) == 0))
+    {
+        return 0;
+    }
+
+    for (Slot = HashNode(Level, Children_p, Cells) & Mask; Writer_p->Table_p[Slot] != 0; Slot = (Slot + 1) & Mask)
+    {
+        Node_p = &Writer_p->Nodes_p[Writer_p->Table_p[Slot]];
+        if (Node_p->Level == Level &&
+            ((Level <= LEAF_LEVEL) ? (Node_p->Cells == Cells) :
+             memcmp(Node_p->Children, Children_p, sizeof(Node_p->Children)) == 0))
+        {
+            return Writer_p->Table_p[Slot];
+        }
+    }
+
+    if (Writer_p->NumberOfNodes == Writer_p->Capacity)
+    {
+        const uint32_t Capacity = Writer_p->Capacity * 2;
+        MACROCELL_Node_t* Nodes_p = realloc(Writer_p->Nodes_p, Capacity * sizeof(MACROCELL_Node_t));
+
+        if (Capacity <= Writer_p->Capacity || Nodes_p == NULL)
+        {
+            Writer_p->Failed = -2;
+            return 0;
+        }
+        Writer_p->Nodes_p  = Nodes_p;
+        Writer_p->Capacity = Capacity;
+    }
+
+    Node_p = &Writer_p->Nodes_p[Writer_p->NumberOfNodes];
+    memset(Node_p, 0, sizeof(*Node_p));
+    Node_p->Level = Level;
+    Node_p->Cells = Cells;
+    if (Level > LEAF_LEVEL)
+    {
+        memcpy(Node_p->Children, Children_p, sizeof(Node_p->Children));
+    }
+    Writer_p->Table_p[Slot] = Writer_p->NumberOfNodes++;
+    WriteNode(Writer_p, Node_p);
+
+    // At most half full, so that probing stays short
+    if (2 * (size_t)Writer_p->NumberOfNodes > Writer_p->TableSize && GrowTable(Writer_p) != 0)
+    {
+        Writer_p->Failed = -2;
+    }
+    return Writer_p->NumberOfNodes - 1;
+}
+
+
+// Doubles the table, or makes the first one, and puts the nodes back in
+static int
+GrowTable(Writer_t* Writer_p)
+{
+    const uint32_t TableSize = (Writer_p->TableSize == 0) ? 2 * INITIAL_NODES : Writer_p->TableSize * 2;
+    uint32_t* Table_p;
+
+    if (Writer_p->Nodes_p == NULL)
+    {
+        if ((Writer_p->Nodes_p = malloc(INITIAL_NODES * sizeof(MACROCELL_Node_t))) == NULL)
+        {
+            return -1;
+        }
+        memset(&Writer_p->Nodes_p[0], 0, sizeof(MACROCELL_Node_t));
+        Writer_p->NumberOfNodes = 1;
+        Writer_p->Capacity      = INITIAL_NODES;
+    }
+    if (TableSize <= Writer_p->TableSize || (Table_p = calloc(TableSize, sizeof(uint32_t))) == NULL)
+    {
+        return -1;
+    }
+
+    for (uint32_t Node = 1; Node < Writer_p->NumberOfNodes; Node++)
+    {
+        const MACROCELL_Node_t* Node_p = &Writer_p->Nodes_p[Node];
+        uint32_t Slot = HashNode(Node_p->Level, Node_p->Children, Node_p->Cells) & (TableSize - 1);
+
+        while (Table_p[Slot] != 0)
+        {
+            Slot = (Slot + 1) & (TableSize - 1);
+        }
+        Table_p[Slot] = Node;
+    }
+
+    free(Writer_p->Table_p);
+    Writer_p->Table_p   = Table_p;
+    Writer_p->TableSize = TableSize;
+    return 0;
+}
+
+
+static uint64_t
+HashNode(const int Level, const uint32_t* const Children_p, const uint64_t Cells)
+{
+    uint64_t Hash = Cells ^ (uint64_t)Level;
+
+    if (Level > LEAF_LEVEL)
+    {
+        Hash ^= ((uint64_t)Children_p[0] << 32 | Children_p[1]) * 0x9E3779B97F4A7C15ULL;
+        Hash ^= ((uint64_t)Children_p[2] << 32 | Children_p[3]) * 0xC2B2AE3D27D4EB4FULL;
+    }
+
+    // The finalizer of SplitMix64
+    Hash = (Hash ^ (Hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    Hash = (Hash ^ (Hash >> 27)) * 0x94D049BB133111EBULL;
+    return Hash ^ (Hash >> 31);
+}
+
+
+// Node lines as Golly writes them: leaves without the dead cells ending
+// each row or the empty rows ending the leaf
+static void
+WriteNode(Writer_t* Writer_p, const MACROCELL_Node_t* Node_p)
+{
+    char Line[8 * 9 + 2];
+    int Length = 0;
+    int LastRow = 7;
+
+    if (Node_p->Level > LEAF_LEVEL)
+    {
+        fprintf(Writer_p->File_p, "%d %u %u %u %u\n", Node_p->Level,
+                Node_p->Children[0], Node_p->Children[1], Node_p->Children[2], Node_p->Children[3]);
+        return;
+    }
+
+    while (((Node_p->Cells >> (8 * LastRow)) & 0xFF) == 0)
+    {
+        LastRow--;
+    }
+    for (int Row = 0; Row <= LastRow; Row++)
+    {
+        const unsigned int Cells = (Node_p->Cells >> (8 * Row)) & 0xFF;
+
+        for (int Column = 0; (Cells >> Column) != 0; Column++)
+        {
+            Line[Length++] = ((Cells >> Column) & 1) ? '*' : '.';
+        }
+        Line[Length++] = '$';
+    }
+    Line[Length++] = '\n';
+    fwrite(Line, 1, Length, Writer_p->File_p);
+}
@@ -0,0 +1,103 @@
+/*
+ * Game of Life - MACROCELL Support
+ *
+ * Macrocell is the quadtree format of Golly. A world of 2^Level by 2^Level
+ * cells is split into four quadrants, each of those into four again, down
+ * to leaves of 8x8 cells, and equal quadrants are written only once. Large
+ * regular worlds take a few nodes where text takes a character per cell.
+ *
+ * The file starts with a "[M2]" line, then '#' comment lines and one node
+ * per line, numbered from 1 in the order written:
+ *
+ *   leaf:   8 rows of '.' (dead) and '*' (alive), each ending with '$';
+ *           dead cells at the end of a row and empty rows at the end of
+ *           the leaf are left out
+ *   node:   "Level NW NE SW SE", the numbers of its four quadrants, which
+ *           come before it, and 0 for an empty quadrant
+ *
+ * The last node is the root. Nodes of level 1 (a 2x2 block, whose
+ * quadrants are cell states) and level 2, as multi-state rules use, are
+ * read as well, any state other than 0 is alive.
+ */
+
+#ifndef GOL_MACROCELL_H_
+#define GOL_MACROCELL_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+
+#define MACROCELL_MAGIC         "[M2]"
+
+// So that every offset into the root fits in a long long
+#define MACROCELL_MAX_LEVEL     62
+
+
+typedef struct
+{
+    int      Level;
+    uint32_t Children[4];  // Level > 3: NW, NE, SW, SE, 0 is the empty node
+    uint64_t Cells;        // Level <= 3: bit 8 * r + c is column c of row r
+} MACROCELL_Node_t;
+
+
+typedef struct
+{
+    MACROCELL_Node_t* Nodes_p;        // Node 0 is empty, children come first
+    uint32_t          NumberOfNodes;  // Node 0 included
+    uint32_t          Root;
+    int               Level;          // The root is 2^Level cells square
+    long long         MinColumn;      // The live cells, inside the root.
+    long long         MinRow;         // MinColumn > MaxColumn if there are
+    long long         MaxColumn;      // none.
+    long long         MaxRow;
+} MACROCELL_Tree_t;
+
+
+// Packs row Row of the world being written, bit c % 64 of word c / 64 is
+// column c
+typedef void (*MACROCELL_GetRow_t)(void* Context_p, const int Row, uint64_t* const Cells_p);
+
+
+// Returns 1 if Text_p starts with MACROCELL_MAGIC
+int
+MACROCELL_IsMacrocell(const char* const Text_p, const size_t Size);
+
+
+// Parses Size bytes of macrocell text, which need not end in '\0'. Returns
+// 0, -1 if the text is not valid macrocell or -2 if memory runs out.
+int
+MACROCELL_Parse(MACROCELL_Tree_t* Tree_p, const char* const Text_p, const size_t Size);
+
+
+void
+MACROCELL_Destroy(MACROCELL_Tree_t* Tree_p);
+
+
+// Packs Width cells of row Row of the root, starting at column Column,
+// into Cells_p. Cells outside the root are dead.
+void
+MACROCELL_GetRow(const MACROCELL_Tree_t* Tree_p,
+                 const long long         Row,
+                 const long long         Column,
+                 const int               Width,
+                 uint64_t* const         Cells_p);
+
+
+/*
+ * Writes a Width x Height world, read a row at a time through GetRow, with
+ * its top left cell at the top left of the root. Only a row of nodes per
+ * level is kept besides the nodes written. Returns 0, -1 if the file could
+ * not be written (errno tells why) or -2 if memory runs out.
+ */
+int
+MACROCELL_Write(FILE*                    File_p,
+                const int                Width,
+                const int                Height,
+                const MACROCELL_GetRow_t GetRow,
+                void*                    Context_p);
+
+
+
+#endif // GOL_MACROCELL_H_
@@ -10,6 +10,10 @@
 #include "gol_api.h"
 
 
+// Generations a world may get ahead of the comparison
+#define COMPARE_QUEUE_LENGTH 2
+
+
 typedef enum
 {
     GOL_DISPLAY_NONE,
@@ -20,6 +24,19 @@ typedef enum
 } GOL_Display_t;
 
 
+static int
+EvolveWorld(const GOL_Game_t Game);
+
+static int
+CompareWorlds(const GOL_Game_t Game1, const GOL_Game_t Game2);
+
+static void
+PrintEventCounts(const GOL_Game_t Game, const double Seconds);
+
+static void
+PrintEventCount(const char* const Name_p, const long long Count, const long long CellUpdates);
+
+
 int
 main(int argc, char* argv[])
 {
@@ -29,8 +46,29 @@ main(int argc, char* argv[])
     int Height            = DEFAULT_WORLD_HEIGHT;
     int NumGenerations    = DEFAULT_NUM_GENERATIONS;
     char* Filename_p      = NULL;
+    char* StreamFilename_p = NULL;
     int DoCompare         = 0;
+    double Density        = -1.0;
+    unsigned long long Seed = 1;
+    char* PatternFilename_p = NULL;
+    int PatternColumn     = 0;
+    int PatternRow        = 0;
+    GOL_Transform_t Transform = GOL_TRANSFORM_IDENTITY;
+    GOL_StampMode_t StampMode = GOL_STAMP_OR;
+    long long Rewind      = -1;
+    long long Soups       = -1;
+    int Ranks             = 0;
+    char* RecordPath_p    = NULL;
+    GOL_FrameFormat_t FrameFormat = GOL_FRAMES_GIF;
+    GOL_Recorder_t Recorder = NULL;
+    int AutoVariant       = 0;
+    int TuneBudget        = 1000;
+    char* TuningFilename_p = NULL;
+    char DefaultTuningFilename[4096];
     int Success           = 1;
+    GOL_Options_t Options;
+
+    GOL_GetOptions(&Options);
 
     if (argc % 2 == 0)
     {
@@ -61,6 +99,53 @@ main(int argc, char* argv[])
             {
                 Filename_p = Value_p;
             }
+            else if (!strcmp(Option_p, "--stream"))
+            {
+                StreamFilename_p = Value_p;
+            }
+            else if (!strcmp(Option_p, "--random"))
+            {
+                Density = atof(Value_p);
+                if (Density < 0.0 || Density > 1.0)
+                {
+                    printf("\nInvalid density: %s\n\n", Value_p);
+                    Success = 0;
+                    break;
+                }
+            }
+            else if (!strcmp(Option_p, "--seed"))
+            {
+                Seed = strtoull(Value_p, NULL, 0);
+            }
+            else if (!strcmp(Option_p, "--pattern"))
+            {
+                PatternFilename_p = Value_p;
+            }
+            else if (!strcmp(Option_p, "--at"))
+            {
+                if (sscanf(Value_p, "%d,%d", &PatternColumn, &PatternRow) != 2)
+                {
+                    printf("\nInvalid position: %s\n\n", Value_p);
+                    Success = 0;
+                    break;
+                }
+            }
+            else if (!strcmp(Option_p, "--transform"))
+            {
+                int NewTransform = atoi(Value_p);
+                if (NewTransform < GOL_TRANSFORM_LAST_ENTRY)
+                {
+                    Transform = NewTransform;
+                }
+            }
+            else if (!strcmp(Option_p, "--stamp"))
+            {
+                int NewStampMode = atoi(Value_p);
+                if (NewStampMode < GOL_STAMP_LAST_ENTRY)
+                {
+                    StampMode = NewStampMode;
+                }
+            }
             else if (!strcmp(Option_p, "--compare"))
             {
                 DoCompare = atoi(Value_p) ? 1 : 0;
@@ -68,11 +153,78 @@ main(int argc, char* argv[])
             else if (!strcmp(Option_p, "--variant"))
             {
                 int NewVariant = atoi(Value_p);
-                if (NewVariant < GOL_VARIANT_LAST_ENTRY)
+                if (!strcmp(Value_p, "auto"))
                 {
+                    // The world is made as BITS, then moved to the variant chosen
+                    AutoVariant = 1;
+                    Variant = GOL_VARIANT_BITS;
+                }
+                else if (NewVariant < GOL_VARIANT_LAST_ENTRY)
+                {
+                    AutoVariant = 0;
                     Variant = NewVariant;
                 }
             }
+            else if (!strcmp(Option_p, "--tune"))
+            {
+                TuneBudget = atoi(Value_p);
+            }
+            else if (!strcmp(Option_p, "--tuning"))
+            {
+                TuningFilename_p = Value_p;
+            }
+            else if (!strcmp(Option_p, "--threads"))
+            {
+                Options.NumberOfThreads = atoi(Value_p);
+            }
+            else if (!strcmp(Option_p, "--pin"))
+            {
+                Options.PinThreads = atoi(Value_p) ? 1 : 0;
+            }
+            else if (!strcmp(Option_p, "--inplace"))
+            {
+                Options.InPlace = atoi(Value_p) ? 1 : 0;
+            }
+            else if (!strcmp(Option_p, "--grow"))
+            {
+                Options.AutoGrowMargin = atoi(Value_p);
+            }
+            else if (!strcmp(Option_p, "--history"))
+            {
+                Options.HistoryLength = atoi(Value_p);
+            }
+            else if (!strcmp(Option_p, "--keyframe"))
+            {
+                Options.KeyframeInterval = atoi(Value_p);
+            }
+            else if (!strcmp(Option_p, "--perf"))
+            {
+                Options.CountEvents = atoi(Value_p) ? 1 : 0;
+            }
+            else if (!strcmp(Option_p, "--record"))
+            {
+                RecordPath_p = Value_p;
+            }
+            else if (!strcmp(Option_p, "--frames"))
+            {
+                int NewFrameFormat = atoi(Value_p);
+                if (NewFrameFormat < GOL_FRAMES_LAST_ENTRY)
+                {
+                    FrameFormat = NewFrameFormat;
+                }
+            }
+            else if (!strcmp(Option_p, "--ranks"))
+            {
+                Ranks = atoi(Value_p);
+            }
+            else if (!strcmp(Option_p, "--soups"))
+            {
+                Soups = atoll(Value_p);
+            }
+            else if (!strcmp(Option_p, "--rewind"))
+            {
+                Rewind = atoll(Value_p);
+            }
             else if (!strcmp(Option_p, "--display"))
             {
                 int NewDisplay = atoi(Value_p);
@@ -91,18 +243,138 @@ main(int argc, char* argv[])
         }
     }
 
-    if (Success)
+    if (Success && Soups >= 0)
+    {
+        // REFERENCE worlds have a fixed size, soups are searched on TILES,
+        // which skips the empty space around them, unless told otherwise
+        GOL_Variant_t SoupVariant = (Variant == GOL_VARIANT_REFERENCE) ? GOL_VARIANT_TILES : Variant;
+        GOL_Census_t Census;
+        struct timespec StartTime;
+        struct timespec EndTime;
+        double Seconds;
+
+        GOL_SetOptions(&Options);
+        clock_gettime(CLOCK_MONOTONIC, &StartTime);
+        if ((Census = GOL_SearchSoups(SoupVariant, Soups, Seed, Options.NumberOfThreads)) == NULL)
+        {
+            printf("Unable to search soups (%s)\n", GOL_GetStatusString(GOL_GetLastError()));
+            return -1;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &EndTime);
+        Seconds = (EndTime.tv_sec - StartTime.tv_sec) + (EndTime.tv_nsec - StartTime.tv_nsec) / 1e9;
+
+        for (int i = 0; i < GOL_GetCensusSize(Census); i++)
+        {
+            const char* Code_p;
+            long long Count;
+
+            GOL_GetCensusEntry(Census, i, &Code_p, &Count);
+            printf("%12lld %s\n", Count, Code_p);
+        }
+        GOL_DestroyCensus(&Census);
+
+        printf("Done! Searched %lld soups in %f seconds (%.0f soups/s)\n",
+               Soups, Seconds, (Seconds > 0.0) ? Soups / Seconds : 0.0);
+    }
+    else if (Success && StreamFilename_p != NULL)
+    {
+        // Out-of-core: the world lives in a packed file, not in memory
+        char* ScratchFilename_p = malloc(strlen(StreamFilename_p) + sizeof(".scratch"));
+        struct timespec StartTime;
+        struct timespec EndTime;
+        double Seconds;
+
+        GOL_SetOptions(&Options);
+        sprintf(ScratchFilename_p, "%s.scratch", StreamFilename_p);
+
+        if (Filename_p != NULL || Density >= 0.0)
+        {
+            GOL_Game_t TextGame = (Filename_p != NULL) ?
+                GOL_InitializeWorldFromFile(GOL_VARIANT_BITS, Width, Height, Filename_p) :
+                GOL_InitializeWorldRandom(GOL_VARIANT_BITS, Width, Height, Density, Seed);
+            if (TextGame == 0 || GOL_SaveWorldToPackedFile(TextGame, StreamFilename_p) != GOL_OK)
+            {
+                printf("Unable to write packed world: %s (%s)\n", StreamFilename_p,
+                       GOL_GetStatusString(GOL_GetLastError()));
+                return -1;
+            }
+            GOL_DestroyWorld(&TextGame);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &StartTime);
+        if (GOL_StreamEvolve(StreamFilename_p, ScratchFilename_p, NumGenerations) != GOL_OK)
+        {
+            printf("Unable to evolve packed world: %s (%s)\n", StreamFilename_p,
+                   GOL_GetStatusString(GOL_GetLastError()));
+            return -1;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &EndTime);
+        Seconds = (EndTime.tv_sec - StartTime.tv_sec) + (EndTime.tv_nsec - StartTime.tv_nsec) / 1e9;
+
+        if (Filename_p != NULL || Density >= 0.0)
+        {
+            GOL_Game_t FinalGame = GOL_InitializeWorldFromPackedFile(Variant, StreamFilename_p);
+            if (FinalGame == NULL || GOL_SaveWorldToFile(FinalGame, "final_world.txt") != GOL_OK)
+            {
+                printf("Unable to write final world (%s)\n", GOL_GetStatusString(GOL_GetLastError()));
+                return -1;
+            }
+            GOL_DestroyWorld(&FinalGame);
+        }
+
+        free(ScratchFilename_p);
+        printf("Done! Streamed %d evolutions in %f seconds\n", NumGenerations, Seconds);
+    }
+    else if (Success)
     {
         GOL_Game_t TheGame;
         GOL_Game_t RefGame;
-        clock_t StartTime;
-        clock_t EndTime;
+        GOL_Variant_t RefVariant = GOL_VARIANT_REFERENCE;
+        GOL_Options_t RefOptions = Options;
+        int Grows;
+        int Pipelined;
+        GOL_Pattern_t Pattern = NULL;
+        struct timespec StartTime;
+        struct timespec EndTime;
+        double Seconds;
+
+        GOL_SetOptions(&Options);
+
+        if (PatternFilename_p != NULL && (Pattern = GOL_LoadPattern(PatternFilename_p)) == NULL)
+        {
+            printf("Unable to load pattern: %s (%s)\n", PatternFilename_p,
+                   GOL_GetStatusString(GOL_GetLastError()));
+            return -1;
+        }
+
+        // Only ARRAY and BITS worlds grow, and not in ranks. Which variant
+        // the tuning picks is not known yet, so it can not be checked.
+        Grows = Options.AutoGrowMargin > 0 && Ranks == 0 &&
+                (Variant == GOL_VARIANT_ARRAY || Variant == GOL_VARIANT_BITS);
+        if (DoCompare && AutoVariant && Options.AutoGrowMargin > 0)
+        {
+            printf("Unable to compare a world that grows with --variant auto, give the variant\n");
+            return -1;
+        }
+
+        // REFERENCE worlds have a fixed size, others are checked against
+        // ARRAY, which grows the same way as the world if it grows, and is
+        // kept from growing if the world does not
+        if (Grows || (Variant != GOL_VARIANT_REFERENCE && (Width != DEFAULT_WORLD_WIDTH || Height != DEFAULT_WORLD_HEIGHT)))
+        {
+            RefVariant = (Variant == GOL_VARIANT_ARRAY) ? GOL_VARIANT_BITS : GOL_VARIANT_ARRAY;
+        }
+        if (!Grows)
+        {
+            RefOptions.AutoGrowMargin = 0;
+        }
 
         printf("Game of Life!\n\n"
                "Params... Width=%d Height=%d NumGenerations=%d "
-                "File=%s Compare=%d Variant=%d\n\n",
+                "File=%s Compare=%d Variant=%d Threads=%d Pin=%d\n\n",
                 Width, Height, NumGenerations,
-                Filename_p, DoCompare, Variant);
+                Filename_p, DoCompare, Variant,
+                Options.NumberOfThreads, Options.PinThreads);
 
         if (Filename_p != NULL)
         {
@@ -112,40 +384,163 @@ main(int argc, char* argv[])
                                                   Filename_p);
 //                        GOL_OutputWorld(TheGame);
 //                        exit(0);
+        }
+        else if (Density >= 0.0)
+        {
+            TheGame = GOL_InitializeWorldRandom(Variant, Width, Height, Density, Seed);
+        }
+        else
+        {
+            // The default glider is only placed when no pattern is given
+            TheGame = GOL_InitializeWorld(Variant, Width, Height, Pattern == NULL);
+        }
 
-            if (DoCompare)
+        if (DoCompare)
+        {
+            GOL_SetOptions(&RefOptions);
+            if (Filename_p != NULL)
             {
-                RefGame = GOL_InitializeWorldFromFile(GOL_VARIANT_REFERENCE,
+                RefGame = GOL_InitializeWorldFromFile(RefVariant,
                                                       Width,
                                                       Height,
                                                       Filename_p);
             }
+            else if (Density >= 0.0)
+            {
+                RefGame = GOL_InitializeWorldRandom(RefVariant,
+                                                    Width, Height, Density, Seed);
+            }
+            else
+            {
+                RefGame = GOL_InitializeWorld(RefVariant,
+                                              Width, Height, Pattern == NULL);
+            }
+            GOL_SetOptions(&Options);
         }
-        else
+
+        if (TheGame == 0 || (DoCompare && RefGame == 0))
         {
-            TheGame = GOL_InitializeWorld(Variant, Width, Height, 1);
+            printf("Unable to initialize world (%s)\n", GOL_GetStatusString(GOL_GetLastError()));
+            return -1;
+        }
+
+        if (Pattern != NULL)
+        {
+            GOL_StampPattern(TheGame, Pattern, PatternColumn, PatternRow, Transform, StampMode);
             if (DoCompare)
             {
-                RefGame = GOL_InitializeWorld(GOL_VARIANT_REFERENCE,
-                                              Width, Height, 1);
+                GOL_StampPattern(RefGame, Pattern, PatternColumn, PatternRow, Transform, StampMode);
             }
+            GOL_DestroyPattern(&Pattern);
         }
 
-        if (TheGame == 0)
+        if (AutoVariant)
         {
-            return -1;
+            GOL_Tuning_t Tuning;
+            GOL_Game_t TunedGame;
+
+            if (TuningFilename_p == NULL)
+            {
+                snprintf(DefaultTuningFilename, sizeof(DefaultTuningFilename), "%s/.gol_tuning",
+                         (getenv("HOME") != NULL) ? getenv("HOME") : ".");
+                TuningFilename_p = DefaultTuningFilename;
+            }
+            if (GOL_TuneWorld(TheGame, TuneBudget, TuningFilename_p, &Tuning) != GOL_OK)
+            {
+                printf("Unable to tune (%s)\n", GOL_GetStatusString(GOL_GetLastError()));
+                return -1;
+            }
+
+            Options.NumberOfThreads = Tuning.NumberOfThreads;
+            Options.InPlace         = Tuning.InPlace;
+            GOL_SetOptions(&Options);
+            if ((TunedGame = GOL_CloneWorld(TheGame, Tuning.Variant)) == NULL)
+            {
+                printf("Unable to initialize world (%s)\n", GOL_GetStatusString(GOL_GetLastError()));
+                return -1;
+            }
+            GOL_DestroyWorld(&TheGame);
+            TheGame = TunedGame;
+            Variant = Tuning.Variant;
+
+            printf("Tuned... Variant=%d Threads=%d InPlace=%d, %.3g cell updates per second (%s)\n\n",
+                   Tuning.Variant, Tuning.NumberOfThreads, Tuning.InPlace, Tuning.CellUpdatesPerSecond,
+                   Tuning.Cached ? TuningFilename_p : "measured");
         }
 
-        StartTime = clock();
-        for (int i = 0; i < NumGenerations; i++)
+        if (RecordPath_p != NULL)
+        {
+            Recorder = GOL_StartRecording(RecordPath_p, FrameFormat, 16);
+            if (Recorder == NULL)
+            {
+                printf("Unable to record to %s (%s)\n", RecordPath_p, GOL_GetStatusString(GOL_GetLastError()));
+                return -1;
+            }
+            GOL_RecordFrame(Recorder, TheGame);
+        }
+
+        // Unless each generation is shown or recorded, the worlds compared
+        // are evolved side by side
+        Pipelined = DoCompare && Ranks == 0 && Recorder == NULL && Display != GOL_DISPLAY_ANIMATE;
+
+        // Wall time, as the work is spread over threads and processes
+        clock_gettime(CLOCK_MONOTONIC, &StartTime);
+        if (Ranks > 0)
+        {
+            if (GOL_EvolveWorldInRanks(TheGame, Ranks, NumGenerations) != GOL_OK)
+            {
+                printf("Unable to evolve in %d ranks (%s)\n", Ranks, GOL_GetStatusString(GOL_GetLastError()));
+                return -1;
+            }
+            if (Recorder != NULL)
+            {
+                GOL_RecordFrame(Recorder, TheGame);
+            }
+            for (int i = 0; i < NumGenerations && DoCompare; i++)
+            {
+                if (!EvolveWorld(RefGame))
+                {
+                    return -1;
+                }
+            }
+            if (DoCompare && !CompareWorlds(TheGame, RefGame))
+            {
+                return -1;
+            }
+        }
+        else if (Pipelined)
+        {
+            long long Generation;
+            int Column;
+            int Row;
+
+            if (GOL_EvolveAndCompare(TheGame, RefGame, NumGenerations, COMPARE_QUEUE_LENGTH,
+                                     &Generation, &Column, &Row) != GOL_OK)
+            {
+                if (GOL_GetLastError() == GOL_ERROR_MISMATCH)
+                {
+                    printf("ERROR! Worlds are not equal in generation %lld! X=%d Y= %d\n",
+                           Generation, Column, Row);
+                }
+                else
+                {
+                    printf("Unable to compare (%s)\n", GOL_GetStatusString(GOL_GetLastError()));
+                }
+                return -1;
+            }
+        }
+        for (int i = 0; i < NumGenerations && Ranks == 0 && !Pipelined; i++)
         {
 //            printf("\n-------------------- EVOLVING...\n");
 //            GOL_OutputWorld(TheGame);
 
-            GOL_EvolveWorld(TheGame);
-            if (DoCompare)
+            if (!EvolveWorld(TheGame) || (DoCompare && !EvolveWorld(RefGame)))
+            {
+                return -1;
+            }
+            if (Recorder != NULL)
             {
-                GOL_EvolveWorld(RefGame);
+                GOL_RecordFrame(Recorder, TheGame);
             }
 
             if (Display == GOL_DISPLAY_ANIMATE)
@@ -154,21 +549,73 @@ main(int argc, char* argv[])
                 GOL_OutputWorld(TheGame);
                 system("sleep 0.1");
             }
-            if (DoCompare)
+            if (DoCompare && !CompareWorlds(TheGame, RefGame))
+            {
+                return -1;
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &EndTime);
+        Seconds = (EndTime.tv_sec - StartTime.tv_sec) + (EndTime.tv_nsec - StartTime.tv_nsec) / 1e9;
+
+        if (Recorder != NULL && GOL_StopRecording(&Recorder) != GOL_OK)
+        {
+            printf("Unable to write frames to %s (%s)\n", RecordPath_p, GOL_GetStatusString(GOL_GetLastError()));
+            return -1;
+        }
+
+        if (Rewind >= 0)
+        {
+            if (GOL_SeekGeneration(TheGame, Rewind) != 0 ||
+                (DoCompare && GOL_SeekGeneration(RefGame, Rewind) != 0))
             {
-                GOL_CompareWorlds(TheGame, RefGame);
+                printf("Generation %lld is not kept, see --history\n", Rewind);
+                return -1;
+            }
+            if (DoCompare && !CompareWorlds(TheGame, RefGame))
+            {
+                return -1;
             }
         }
-        EndTime = clock();
 
         if (Display == GOL_DISPLAY_SHOW_FINAL)
         {
             GOL_OutputWorld(TheGame);
         }
 
-        if (Filename_p != NULL)
+        if (Filename_p != NULL || Density >= 0.0 || PatternFilename_p != NULL)
         {
-            GOL_SaveWorldToFile(TheGame, "final_world.txt");
+            if (GOL_SaveWorldToFile(TheGame, "final_world.txt") != GOL_OK)
+            {
+                printf("Unable to write final world (%s)\n", GOL_GetStatusString(GOL_GetLastError()));
+                return -1;
+            }
+        }
+
+        {
+            int MinColumn, MinRow, MaxColumn, MaxRow;
+            int OriginColumn, OriginRow;
+
+            GOL_GetWorldOrigin(TheGame, &OriginColumn, &OriginRow);
+            if (OriginColumn != 0 || OriginRow != 0 ||
+                GOL_GetWorldWidth(TheGame) != Width || GOL_GetWorldHeight(TheGame) != Height)
+            {
+                printf("World: %dx%d at (%d,%d)\n", GOL_GetWorldWidth(TheGame),
+                       GOL_GetWorldHeight(TheGame), OriginColumn, OriginRow);
+            }
+            if (GOL_GetBoundingBox(TheGame, &MinColumn, &MinRow, &MaxColumn, &MaxRow))
+            {
+                printf("Population: %lld in (%d,%d)-(%d,%d)\n", GOL_GetPopulation(TheGame),
+                       MinColumn, MinRow, MaxColumn, MaxRow);
+            }
+            else
+            {
+                printf("Population: 0\n");
+            }
+        }
+
+        if (Options.CountEvents)
+        {
+            PrintEventCounts(TheGame, Seconds);
         }
 
         GOL_DestroyWorld(&TheGame);
@@ -176,9 +623,7 @@ main(int argc, char* argv[])
         {
             GOL_DestroyWorld(&RefGame);
         }
-        printf("Done! Made %d evolutions in %f seconds\n",
-               NumGenerations,
-               (((double)(EndTime - StartTime)) / CLOCKS_PER_SEC));
+        printf("Done! Made %d evolutions in %f seconds\n", NumGenerations, Seconds);
     }
     else
     {
@@ -187,21 +632,175 @@ main(int argc, char* argv[])
                "          [--height Y]\n"
                "          [--count NUMBER_OF_GENERATIONS]\n"
                "          [--file  WORLD_FILE]\n"
+               "          [--random DENSITY]\n"
+               "          [--seed S]\n"
+               "          [--stream PACKED_FILE]\n"
+               "          [--pattern PATTERN_FILE]\n"
+               "          [--at X,Y]\n"
+               "          [--transform R]\n"
+               "          [--stamp S]\n"
                "          [--compare BOOL]\n"
-               "          [--variant N]\n"
+               "          [--variant N|auto]\n"
+               "          [--tune MILLISECONDS]\n"
+               "          [--tuning FILE]\n"
                "          [--display M]\n"
+               "          [--threads T]\n"
+               "          [--pin BOOL]\n"
+               "          [--inplace BOOL]\n"
+               "          [--grow MARGIN]\n"
+               "          [--history LENGTH]\n"
+               "          [--keyframe K]\n"
+               "          [--rewind GENERATION]\n"
+               "          [--ranks P]\n"
+               "          [--perf BOOL]\n"
+               "          [--record PATH]\n"
+               "          [--frames F]\n"
+               "          [--soups N]\n"
                "\n"
-               "Where variants are: 0 - Ref, 1 - Array, 2 - Bits\n"
+               "Where variants are: 0 - Ref, 1 - Array, 2 - Bits, 3 - Tiles, 4 - Counts\n"
                 "\n"
                 "Where displays are: 0 - None,  1 - Animate, 2 - Final evolvement\n"
                 "\n"
+                "WORLD_FILE is text, a line per row with '*' alive, or a Golly\n"
+                "macrocell (.mc) file.\n"
+                "\n"
+                "With --variant auto the variant, threads and in place setting\n"
+                "that evolve the world fastest are measured on a sample of it, in\n"
+                "about MILLISECONDS, and kept in FILE for this host and worlds of\n"
+                "about the same size and density, so that later runs start at once.\n"
+                "\n"
+                "With --compare every generation is checked against the same\n"
+                "world on REF (39x20 worlds only) or Array (Bits when checking\n"
+                "Array), each world evolved on its own thread while the last\n"
+                "generation is compared, unless it is animated or recorded.\n"
+                "\n"
+                "With --random each cell is alive with probability DENSITY\n"
+                "(0.0 - 1.0), the same world for the same S on every variant.\n"
+                "DENSITY is kept to 16 significant bits, down to about 1e-10,\n"
+                "and one that would round to 0.0 or 1.0 is refused.\n"
+                "\n"
+                "With --pattern the RLE or text pattern in PATTERN_FILE is\n"
+                "stamped with its top left cell at X,Y, after the world is made.\n"
+                "Transforms are: 0 - None, 1/2/3 - Rotate 90/180/270 clockwise,\n"
+                "4 - Flip columns, 5 - Flip rows, 6 - Transpose, 7 - Anti-transpose\n"
+                "Stamp modes are: 0 - Or, 1 - Xor, 2 - Copy\n"
+                "\n"
+                "With --history the last LENGTH generations are kept, a full\n"
+                "copy every K and only the changes in between, and --rewind\n"
+                "puts the world back to GENERATION after the last evolve.\n"
+                "\n"
+                "With --stream the world is evolved out-of-core in PACKED_FILE,\n"
+                "which is first created from WORLD_FILE (or --random) if given.\n"
+                "\n"
+                "With --record every generation is written to PATH as frames:\n"
+                "0 - PBM, 1 - PGM (one file per generation, PATH000042.pbm),\n"
+                "2 - GIF, 3 - Raw 8-bit grey frames, all in PATH\n"
+                "\n"
+                "With --perf hardware events are counted around each evolve and\n"
+                "reported per cell update: cycles, instructions, L1D, LLC and dTLB\n"
+                "misses, branch misses. Needs perf_event_paranoid <= 2.\n"
+                "\n"
+                "With --ranks the world is split into P bands of rows, each\n"
+                "evolved in its own process, passing border rows in shared memory.\n"
+                "\n"
+                "With --soups N random 16x16 soups drawn from S are evolved until\n"
+                "they settle, on T threads (0 - one per CPU) with Tiles unless\n"
+                "another variant is given, and the objects left are counted by\n"
+                "apgcode: xs still lifes, xp oscillators, xq spaceships.\n"
+                "\n"
                "Default values are: X=%d Y=%d NUMBER_OF_GENERATIONS=%d\n"
                 "                   WORLD_FILE=N/A (Glider Pattern)\n"
-                "                   COMPARE=NO VARIANT=REF\n"
-                "                   DISPLAY=ANIMATE\n"
+                "                   COMPARE=NO VARIANT=REF SEED=1 AT=0,0\n"
+                "                   DISPLAY=ANIMATE THREADS=1 PIN=NO INPLACE=NO GROW=0\n"
+                "                   LENGTH=0 K=64 P=0 F=GIF\n"
+                "                   MILLISECONDS=1000 FILE=$HOME/.gol_tuning\n"
                 "\n",
                 argv[0],
                 DEFAULT_WORLD_WIDTH, DEFAULT_WORLD_HEIGHT, DEFAULT_NUM_GENERATIONS);
     }
     return 0;
 }
+
+
+// Evolves the world once and returns 1, or prints why it could not be
+// evolved and returns 0. A history or snapshot that is dropped is no reason
+// to stop.
+static int
+EvolveWorld(const GOL_Game_t Game)
+{
+    const long long Generation = GOL_GetGeneration(Game);
+
+    if (GOL_EvolveWorld(Game) != GOL_OK && GOL_GetGeneration(Game) == Generation)
+    {
+        printf("Unable to evolve (%s)\n", GOL_GetStatusString(GOL_GetLastError()));
+        return 0;
+    }
+    return 1;
+}
+
+
+// Prints both worlds and returns 0 if they differ
+static int
+CompareWorlds(const GOL_Game_t Game1, const GOL_Game_t Game2)
+{
+    int Column;
+    int Row;
+
+    if (GOL_CompareWorlds(Game1, Game2, &Column, &Row) == GOL_OK)
+    {
+        return 1;
+    }
+
+    printf("ERROR! Worlds are not equal! X=%d Y= %d\n", Column, Row);
+    printf("GAME1\n");
+    GOL_OutputWorld(Game1);
+    printf("GAME2\n");
+    GOL_OutputWorld(Game2);
+    return 0;
+}
+
+
+// Events per cell update, next to the throughput they come with
+static void
+PrintEventCounts(const GOL_Game_t Game, const double Seconds)
+{
+    GOL_EventCounts_t Counts;
+
+    if (GOL_GetEventCounts(Game, &Counts) != GOL_OK)
+    {
+        printf("Event counters are not available: perf_event_open() is not allowed, or the CPU has none\n");
+        return;
+    }
+
+    printf("Cell updates: %lld", Counts.CellUpdates);
+    if (Seconds > 0.0)
+    {
+        printf(", %.3g per second", Counts.CellUpdates / Seconds);
+    }
+    printf("\n");
+
+    PrintEventCount("Cycles", Counts.Cycles, Counts.CellUpdates);
+    PrintEventCount("Instructions", Counts.Instructions, Counts.CellUpdates);
+    PrintEventCount("L1D misses", Counts.L1DMisses, Counts.CellUpdates);
+    PrintEventCount("LLC misses", Counts.LLCMisses, Counts.CellUpdates);
+    PrintEventCount("Branch misses", Counts.BranchMisses, Counts.CellUpdates);
+    PrintEventCount("dTLB misses", Counts.DTLBMisses, Counts.CellUpdates);
+    if (Counts.Cycles > 0 && Counts.Instructions >= 0)
+    {
+        printf("  %-14s %10.3f\n", "IPC", (double)Counts.Instructions / Counts.Cycles);
+    }
+}
+
+
+static void
+PrintEventCount(const char* const Name_p, const long long Count, const long long CellUpdates)
+{
+    if (Count < 0)
+    {
+        printf("  %-14s %10s\n", Name_p, "n/a");
+    }
+    else
+    {
+        printf("  %-14s %10.4f per cell update\n", Name_p, (CellUpdates > 0) ? (double)Count / CellUpdates : 0.0);
+    }
+}
@@ -0,0 +1,377 @@
+/*
+ * Game of Life - PATTERN Implementation
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "gol_pattern.h"
+
+
+static int
+AllocateImage(PATTERN_Image_t* Image_p, const int Width, const int Height);
+
+static void
+SetBit(PATTERN_Image_t* Image_p, const int Column, const int Row);
+
+static int
+GetBit(const PATTERN_Image_t* Image_p, const int Column, const int Row);
+
+static int
+IsRle(const char* Text_p);
+
+static int
+ParseRle(PATTERN_Image_t* Image_p, const char* Text_p);
+
+static int
+ParseText(PATTERN_Image_t* Image_p, const char* Text_p);
+
+
+int
+PATTERN_Parse(PATTERN_t* Pattern_p, const char* const Text_p)
+{
+    memset(Pattern_p, 0, sizeof(*Pattern_p));
+
+    if (IsRle(Text_p))
+    {
+        return ParseRle(&Pattern_p->Images[PATTERN_TRANSFORM_IDENTITY], Text_p);
+    }
+    return ParseText(&Pattern_p->Images[PATTERN_TRANSFORM_IDENTITY], Text_p);
+}
+
+
+void
+PATTERN_Destroy(PATTERN_t* Pattern_p)
+{
+    for (int i = 0; i < PATTERN_TRANSFORM_LAST_ENTRY; i++)
+    {
+        free(Pattern_p->Images[i].Rows_p);
+        Pattern_p->Images[i].Rows_p = NULL;
+    }
+}
+
+
+const PATTERN_Image_t*
+PATTERN_GetImage(PATTERN_t* Pattern_p, const PATTERN_Transform_t Transform)
+{
+    const PATTERN_Image_t* Source_p = &Pattern_p->Images[PATTERN_TRANSFORM_IDENTITY];
+    PATTERN_Image_t* Image_p = &Pattern_p->Images[Transform];
+    const int W = Source_p->Width;
+    const int H = Source_p->Height;
+    int Swapped;
+
+    if (Image_p->Rows_p != NULL || Transform == PATTERN_TRANSFORM_IDENTITY)
+    {
+        return Image_p;
+    }
+
+    // Rotating by 90 or 270 degrees, or mirroring in a diagonal, swaps the sides
+    Swapped = (Transform == PATTERN_TRANSFORM_ROTATE_90 || Transform == PATTERN_TRANSFORM_ROTATE_270 ||
+               Transform == PATTERN_TRANSFORM_TRANSPOSE || Transform == PATTERN_TRANSFORM_ANTI_TRANSPOSE);
+    if (AllocateImage(Image_p, Swapped ? H : W, Swapped ? W : H) != 0)
+    {
+        return NULL;
+    }
+
+    // Patterns are small and each image is made once, so cell by cell will do
+    for (int y = 0; y < H; y++)
+    {
+        for (int x = 0; x < W; x++)
+        {
+            if (!GetBit(Source_p, x, y))
+            {
+                continue;
+            }
+            switch (Transform)
+            {
+            case PATTERN_TRANSFORM_ROTATE_90:      SetBit(Image_p, H - 1 - y, x);         break;
+            case PATTERN_TRANSFORM_ROTATE_180:     SetBit(Image_p, W - 1 - x, H - 1 - y); break;
+            case PATTERN_TRANSFORM_ROTATE_270:     SetBit(Image_p, y, W - 1 - x);         break;
+            case PATTERN_TRANSFORM_FLIP_COLUMNS:   SetBit(Image_p, W - 1 - x, y);         break;
+            case PATTERN_TRANSFORM_FLIP_ROWS:      SetBit(Image_p, x, H - 1 - y);         break;
+            case PATTERN_TRANSFORM_TRANSPOSE:      SetBit(Image_p, y, x);                 break;
+            case PATTERN_TRANSFORM_ANTI_TRANSPOSE: SetBit(Image_p, H - 1 - y, W - 1 - x); break;
+            default:                                                                      break;
+            }
+        }
+    }
+    return Image_p;
+}
+
+
+uint64_t
+PATTERN_GetBits(const uint64_t* const Row_p, const int NumberOfBits, const int First)
+{
+    const int NumberOfWords = (NumberOfBits + 63) / 64;
+    // Floor division, First may be negative
+    const int Word  = (First >= 0) ? First / 64 : -((63 - First) / 64);
+    const int Shift = First - Word * 64;
+    uint64_t Low  = (Word >= 0 && Word < NumberOfWords) ? Row_p[Word] : 0;
+    uint64_t High = (Word + 1 >= 0 && Word + 1 < NumberOfWords) ? Row_p[Word + 1] : 0;
+
+    // Rows keep the bits past NumberOfBits clear, so no masking is needed
+    return (Shift == 0) ? Low : (Low >> Shift) | (High << (64 - Shift));
+}
+
+
+uint64_t
+PATTERN_GetMask(const int NumberOfBits, const int First)
+{
+    // Bits j with 0 <= First + j < NumberOfBits
+    int Start = (First < 0) ? -First : 0;
+    int End   = NumberOfBits - First;
+
+    if (End > 64)
+    {
+        End = 64;
+    }
+    if (End <= Start)
+    {
+        return 0;
+    }
+    return ((End - Start == 64) ? ~(uint64_t)0 : (((uint64_t)1 << (End - Start)) - 1)) << Start;
+}
+
+
+uint64_t
+PATTERN_Combine(const uint64_t       Target,
+                const uint64_t       Bits,
+                const uint64_t       Mask,
+                const PATTERN_Mode_t Mode)
+{
+    switch (Mode)
+    {
+    case PATTERN_MODE_XOR:
+        return Target ^ (Bits & Mask);
+
+    case PATTERN_MODE_COPY:
+        return (Target & ~Mask) | (Bits & Mask);
+
+    default:
+        return Target | (Bits & Mask);
+    }
+}
+
+
+static int
+AllocateImage(PATTERN_Image_t* Image_p, const int Width, const int Height)
+{
+    Image_p->Width       = Width;
+    Image_p->Height      = Height;
+    Image_p->WordsPerRow = (Width + 63) / 64;
+    Image_p->Rows_p      = calloc((size_t)Image_p->WordsPerRow * Height + 1, sizeof(uint64_t));
+    return (Image_p->Rows_p == NULL) ? -1 : 0;
+}
+
+
+static void
+SetBit(PATTERN_Image_t* Image_p, const int Column, const int Row)
+{
+    Image_p->Rows_p[(size_t)Row * Image_p->WordsPerRow + Column / 64] |= (uint64_t)1 << (Column % 64);
+}
+
+
+static int
+GetBit(const PATTERN_Image_t* Image_p, const int Column, const int Row)
+{
+    return (Image_p->Rows_p[(size_t)Row * Image_p->WordsPerRow + Column / 64] >> (Column % 64)) & 1;
+}
+
+
+// RLE starts with its "x = m, y = n" header, after any '#' lines
+static int
+IsRle(const char* Text_p)
+{
+    while (*Text_p != '\0')
+    {
+        while (*Text_p == ' ' || *Text_p == '\t' || *Text_p == '\r' || *Text_p == '\n')
+        {
+            Text_p++;
+        }
+        if (*Text_p != '#')
+        {
+            break;
+        }
+        Text_p = strchr(Text_p, '\n');
+        if (Text_p == NULL)
+        {
+            return 0;
+        }
+    }
+
+    if (*Text_p != 'x')
+    {
+        return 0;
+    }
+    Text_p++;
+    while (*Text_p == ' ')
+    {
+        Text_p++;
+    }
+    return *Text_p == '=';
+}
+
+
+/*
+ * <count><tag> runs, where 'b' and '.' are dead cells, '$' ends a row and
+ * '!' ends the pattern. Any other letter is a live cell. The size in the
+ * header is used if it is larger than the cells found.
+ */
+static int
+ParseRle(PATTERN_Image_t* Image_p, const char* Text_p)
+{
+    int Width = 0;
+    int Height = 0;
+    const char* Body_p = NULL;
+
+    // Pass 0 measures the pattern, pass 1 sets the cells
+    for (int Pass = 0; Pass < 2; Pass++)
+    {
+        const char* Position_p = Text_p;
+        int Column = 0;
+        int Row = 0;
+
+        if (Pass == 1 && AllocateImage(Image_p, Width, Height) != 0)
+        {
+            return -1;
+        }
+
+        while (*Position_p != '\0')
+        {
+            // Header and comment lines
+            if (Body_p == NULL && (*Position_p == '#' || *Position_p == 'x'))
+            {
+                if (*Position_p == 'x')
+                {
+                    const char* Y_p = strchr(Position_p, 'y');
+                    const char* End_p = strchr(Position_p, '\n');
+
+                    Width = atoi(strchr(Position_p, '=') + 1);
+                    if (Y_p != NULL && (End_p == NULL || Y_p < End_p) && strchr(Y_p, '=') != NULL)
+                    {
+                        Height = atoi(strchr(Y_p, '=') + 1);
+                    }
+                }
+                Position_p = strchr(Position_p, '\n');
+                if (Position_p == NULL)
+                {
+                    break;
+                }
+                continue;
+            }
+            if (Pass == 0 && Body_p == NULL && !isspace((unsigned char)*Position_p))
+            {
+                Body_p = Position_p;
+            }
+
+            if (isspace((unsigned char)*Position_p))
+            {
+                Position_p++;
+            }
+            else if (*Position_p == '!')
+            {
+                break;
+            }
+            else
+            {
+                int Count = 1;
+                char Tag;
+
+                if (isdigit((unsigned char)*Position_p))
+                {
+                    Count = (int)strtol(Position_p, (char**)&Position_p, 10);
+                }
+                Tag = *Position_p;
+                if (Tag == '\0')
+                {
+                    break;
+                }
+                Position_p++;
+
+                if (Tag == '$')
+                {
+                    Row += Count;
+                    Column = 0;
+                }
+                else if (Tag == 'b' || Tag == '.')
+                {
+                    Column += Count;
+                }
+                else if (isalpha((unsigned char)Tag))
+                {
+                    for (int i = 0; i < Count; i++, Column++)
+                    {
+                        if (Pass == 0)
+                        {
+                            Width  = (Column + 1 > Width) ? Column + 1 : Width;
+                            Height = (Row + 1 > Height) ? Row + 1 : Height;
+                        }
+                        else
+                        {
+                            SetBit(Image_p, Column, Row);
+                        }
+                    }
+                }
+            }
+        }
+        Text_p = (Body_p != NULL) ? Body_p : Position_p;
+    }
+    return 0;
+}
+
+
+static int
+ParseText(PATTERN_Image_t* Image_p, const char* Text_p)
+{
+    int Width = 0;
+    int Height = 0;
+
+    // Pass 0 measures the pattern, pass 1 sets the cells
+    for (int Pass = 0; Pass < 2; Pass++)
+    {
+        const char* Line_p = Text_p;
+        int Row = 0;
+
+        if (Pass == 1 && AllocateImage(Image_p, Width, Height) != 0)
+        {
+            return -1;
+        }
+
+        while (*Line_p != '\0')
+        {
+            const char* End_p = strchr(Line_p, '\n');
+            int Length = (End_p != NULL) ? (int)(End_p - Line_p) : (int)strlen(Line_p);
+
+            if (Length > 0 && Line_p[Length - 1] == '\r')
+            {
+                Length--;
+            }
+            if (Line_p[0] != '!')
+            {
+                for (int Column = 0; Column < Length; Column++)
+                {
+                    if (Line_p[Column] == '*' || Line_p[Column] == 'O')
+                    {
+                        if (Pass == 0)
+                        {
+                            Width = (Column + 1 > Width) ? Column + 1 : Width;
+                        }
+                        else
+                        {
+                            SetBit(Image_p, Column, Row);
+                        }
+                    }
+                }
+                Row++;
+                Height = (Pass == 0) ? Row : Height;
+            }
+            if (End_p == NULL)
+            {
+                break;
+            }
+            Line_p = End_p + 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Game of Life - PATTERN Support
+ *
+ * Patterns are parsed once, from RLE or plain text, into packed rows:
+ * bit c % 64 of word c / 64 of a row is column c, the same layout as the
+ * *_SetRowInCurrent() functions take. Each of the eight rotations and
+ * reflections is made the first time it is stamped and then kept, so
+ * stamping the same pattern many times only costs the word operations.
+ */
+
+#ifndef GOL_PATTERN_H_
+#define GOL_PATTERN_H_
+
+#include <stdint.h>
+
+
+typedef enum
+{
+    PATTERN_TRANSFORM_IDENTITY,
+    PATTERN_TRANSFORM_ROTATE_90,       // Clockwise
+    PATTERN_TRANSFORM_ROTATE_180,
+    PATTERN_TRANSFORM_ROTATE_270,
+    PATTERN_TRANSFORM_FLIP_COLUMNS,    // Mirrored left to right
+    PATTERN_TRANSFORM_FLIP_ROWS,       // Mirrored top to bottom
+    PATTERN_TRANSFORM_TRANSPOSE,       // Mirrored in the main diagonal
+    PATTERN_TRANSFORM_ANTI_TRANSPOSE,  // Mirrored in the other diagonal
+
+    PATTERN_TRANSFORM_LAST_ENTRY
+} PATTERN_Transform_t;
+
+
+typedef enum
+{
+    PATTERN_MODE_OR,      // Live pattern cells are set
+    PATTERN_MODE_XOR,     // Live pattern cells are toggled
+    PATTERN_MODE_COPY,    // The whole pattern rectangle is overwritten
+
+    PATTERN_MODE_LAST_ENTRY
+} PATTERN_Mode_t;
+
+
+typedef struct
+{
+    int       Width;
+    int       Height;
+    int       WordsPerRow;
+    uint64_t* Rows_p;     // Height rows of WordsPerRow words, NULL until made
+} PATTERN_Image_t;
+
+
+typedef struct
+{
+    PATTERN_Image_t Images[PATTERN_TRANSFORM_LAST_ENTRY];
+} PATTERN_t;
+
+
+// Parses RLE (recognized by its "x = ..." header line) or plain text, where
+// '*' and 'O' are live cells and lines starting with '!' are comments.
+// Returns 0 on success.
+int
+PATTERN_Parse(PATTERN_t* Pattern_p, const char* const Text_p);
+
+
+void
+PATTERN_Destroy(PATTERN_t* Pattern_p);
+
+
+// Returns the pattern as it looks after Transform, NULL if out of memory.
+const PATTERN_Image_t*
+PATTERN_GetImage(PATTERN_t* Pattern_p, const PATTERN_Transform_t Transform);
+
+
+// Returns 64 bits of a packed row of NumberOfBits bits, starting at bit
+// First, which may be negative. Bits outside the row are clear.
+uint64_t
+PATTERN_GetBits(const uint64_t* const Row_p, const int NumberOfBits, const int First);
+
+
+// As PATTERN_GetBits(), for a row with all NumberOfBits bits set
+uint64_t
+PATTERN_GetMask(const int NumberOfBits, const int First);
+
+
+// Returns Target with Bits combined in, by Mode, wherever Mask is set
+uint64_t
+PATTERN_Combine(const uint64_t       Target,
+                const uint64_t       Bits,
+                const uint64_t       Mask,
+                const PATTERN_Mode_t Mode);
+
+
+
+#endif // GOL_PATTERN_H_
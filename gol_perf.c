@@ -0,0 +1,284 @@
+/*
+ * Game of Life - PERF Implementation
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "gol_perf.h"
+
+
+#define CACHE_READ_MISS(CACHE) \
+    ((CACHE) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+
+// In the order of PERF_Event_t
+static const struct
+{
+    uint32_t Type;
+    uint64_t Config;
+} Events[PERF_EVENT_LAST_ENTRY] =
+{
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB) },
+};
+
+
+static void
+OpenWorkerCounters(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+static void
+AddCounts(const PERF_Counters_t* Counters_p, long long Counts[PERF_EVENT_LAST_ENTRY]);
+
+
+int
+PERF_Open(PERF_Counters_t* Counters_p, const int Inherit)
+{
+    int NumberOfEvents = 0;
+
+    for (int Event = 0; Event < PERF_EVENT_LAST_ENTRY; Event++)
+    {
+        struct perf_event_attr Attributes;
+
+        memset(&Attributes, 0, sizeof(Attributes));
+        Attributes.size           = sizeof(Attributes);
+        Attributes.type           = Events[Event].Type;
+        Attributes.config         = Events[Event].Config;
+        Attributes.disabled       = 1;
+        Attributes.inherit        = Inherit ? 1 : 0;
+        Attributes.exclude_kernel = 1;
+        Attributes.exclude_hv     = 1;
+        Attributes.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // This thread, on any CPU. Fails with ENOENT if the CPU does not
+        // have the event, EACCES if perf_event_paranoid does not allow it.
+        Counters_p->Fds[Event] = (int)syscall(SYS_perf_event_open, &Attributes, 0, -1, -1, 0);
+        if (Counters_p->Fds[Event] >= 0)
+        {
+            NumberOfEvents++;
+        }
+        else
+        {
+            Counters_p->Fds[Event] = -1;
+        }
+    }
+    return NumberOfEvents;
+}
+
+
+void
+PERF_Close(PERF_Counters_t* Counters_p)
+{
+    for (int Event = 0; Event < PERF_EVENT_LAST_ENTRY; Event++)
+    {
+        if (Counters_p->Fds[Event] >= 0)
+        {
+            close(Counters_p->Fds[Event]);
+            Counters_p->Fds[Event] = -1;
+        }
+    }
+}
+
+
+// Starting and stopping a counter does the same for the counters inherited
+// from it
+void
+PERF_Start(PERF_Counters_t* Counters_p)
+{
+    for (int Event = 0; Event < PERF_EVENT_LAST_ENTRY; Event++)
+    {
+        if (Counters_p->Fds[Event] >= 0)
+        {
+            ioctl(Counters_p->Fds[Event], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+
+void
+PERF_Stop(PERF_Counters_t* Counters_p)
+{
+    for (int Event = 0; Event < PERF_EVENT_LAST_ENTRY; Event++)
+    {
+        if (Counters_p->Fds[Event] >= 0)
+        {
+            ioctl(Counters_p->Fds[Event], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+
+
+// Reading a counter adds up the counters inherited from it, and those of
+// threads and processes that have ended
+void
+PERF_Read(const PERF_Counters_t* Counters_p, long long Counts[PERF_EVENT_LAST_ENTRY])
+{
+    for (int Event = 0; Event < PERF_EVENT_LAST_ENTRY; Event++)
+    {
+        uint64_t Values[3];  // Count, time enabled, time running
+
+        Counts[Event] = -1;
+        if (Counters_p->Fds[Event] < 0 || read(Counters_p->Fds[Event], Values, sizeof(Values)) != sizeof(Values))
+        {
+            continue;
+        }
+
+        if (Values[2] == 0)
+        {
+            // Never on the hardware, or never started
+            Counts[Event] = (Values[1] == 0) ? 0 : -1;
+        }
+        else if (Values[2] < Values[1])
+        {
+            Counts[Event] = (long long)((double)Values[0] * Values[1] / Values[2]);
+        }
+        else
+        {
+            Counts[Event] = (long long)Values[0];
+        }
+    }
+}
+
+
+int
+PERF_OpenGroup(PERF_Group_t* Group_p, THREADS_Pool_t* Pool_p)
+{
+    int NumberOfEvents;
+
+    Group_p->Thread           = pthread_self();
+    Group_p->Pool_p           = Pool_p;
+    Group_p->WorkerCounters_p = NULL;
+    NumberOfEvents = PERF_Open(&Group_p->Counters, 0);
+    if (NumberOfEvents == 0)
+    {
+        return 0;
+    }
+
+    for (int Event = 0; Event < PERF_EVENT_LAST_ENTRY; Event++)
+    {
+        Group_p->Counts[Event] = (Group_p->Counters.Fds[Event] >= 0) ? 0 : -1;
+    }
+
+    // Without threads of its own the pool runs everything on the caller
+    if (THREADS_GetNumberOfThreads(Pool_p) > 1)
+    {
+        Group_p->WorkerCounters_p = malloc(THREADS_GetNumberOfThreads(Pool_p) * sizeof(PERF_Counters_t));
+        if (Group_p->WorkerCounters_p == NULL)
+        {
+            PERF_Close(&Group_p->Counters);
+            return -1;
+        }
+        THREADS_Run(Pool_p, OpenWorkerCounters, Group_p);
+    }
+    return NumberOfEvents;
+}
+
+
+void
+PERF_CloseGroup(PERF_Group_t* Group_p)
+{
+    PERF_Close(&Group_p->Counters);
+    if (Group_p->WorkerCounters_p != NULL)
+    {
+        for (int Worker = 0; Worker < THREADS_GetNumberOfThreads(Group_p->Pool_p); Worker++)
+        {
+            PERF_Close(&Group_p->WorkerCounters_p[Worker]);
+        }
+        free(Group_p->WorkerCounters_p);
+        Group_p->WorkerCounters_p = NULL;
+    }
+}
+
+
+void
+PERF_StartGroup(PERF_Group_t* Group_p)
+{
+    if (!pthread_equal(Group_p->Thread, pthread_self()))
+    {
+        AddCounts(&Group_p->Counters, Group_p->Counts);
+        PERF_Close(&Group_p->Counters);
+        PERF_Open(&Group_p->Counters, 0);
+        Group_p->Thread = pthread_self();
+    }
+
+    PERF_Start(&Group_p->Counters);
+    if (Group_p->WorkerCounters_p != NULL)
+    {
+        for (int Worker = 0; Worker < THREADS_GetNumberOfThreads(Group_p->Pool_p); Worker++)
+        {
+            PERF_Start(&Group_p->WorkerCounters_p[Worker]);
+        }
+    }
+}
+
+
+void
+PERF_StopGroup(PERF_Group_t* Group_p)
+{
+    PERF_Stop(&Group_p->Counters);
+    if (Group_p->WorkerCounters_p != NULL)
+    {
+        for (int Worker = 0; Worker < THREADS_GetNumberOfThreads(Group_p->Pool_p); Worker++)
+        {
+            PERF_Stop(&Group_p->WorkerCounters_p[Worker]);
+        }
+    }
+}
+
+
+void
+PERF_AddToGroup(PERF_Group_t* Group_p, const PERF_Counters_t* Counters_p)
+{
+    AddCounts(Counters_p, Group_p->Counts);
+}
+
+
+void
+PERF_ReadGroup(const PERF_Group_t* Group_p, long long Counts[PERF_EVENT_LAST_ENTRY])
+{
+    memcpy(Counts, Group_p->Counts, sizeof(Group_p->Counts));
+    AddCounts(&Group_p->Counters, Counts);
+    if (Group_p->WorkerCounters_p != NULL)
+    {
+        for (int Worker = 0; Worker < THREADS_GetNumberOfThreads(Group_p->Pool_p); Worker++)
+        {
+            AddCounts(&Group_p->WorkerCounters_p[Worker], Counts);
+        }
+    }
+}
+
+
+static void
+OpenWorkerCounters(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    PERF_Group_t* Group_p = Context_p;
+
+    (void)NumberOfThreads;
+    PERF_Open(&Group_p->WorkerCounters_p[ThreadIndex], 0);
+}
+
+
+// Adds what the counters counted to Counts, leaving events not counted at -1
+static void
+AddCounts(const PERF_Counters_t* Counters_p, long long Counts[PERF_EVENT_LAST_ENTRY])
+{
+    long long Read[PERF_EVENT_LAST_ENTRY];
+
+    PERF_Read(Counters_p, Read);
+    for (int Event = 0; Event < PERF_EVENT_LAST_ENTRY; Event++)
+    {
+        if (Counts[Event] >= 0 && Read[Event] >= 0)
+        {
+            Counts[Event] += Read[Event];
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * Game of Life - PERF Support
+ *
+ * Hardware event counters, through perf_event_open(). A set of counters
+ * counts the thread that opened it, and only while started, and only in
+ * user space. Opened to be inherited, it counts the processes the thread
+ * forks too. Events that the CPU does not have, or that the system does not
+ * let us count, are left out.
+ */
+
+#ifndef GOL_PERF_H_
+#define GOL_PERF_H_
+
+#include <pthread.h>
+
+#include "gol_threads.h"
+
+
+typedef enum
+{
+    PERF_EVENT_CYCLES,
+    PERF_EVENT_INSTRUCTIONS,
+    PERF_EVENT_L1D_MISSES,       // Level 1 data cache read misses
+    PERF_EVENT_LLC_MISSES,       // Last level cache misses
+    PERF_EVENT_BRANCH_MISSES,
+    PERF_EVENT_DTLB_MISSES,      // Data TLB read misses
+
+    PERF_EVENT_LAST_ENTRY
+} PERF_Event_t;
+
+
+typedef struct
+{
+    int Fds[PERF_EVENT_LAST_ENTRY];  // -1 for events not counted
+} PERF_Counters_t;
+
+
+// The counters of a thread and of the workers of its pool, counting the
+// work they do together. Counters are not inherited by the workers, or they
+// would count every thread the caller starts later on too (a second pool's
+// workers, another thread working next to this one). Each worker opens its
+// own set instead.
+typedef struct
+{
+    PERF_Counters_t  Counters;          // Of the thread that opened the group
+    pthread_t        Thread;            // The thread that opened Counters
+    THREADS_Pool_t*  Pool_p;
+    PERF_Counters_t* WorkerCounters_p;  // One set for each worker of the pool, or NULL
+    long long        Counts[PERF_EVENT_LAST_ENTRY]; // Of counters closed since, -1 for events not counted
+} PERF_Group_t;
+
+
+// Opens the counters of the calling thread, stopped, and inherited by the
+// threads and processes it starts if Inherit. Returns the number of events
+// that can be counted, 0 if none can.
+int
+PERF_Open(PERF_Counters_t* Counters_p, const int Inherit);
+
+
+void
+PERF_Close(PERF_Counters_t* Counters_p);
+
+
+void
+PERF_Start(PERF_Counters_t* Counters_p);
+
+
+void
+PERF_Stop(PERF_Counters_t* Counters_p);
+
+
+// Counts since the counters were opened, scaled up for the time an event
+// had to share the hardware with others, -1 for events not counted
+void
+PERF_Read(const PERF_Counters_t* Counters_p, long long Counts[PERF_EVENT_LAST_ENTRY]);
+
+
+// Opens the counters of the calling thread and of the workers of Pool_p,
+// stopped. Returns the number of events that can be counted, 0 if none can
+// and -1 if out of memory, leaving nothing open unless it returns more
+// than 0.
+int
+PERF_OpenGroup(PERF_Group_t* Group_p, THREADS_Pool_t* Pool_p);
+
+
+void
+PERF_CloseGroup(PERF_Group_t* Group_p);
+
+
+// Started by another thread than last time, the group moves its counters
+// to that thread, keeping what they counted so far
+void
+PERF_StartGroup(PERF_Group_t* Group_p);
+
+
+void
+PERF_StopGroup(PERF_Group_t* Group_p);
+
+
+// Adds what Counters_p counted to the group, for counters about to be
+// closed
+void
+PERF_AddToGroup(PERF_Group_t* Group_p, const PERF_Counters_t* Counters_p);
+
+
+// What the group counted since it was opened, -1 for events not counted
+void
+PERF_ReadGroup(const PERF_Group_t* Group_p, long long Counts[PERF_EVENT_LAST_ENTRY]);
+
+
+
+#endif // GOL_PERF_H_
@@ -0,0 +1,110 @@
+/*
+ * Game of Life - RANDOM Implementation
+ *
+ */
+
+#include "gol_random.h"
+
+
+#define RANDOM_ONE  ((uint64_t)1 << 32)
+
+
+static uint64_t
+GetFraction(const double Density);
+
+static inline uint64_t
+Mix(uint64_t Value);
+
+
+void
+RANDOM_GetRow(uint64_t* const Cells_p,
+              const int       Width,
+              const int       Row,
+              const uint64_t  Seed,
+              const double    Density)
+{
+    const int NumberOfWords = (Width + 63) / 64;
+    const uint64_t Key = Mix(Seed);
+    const uint64_t FineKey = Mix(Key);
+    const uint64_t Fraction = GetFraction(Density);
+    const int FirstBit = (Fraction > 0 && Fraction < RANDOM_ONE) ? __builtin_ctzll(Fraction) : 0;
+
+    for (int i = 0; i < NumberOfWords; i++)
+    {
+        // Row, word and round in one counter: rows below 2^31, words below 2^27
+        const uint64_t Counter = ((uint64_t)Row << 32) | ((uint64_t)i << 3);
+        const uint64_t FineCounter = ((uint64_t)Row << 32) | ((uint64_t)i << 5);
+        uint64_t Cells = 0;
+
+        if (Fraction == RANDOM_ONE)
+        {
+            Cells = ~(uint64_t)0;
+        }
+        else if (Fraction > 0)
+        {
+            /*
+             * Density is 0.b1 b2 ... b32 in binary. Going from the lowest set
+             * bit up, OR with a random word for a 1 and AND for a 0: every
+             * step halves the density and adds one half for a 1. The top
+             * eight bits have rounds of their own, so that a multiple of
+             * 1/256 takes at most eight rounds and gives the same world as
+             * when densities were rounded to those.
+             */
+            for (int Bit = FirstBit; Bit < 32; Bit++)
+            {
+                uint64_t Random = (Bit >= 24) ? Mix(Key + Counter + Bit - 24) : Mix(FineKey + FineCounter + Bit);
+                Cells = ((Fraction >> Bit) & 1) ? (Cells | Random) : (Cells & Random);
+            }
+        }
+
+        if (i == NumberOfWords - 1 && Width % 64 != 0)
+        {
+            Cells &= ((uint64_t)1 << (Width % 64)) - 1;
+        }
+        Cells_p[i] = Cells;
+    }
+}
+
+
+double
+RANDOM_RoundDensity(const double Density)
+{
+    return (double)GetFraction(Density) / RANDOM_ONE;
+}
+
+
+// Density in units of 2^-32, with RANDOM_DENSITY_BITS significant bits
+static uint64_t
+GetFraction(const double Density)
+{
+    uint64_t Fraction;
+    int Shift;
+
+    if (!(Density > 0.0))
+    {
+        return 0;
+    }
+    if (Density >= 1.0)
+    {
+        return RANDOM_ONE;
+    }
+
+    Fraction = (uint64_t)(Density * RANDOM_ONE + 0.5);
+    Shift = (Fraction > 0) ? 64 - __builtin_clzll(Fraction) - RANDOM_DENSITY_BITS : 0;
+    if (Shift > 0)
+    {
+        Fraction = ((Fraction + ((uint64_t)1 << (Shift - 1))) >> Shift) << Shift;
+    }
+    return Fraction;
+}
+
+
+// The SplitMix64 finalizer
+static inline uint64_t
+Mix(uint64_t Value)
+{
+    Value += 0x9E3779B97F4A7C15ull;
+    Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+    return Value ^ (Value >> 31);
+}
@@ -0,0 +1,40 @@
+/*
+ * Game of Life - RANDOM Support
+ *
+ * Random worlds from a counter-based generator: each 64-bit word of
+ * random bits is a hash of the seed, the row and the position in the row.
+ * Any row can be made on its own, in any order and on any thread, and a
+ * cell only depends on the seed and its position, so every variant and
+ * every number of threads gets the same world.
+ */
+
+#ifndef GOL_RANDOM_H_
+#define GOL_RANDOM_H_
+
+#include <stdint.h>
+
+
+// Densities are rounded to RANDOM_DENSITY_BITS significant bits, and to
+// the nearest multiple of 2^-32
+#define RANDOM_DENSITY_BITS    16
+
+
+// Fills Cells_p (bit c % 64 of word c / 64 is column c) with row Row of the
+// world for Seed, each cell alive with probability Density. Bits for
+// columns >= Width are clear.
+void
+RANDOM_GetRow(uint64_t* const Cells_p,
+              const int       Width,
+              const int       Row,
+              const uint64_t  Seed,
+              const double    Density);
+
+
+// The probability RANDOM_GetRow() makes a cell alive with for Density,
+// 0.0 or 1.0 for densities too close to them
+double
+RANDOM_RoundDensity(const double Density);
+
+
+
+#endif // GOL_RANDOM_H_
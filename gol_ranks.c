@@ -0,0 +1,326 @@
+/*
+ * Game of Life - RANKS Implementation
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "gol_ranks.h"
+#include "gol_threads.h"
+
+
+#define BORDER_TOP      0
+#define BORDER_BOTTOM   1
+
+
+// At the start of the shared mapping, followed by the border rows and then
+// the world
+typedef struct
+{
+    pthread_mutex_t Lock;
+    pthread_cond_t  Posted;
+    long long       Generations[];  // Per rank: the last borders posted
+} Shared_t;
+
+
+static int
+RunRank(RANKS_World_t* World_p, const int Rank, const long long NumberOfGenerations);
+
+static void
+EvolveRows(BitsGame_t* Band_p, const int FirstRow, const int EndRow);
+
+static uint_t*
+GetBorder(RANKS_World_t* World_p, const int Rank, const int Border, const long long Generation);
+
+static void
+PostBorders(RANKS_World_t*      World_p,
+            const int           Rank,
+            const long long     Generation,
+            const uint_t* const Top_p,
+            const uint_t* const Bottom_p);
+
+static void
+FetchBorder(RANKS_World_t*  World_p,
+            const int       Rank,
+            const int       Border,
+            const long long Generation,
+            uint_t* const   Row_p);
+
+
+int
+RANKS_Create(RANKS_World_t* World_p,
+             const int      Width,
+             const int      Height,
+             const int      NumberOfRanks)
+{
+    const int UintInBits = sizeof(uint_t) * 8;
+    pthread_mutexattr_t MutexAttributes;
+    pthread_condattr_t CondAttributes;
+    Shared_t* Shared_p;
+    size_t HeaderSize;
+    size_t RowSize;
+
+    World_p->Width               = Width;
+    World_p->Height              = Height;
+    World_p->NumberOfRanks       = (NumberOfRanks < Height) ? NumberOfRanks : Height;
+    World_p->NumberOfUintsPerRow = (Width + 2 + (UintInBits - 1)) / UintInBits;
+
+    // Four border rows per rank: top and bottom, for odd and even generations
+    HeaderSize = (sizeof(Shared_t) + World_p->NumberOfRanks * sizeof(long long) + 63) & ~(size_t)63;
+    RowSize = World_p->NumberOfUintsPerRow * sizeof(uint_t);
+    World_p->Size = HeaderSize + (4 * (size_t)World_p->NumberOfRanks + Height) * RowSize;
+
+    World_p->Shared_p = mmap(NULL, World_p->Size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (World_p->Shared_p == MAP_FAILED)
+    {
+        World_p->Shared_p = NULL;
+        return -1;
+    }
+    World_p->Borders_p = (uint_t*)((char*)World_p->Shared_p + HeaderSize);
+    World_p->Rows_p    = World_p->Borders_p + 4 * (size_t)World_p->NumberOfRanks * World_p->NumberOfUintsPerRow;
+
+    Shared_p = (Shared_t*)World_p->Shared_p;
+    pthread_mutexattr_init(&MutexAttributes);
+    pthread_mutexattr_setpshared(&MutexAttributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&Shared_p->Lock, &MutexAttributes);
+    pthread_mutexattr_destroy(&MutexAttributes);
+    pthread_condattr_init(&CondAttributes);
+    pthread_condattr_setpshared(&CondAttributes, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&Shared_p->Posted, &CondAttributes);
+    pthread_condattr_destroy(&CondAttributes);
+
+    return 0;
+}
+
+
+void
+RANKS_Destroy(RANKS_World_t* World_p)
+{
+    Shared_t* Shared_p = (Shared_t*)World_p->Shared_p;
+
+    pthread_mutex_destroy(&Shared_p->Lock);
+    pthread_cond_destroy(&Shared_p->Posted);
+    munmap(World_p->Shared_p, World_p->Size);
+    World_p->Shared_p  = NULL;
+    World_p->Borders_p = NULL;
+    World_p->Rows_p    = NULL;
+}
+
+
+uint_t*
+RANKS_GetRow(RANKS_World_t* World_p, const int Row)
+{
+    return World_p->Rows_p + (size_t)Row * World_p->NumberOfUintsPerRow;
+}
+
+
+int
+RANKS_Evolve(RANKS_World_t* World_p, const long long NumberOfGenerations)
+{
+    Shared_t* Shared_p = (Shared_t*)World_p->Shared_p;
+    pid_t* Ranks_p;
+    int NumberOfRunning = 0;
+    int Result = 0;
+
+    if ((Ranks_p = malloc(World_p->NumberOfRanks * sizeof(pid_t))) == NULL)
+    {
+        return -1;
+    }
+
+    memset(Shared_p->Generations, 0, World_p->NumberOfRanks * sizeof(long long));
+    for (int Rank = 0; Rank < World_p->NumberOfRanks; Rank++)
+    {
+        if ((Ranks_p[Rank] = fork()) == 0)
+        {
+            _exit(RunRank(World_p, Rank, NumberOfGenerations));
+        }
+        else if (Ranks_p[Rank] < 0)
+        {
+            Result = -1;
+            break;
+        }
+        NumberOfRunning++;
+    }
+
+    // A rank that is missing or fails leaves its neighbours waiting for
+    // its borders, so the others are stopped. Each rank is polled, as
+    // waiting for any child would also reap those of the caller.
+    while (NumberOfRunning > 0)
+    {
+        int Reaped = 0;
+
+        if (Result != 0)
+        {
+            for (int Rank = 0; Rank < World_p->NumberOfRanks; Rank++)
+            {
+                if (Ranks_p[Rank] > 0)
+                {
+                    kill(Ranks_p[Rank], SIGKILL);
+                }
+            }
+        }
+
+        for (int Rank = 0; Rank < World_p->NumberOfRanks; Rank++)
+        {
+            int Status;
+
+            if (Ranks_p[Rank] > 0 && waitpid(Ranks_p[Rank], &Status, WNOHANG) == Ranks_p[Rank])
+            {
+                if (!WIFEXITED(Status) || WEXITSTATUS(Status) != 0)
+                {
+                    Result = -1;
+                }
+                Ranks_p[Rank] = 0;
+                NumberOfRunning--;
+                Reaped = 1;
+            }
+        }
+
+        if (!Reaped)
+        {
+            usleep(1000);
+        }
+    }
+
+    free(Ranks_p);
+    return Result;
+}
+
+
+// Runs in the child process of one rank, returns its exit status
+static int
+RunRank(RANKS_World_t* World_p, const int Rank, const long long NumberOfGenerations)
+{
+    const size_t Stride = World_p->NumberOfUintsPerRow;
+    BitsGame_t Band;
+    int Start;
+    int End;
+    int Height;
+    int FirstRow;
+    int EndRow;
+
+    THREADS_GetBand(World_p->Height, Rank, World_p->NumberOfRanks, &Start, &End);
+    Height = End - Start;
+
+    if (BITS_InitializeWorld(&Band, World_p->Width, Height, 0, NULL) != 0)
+    {
+        return 1;
+    }
+
+    // The halo rows start out as the neighbours' border rows. The world is
+    // not written until the end, which no rank reaches before its
+    // neighbours have posted the first generation, and so read it.
+    FirstRow = (Start > 0) ? Start - 1 : Start;
+    EndRow   = (End < World_p->Height) ? End + 1 : End;
+    memcpy(Band.CurrentWorld_p + (FirstRow - Start + 1) * Stride, RANKS_GetRow(World_p, FirstRow),
+           (EndRow - FirstRow) * Stride * sizeof(uint_t));
+
+    for (long long Generation = 1; Generation <= NumberOfGenerations; Generation++)
+    {
+        uint_t* Evolved_p;
+
+        EvolveRows(&Band, 0, 1);
+        EvolveRows(&Band, (Height > 1) ? Height - 1 : 1, Height);
+        PostBorders(World_p, Rank, Generation,
+                    Band.EvolvingWorld_p + Stride, Band.EvolvingWorld_p + Height * Stride);
+
+        EvolveRows(&Band, 1, Height - 1);
+
+        Evolved_p = Band.EvolvingWorld_p;
+        Band.EvolvingWorld_p = Band.CurrentWorld_p;
+        Band.CurrentWorld_p = Evolved_p;
+
+        // The halo rows at the edges of the world stay clear
+        if (Rank > 0)
+        {
+            FetchBorder(World_p, Rank - 1, BORDER_BOTTOM, Generation, Band.CurrentWorld_p);
+        }
+        if (Rank < World_p->NumberOfRanks - 1)
+        {
+            FetchBorder(World_p, Rank + 1, BORDER_TOP, Generation,
+                        Band.CurrentWorld_p + (Height + 1) * Stride);
+        }
+    }
+
+    memcpy(RANKS_GetRow(World_p, Start), Band.CurrentWorld_p + Stride, Height * Stride * sizeof(uint_t));
+    BITS_DestroyWorld(&Band);
+    return 0;
+}
+
+
+// Rows FirstRow .. EndRow - 1 of the band into its evolving world
+static void
+EvolveRows(BitsGame_t* Band_p, const int FirstRow, const int EndRow)
+{
+    const size_t Stride = Band_p->NumberOfUintsPerRow;
+
+    for (int Row = FirstRow; Row < EndRow; Row++)
+    {
+        const uint_t* Row_p = Band_p->CurrentWorld_p + (Row + 1) * Stride;
+
+        BITS_EvolveRow(Row_p - Stride, Row_p, Row_p + Stride, Band_p->EvolvingWorld_p + (Row + 1) * Stride,
+                       Band_p->NumberOfUintsPerRow, Band_p->Width);
+    }
+}
+
+
+/*
+ * Borders alternate between two slots. A rank only posts generation G + 2
+ * after it has fetched generation G + 1 from its neighbours, who have
+ * fetched generation G before posting that, so the slot it writes to has
+ * been read.
+ */
+static uint_t*
+GetBorder(RANKS_World_t* World_p, const int Rank, const int Border, const long long Generation)
+{
+    const size_t Slot = ((size_t)Rank * 2 + Border) * 2 + (size_t)(Generation % 2);
+
+    return World_p->Borders_p + Slot * World_p->NumberOfUintsPerRow;
+}
+
+
+static void
+PostBorders(RANKS_World_t*      World_p,
+            const int           Rank,
+            const long long     Generation,
+            const uint_t* const Top_p,
+            const uint_t* const Bottom_p)
+{
+    Shared_t* Shared_p = (Shared_t*)World_p->Shared_p;
+    const size_t RowSize = World_p->NumberOfUintsPerRow * sizeof(uint_t);
+
+    memcpy(GetBorder(World_p, Rank, BORDER_TOP, Generation), Top_p, RowSize);
+    memcpy(GetBorder(World_p, Rank, BORDER_BOTTOM, Generation), Bottom_p, RowSize);
+
+    pthread_mutex_lock(&Shared_p->Lock);
+    Shared_p->Generations[Rank] = Generation;
+    pthread_cond_broadcast(&Shared_p->Posted);
+    pthread_mutex_unlock(&Shared_p->Lock);
+}
+
+
+static void
+FetchBorder(RANKS_World_t*  World_p,
+            const int       Rank,
+            const int       Border,
+            const long long Generation,
+            uint_t* const   Row_p)
+{
+    Shared_t* Shared_p = (Shared_t*)World_p->Shared_p;
+
+    pthread_mutex_lock(&Shared_p->Lock);
+    while (Shared_p->Generations[Rank] < Generation)
+    {
+        pthread_cond_wait(&Shared_p->Posted, &Shared_p->Lock);
+    }
+    pthread_mutex_unlock(&Shared_p->Lock);
+
+    memcpy(Row_p, GetBorder(World_p, Rank, Border, Generation), World_p->NumberOfUintsPerRow * sizeof(uint_t));
+}
@@ -0,0 +1,61 @@
+/*
+ * Game of Life - RANKS Support
+ *
+ * Evolves a world split into bands of rows, one per child process (rank).
+ * Each rank keeps its band as a BITS world whose halo rows hold the border
+ * rows of the ranks above and below it. The border rows are passed on
+ * every generation through memory shared by all the ranks, as BITS rows.
+ * A rank evolves its own border rows first and posts them, and only then
+ * evolves the rest of its band, so that its neighbours need not wait for
+ * its whole band before they can go on.
+ */
+
+#ifndef GOL_RANKS_H_
+#define GOL_RANKS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "gol_bits.h"
+
+
+typedef struct
+{
+    int     Width;
+    int     Height;
+    int     NumberOfRanks;
+    int     NumberOfUintsPerRow;
+    size_t  Size;       // Of the shared mapping
+    void*   Shared_p;   // Lock and posted generations
+    uint_t* Borders_p;  // Four rows per rank, in the shared mapping
+    uint_t* Rows_p;     // The world, also in the shared mapping
+} RANKS_World_t;
+
+
+// Returns 0, or -1 if the shared memory can not be mapped. There are never
+// more ranks than rows.
+int
+RANKS_Create(RANKS_World_t* World_p,
+             const int      Width,
+             const int      Height,
+             const int      NumberOfRanks);
+
+
+void
+RANKS_Destroy(RANKS_World_t* World_p);
+
+
+// Row of the world, laid out as a BITS row: bit b of uint b / 32 is
+// column b - 1
+uint_t*
+RANKS_GetRow(RANKS_World_t* World_p, const int Row);
+
+
+// Evolves the world in place in NumberOfRanks processes. Returns 0, or -1
+// if a rank could not be started or failed, when the world is undefined.
+int
+RANKS_Evolve(RANKS_World_t* World_p, const long long NumberOfGenerations);
+
+
+
+#endif // GOL_RANKS_H_
@@ -0,0 +1,224 @@
+/*
+ * Game of Life - REGION Implementation
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "gol_region.h"
+
+
+typedef struct
+{
+    REGION_Index_t* Index_p;
+    REGION_GetRow_t GetRow;
+    void*           Context_p;
+    uint64_t*       Rows_p;       // One row for each worker to pack into
+} RegionBuild_t;
+
+
+static void
+BuildBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+static long long
+CountColumn(const uint64_t* const Column_p, const uint64_t Mask, const int FirstRow, const int EndRow);
+
+
+void
+REGION_Initialize(REGION_Index_t* Index_p)
+{
+    memset(Index_p, 0, sizeof(*Index_p));
+}
+
+
+void
+REGION_Destroy(REGION_Index_t* Index_p)
+{
+    free(Index_p->Columns_p);
+    free(Index_p->Sums_p);
+    REGION_Initialize(Index_p);
+}
+
+
+void
+REGION_Invalidate(REGION_Index_t* Index_p)
+{
+    Index_p->Valid = 0;
+}
+
+
+int
+REGION_Build(REGION_Index_t* Index_p,
+             const int       Width,
+             const int       Height,
+             REGION_GetRow_t GetRow,
+             void*           Context_p,
+             THREADS_Pool_t* Pool_p)
+{
+    const int WordsPerRow = (Width + 63) / 64;
+    const int TilesY      = (Height + REGION_TILE_SIZE - 1) / REGION_TILE_SIZE;
+    RegionBuild_t Build;
+
+    if (Index_p->Valid && Index_p->Width == Width && Index_p->Height == Height)
+    {
+        return 0;
+    }
+
+    if (Index_p->Width != Width || Index_p->Height != Height || Index_p->Columns_p == NULL)
+    {
+        REGION_Destroy(Index_p);
+        Index_p->Columns_p = malloc((size_t)WordsPerRow * Height * sizeof(uint64_t));
+        Index_p->Sums_p    = malloc((size_t)(TilesY + 1) * (WordsPerRow + 1) * sizeof(long long));
+        if (Index_p->Columns_p == NULL || Index_p->Sums_p == NULL)
+        {
+            REGION_Destroy(Index_p);
+            return -1;
+        }
+        Index_p->Width       = Width;
+        Index_p->Height      = Height;
+        Index_p->WordsPerRow = WordsPerRow;
+        Index_p->TilesY      = TilesY;
+    }
+
+    // The workers pack their rows and count their tiles, into the sums
+    // table offset by one row and column
+    Build.Index_p   = Index_p;
+    Build.GetRow    = GetRow;
+    Build.Context_p = Context_p;
+    Build.Rows_p    = malloc((size_t)THREADS_GetNumberOfThreads(Pool_p) * WordsPerRow * sizeof(uint64_t));
+    if (Build.Rows_p == NULL)
+    {
+        return -1;
+    }
+    THREADS_Run(Pool_p, BuildBand, &Build);
+    free(Build.Rows_p);
+
+    // Then the counts are summed along each row, and down each column
+    for (int i = 0; i <= WordsPerRow; i++)
+    {
+        Index_p->Sums_p[i] = 0;
+    }
+    for (int TileY = 1; TileY <= TilesY; TileY++)
+    {
+        long long* Sums_p = Index_p->Sums_p + (size_t)TileY * (WordsPerRow + 1);
+        const long long* Above_p = Sums_p - (WordsPerRow + 1);
+        long long RowSum = 0;
+
+        Sums_p[0] = 0;
+        for (int TileX = 1; TileX <= WordsPerRow; TileX++)
+        {
+            RowSum += Sums_p[TileX];
+            Sums_p[TileX] = Above_p[TileX] + RowSum;
+        }
+    }
+
+    Index_p->Valid = 1;
+    return 0;
+}
+
+
+long long
+REGION_Count(const REGION_Index_t* Index_p,
+             const int             MinColumn,
+             const int             MinRow,
+             const int             MaxColumn,
+             const int             MaxRow)
+{
+    const int Stride    = Index_p->WordsPerRow + 1;
+    const int FirstWord = MinColumn / 64;
+    const int LastWord  = MaxColumn / 64;
+    // The whole tiles are [FirstTileX, EndTileX) x [FirstTileY, EndTileY)
+    const int FirstTileX = (MinColumn + REGION_TILE_SIZE - 1) / REGION_TILE_SIZE;
+    const int FirstTileY = (MinRow + REGION_TILE_SIZE - 1) / REGION_TILE_SIZE;
+    const int EndTileX   = (MaxColumn + 1) / REGION_TILE_SIZE;
+    const int EndTileY   = (MaxRow + 1) / REGION_TILE_SIZE;
+    int WholeRowStart    = MaxRow + 1;
+    int WholeRowEnd      = MaxRow + 1;
+    long long Count      = 0;
+
+    if (FirstTileX < EndTileX && FirstTileY < EndTileY)
+    {
+        const long long* Sums_p = Index_p->Sums_p;
+
+        Count = Sums_p[(size_t)EndTileY * Stride + EndTileX] - Sums_p[(size_t)FirstTileY * Stride + EndTileX] -
+                Sums_p[(size_t)EndTileY * Stride + FirstTileX] + Sums_p[(size_t)FirstTileY * Stride + FirstTileX];
+        WholeRowStart = FirstTileY * REGION_TILE_SIZE;
+        WholeRowEnd   = EndTileY * REGION_TILE_SIZE;
+    }
+
+    // Then each column of words, but for the rows of its whole tiles
+    for (int i = FirstWord; i <= LastWord; i++)
+    {
+        const uint64_t* Column_p = Index_p->Columns_p + (size_t)i * Index_p->Height;
+        uint64_t Mask = ~0ULL;
+
+        if (i == FirstWord)
+        {
+            Mask &= ~0ULL << (MinColumn % 64);
+        }
+        if (i == LastWord)
+        {
+            Mask &= ~0ULL >> (63 - MaxColumn % 64);
+        }
+
+        if (i >= FirstTileX && i < EndTileX)
+        {
+            Count += CountColumn(Column_p, Mask, MinRow, WholeRowStart);
+            Count += CountColumn(Column_p, Mask, WholeRowEnd, MaxRow + 1);
+        }
+        else
+        {
+            Count += CountColumn(Column_p, Mask, MinRow, MaxRow + 1);
+        }
+    }
+    return Count;
+}
+
+
+// Packs and counts the tiles of a band of tile rows
+static void
+BuildBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    RegionBuild_t* Build_p = (RegionBuild_t*)Context_p;
+    REGION_Index_t* Index_p = Build_p->Index_p;
+    const int WordsPerRow = Index_p->WordsPerRow;
+    const int Height      = Index_p->Height;
+    const uint64_t LastMask = (Index_p->Width % 64 == 0) ? ~0ULL : (1ULL << (Index_p->Width % 64)) - 1;
+    uint64_t* Cells_p = Build_p->Rows_p + (size_t)ThreadIndex * WordsPerRow;
+    int Start;
+    int End;
+
+    THREADS_GetBand(Index_p->TilesY, ThreadIndex, NumberOfThreads, &Start, &End);
+
+    for (int TileY = Start; TileY < End; TileY++)
+    {
+        long long* Counts_p = Index_p->Sums_p + (size_t)(TileY + 1) * (WordsPerRow + 1) + 1;
+        const int EndRow = ((TileY + 1) * REGION_TILE_SIZE < Height) ? (TileY + 1) * REGION_TILE_SIZE : Height;
+
+        memset(Counts_p, 0, WordsPerRow * sizeof(long long));
+        for (int Row = TileY * REGION_TILE_SIZE; Row < EndRow; Row++)
+        {
+            Build_p->GetRow(Build_p->Context_p, Row, Cells_p);
+            Cells_p[WordsPerRow - 1] &= LastMask;
+            for (int i = 0; i < WordsPerRow; i++)
+            {
+                Index_p->Columns_p[(size_t)i * Height + Row] = Cells_p[i];
+                Counts_p[i] += __builtin_popcountll(Cells_p[i]);
+            }
+        }
+    }
+}
+
+
+// The live cells under Mask in rows [FirstRow, EndRow) of a column of words
+static long long
+CountColumn(const uint64_t* const Column_p, const uint64_t Mask, const int FirstRow, const int EndRow)
+{
+    long long Count = 0;
+
+    for (int Row = FirstRow; Row < EndRow; Row++)
+    {
+        Count += __builtin_popcountll(Column_p[Row] & Mask);
+    }
+    return Count;
+}
@@ -0,0 +1,79 @@
+/*
+ * Game of Life - REGION Support
+ *
+ * An index for counting the live cells in rectangles of the world. The
+ * world is packed one bit per cell and cut into tiles of 64 x 64 cells,
+ * one word wide, and a summed-area table of the tile populations is kept,
+ * so that the whole tiles in a rectangle are counted in O(1). The cells
+ * of the tiles cut by its edges are counted by popcounts of their words,
+ * which are kept column by column: the words of a 64 cell wide column are
+ * next to each other, so a tall edge is a single run through memory.
+ *
+ * The index is built from any variant's rows when first needed, and is
+ * built again after it has been invalidated.
+ */
+
+#ifndef GOL_REGION_H_
+#define GOL_REGION_H_
+
+#include <stdint.h>
+
+#include "gol_threads.h"
+
+
+#define REGION_TILE_SIZE 64
+
+
+// Packs row Row of the world being indexed, bit c % 64 of word c / 64 is
+// column c. Called from the pool's workers, for different rows at once.
+typedef void (*REGION_GetRow_t)(void* Context_p, const int Row, uint64_t* const Cells_p);
+
+
+typedef struct
+{
+    int        Valid;
+    int        Width;
+    int        Height;
+    int        WordsPerRow;   // Also the number of tiles across
+    int        TilesY;
+    uint64_t*  Columns_p;     // WordsPerRow columns of Height words, one per row
+    long long* Sums_p;        // (TilesY + 1) x (WordsPerRow + 1), the tiles above and left
+} REGION_Index_t;
+
+
+void
+REGION_Initialize(REGION_Index_t* Index_p);
+
+
+void
+REGION_Destroy(REGION_Index_t* Index_p);
+
+
+// Must be called whenever the world indexed changes
+void
+REGION_Invalidate(REGION_Index_t* Index_p);
+
+
+// Builds the index, unless it is valid and of this size. Returns 0, or -1
+// if out of memory (the index is then left invalid).
+int
+REGION_Build(REGION_Index_t* Index_p,
+             const int       Width,
+             const int       Height,
+             REGION_GetRow_t GetRow,
+             void*           Context_p,
+             THREADS_Pool_t* Pool_p);
+
+
+// The live cells in columns MinColumn .. MaxColumn and rows MinRow ..
+// MaxRow (inclusive), which must be inside the world
+long long
+REGION_Count(const REGION_Index_t* Index_p,
+             const int             MinColumn,
+             const int             MinRow,
+             const int             MaxColumn,
+             const int             MaxRow);
+
+
+
+#endif // GOL_REGION_H_
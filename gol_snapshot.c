@@ -0,0 +1,334 @@
+/*
+ * Game of Life - SNAPSHOT Implementation
+ *
+ */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gol_snapshot.h"
+
+
+#define SNAPSHOT_TILE_SIZE   64
+
+
+// Sits in the headroom before buffers allocated here, so the buffer stays
+// aligned. Wrapped buffers have one of their own, on the list of them.
+typedef struct BufferHeader_s
+{
+    int                        RefCount;
+    size_t                     Size;
+    SNAPSHOT_ReleaseFunction_t Release;     // NULL for buffers allocated here
+    void*                      Context_p;
+    const void*                Buffer_p;    // Wrapped buffers only
+    struct BufferHeader_s*     Next_p;      // Wrapped buffers only
+} BufferHeader_t;
+
+
+// The bytes before a wrapped buffer are the caller's, so its header is
+// looked up instead. Buffers allocated here skip the lookup while nothing
+// is wrapped.
+static pthread_mutex_t WrappedLock = PTHREAD_MUTEX_INITIALIZER;
+static BufferHeader_t* Wrapped_p = NULL;
+static int             NumberOfWrapped = 0;
+
+
+static BufferHeader_t*
+GetHeader(const void* Buffer_p);
+
+static void
+KeepBuffer(void* Context_p);
+
+
+void*
+SNAPSHOT_AllocateBuffer(const size_t Size)
+{
+    char* Memory_p;
+    BufferHeader_t* Header_p;
+
+    if (posix_memalign((void**)&Memory_p, 64, SNAPSHOT_HEADROOM + Size) != 0)
+    {
+        return NULL;
+    }
+    Header_p = (BufferHeader_t*)Memory_p;
+    Header_p->RefCount  = 1;
+    Header_p->Size      = Size;
+    Header_p->Release   = NULL;
+    Header_p->Context_p = NULL;
+    return Memory_p + SNAPSHOT_HEADROOM;
+}
+
+
+void*
+SNAPSHOT_WrapBuffer(void*                            Buffer_p,
+                    const size_t                     Size,
+                    const SNAPSHOT_ReleaseFunction_t Release,
+                    void*                            Context_p)
+{
+    BufferHeader_t* Header_p = malloc(sizeof(BufferHeader_t));
+
+    if (Header_p == NULL)
+    {
+        return NULL;
+    }
+    Header_p->RefCount  = 1;
+    Header_p->Size      = Size;
+    Header_p->Release   = (Release != NULL) ? Release : KeepBuffer;
+    Header_p->Context_p = Context_p;
+    Header_p->Buffer_p  = Buffer_p;
+
+    pthread_mutex_lock(&WrappedLock);
+    Header_p->Next_p = Wrapped_p;
+    Wrapped_p = Header_p;
+    __atomic_add_fetch(&NumberOfWrapped, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&WrappedLock);
+    return Buffer_p;
+}
+
+
+void
+SNAPSHOT_RetainBuffer(const void* Buffer_p)
+{
+    __atomic_add_fetch(&GetHeader(Buffer_p)->RefCount, 1, __ATOMIC_RELAXED);
+}
+
+
+void
+SNAPSHOT_ReleaseBuffer(const void* Buffer_p)
+{
+    BufferHeader_t* Header_p;
+
+    if (Buffer_p == NULL)
+    {
+        return;
+    }
+
+    Header_p = GetHeader(Buffer_p);
+    if (__atomic_sub_fetch(&Header_p->RefCount, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        if (Header_p->Release != NULL)
+        {
+            BufferHeader_t** Link_pp = &Wrapped_p;
+
+            pthread_mutex_lock(&WrappedLock);
+            while (*Link_pp != Header_p)
+            {
+                Link_pp = &(*Link_pp)->Next_p;
+            }
+            *Link_pp = Header_p->Next_p;
+            __atomic_sub_fetch(&NumberOfWrapped, 1, __ATOMIC_RELEASE);
+            pthread_mutex_unlock(&WrappedLock);
+
+            Header_p->Release(Header_p->Context_p);
+        }
+        free(Header_p);
+    }
+}
+
+
+int
+SNAPSHOT_UnshareBuffer(void** Buffer_pp, const int KeepContents)
+{
+    BufferHeader_t* Header_p = GetHeader(*Buffer_pp);
+    void* NewBuffer_p;
+
+    // Only the caller can add references to its own buffer, so once it
+    // is the only holder it stays that way
+    if (__atomic_load_n(&Header_p->RefCount, __ATOMIC_ACQUIRE) == 1)
+    {
+        return 0;
+    }
+
+    if ((NewBuffer_p = SNAPSHOT_AllocateBuffer(Header_p->Size)) == NULL)
+    {
+        return -1;
+    }
+    if (KeepContents)
+    {
+        memcpy(NewBuffer_p, *Buffer_pp, Header_p->Size);
+    }
+    else
+    {
+        memset(NewBuffer_p, 0, Header_p->Size);
+    }
+    SNAPSHOT_ReleaseBuffer(*Buffer_pp);
+    *Buffer_pp = NewBuffer_p;
+    return 1;
+}
+
+
+SNAPSHOT_t*
+SNAPSHOT_Create(const SNAPSHOT_Layout_t Layout,
+                const int               Width,
+                const int               Height,
+                const int               Stride,
+                const void*             Buffer_p,
+                const int*              TileIndex_p,
+                const long long         Generation)
+{
+    SNAPSHOT_t* Snapshot_p = malloc(sizeof(SNAPSHOT_t));
+
+    if (Snapshot_p == NULL)
+    {
+        return NULL;
+    }
+
+    Snapshot_p->RefCount    = 1;
+    Snapshot_p->Generation  = Generation;
+    Snapshot_p->Layout      = Layout;
+    Snapshot_p->Width       = Width;
+    Snapshot_p->Height      = Height;
+    Snapshot_p->Stride      = Stride;
+    Snapshot_p->OriginColumn = 0;
+    Snapshot_p->OriginRow    = 0;
+    Snapshot_p->Buffer_p    = Buffer_p;
+    Snapshot_p->TileIndex_p = TileIndex_p;
+
+    SNAPSHOT_RetainBuffer(Buffer_p);
+    if (TileIndex_p != NULL)
+    {
+        SNAPSHOT_RetainBuffer(TileIndex_p);
+    }
+    return Snapshot_p;
+}
+
+
+void
+SNAPSHOT_Retain(SNAPSHOT_t* Snapshot_p)
+{
+    __atomic_add_fetch(&Snapshot_p->RefCount, 1, __ATOMIC_RELAXED);
+}
+
+
+void
+SNAPSHOT_Release(SNAPSHOT_t* Snapshot_p)
+{
+    if (Snapshot_p != NULL && __atomic_sub_fetch(&Snapshot_p->RefCount, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        SNAPSHOT_ReleaseBuffer(Snapshot_p->Buffer_p);
+        SNAPSHOT_ReleaseBuffer(Snapshot_p->TileIndex_p);
+        free(Snapshot_p);
+    }
+}
+
+
+int
+SNAPSHOT_GetCellState(const SNAPSHOT_t* Snapshot_p, const int Column, const int Row)
+{
+    switch (Snapshot_p->Layout)
+    {
+    case SNAPSHOT_LAYOUT_BYTES:
+    {
+        const unsigned char* Cells_p = Snapshot_p->Buffer_p;
+        return Cells_p[(size_t)(Row + 1) * Snapshot_p->Stride + Column + 1];
+    }
+
+    case SNAPSHOT_LAYOUT_BITS:
+    {
+        const uint32_t* Uints_p = Snapshot_p->Buffer_p;
+        const int Bit = Column + 1;
+        return (Uints_p[(size_t)(Row + 1) * Snapshot_p->Stride + Bit / 32] >> (Bit % 32)) & 1;
+    }
+
+    case SNAPSHOT_LAYOUT_TILES:
+    {
+        const uint64_t* Words_p = Snapshot_p->Buffer_p;
+        const int TilesX = (Snapshot_p->Width + SNAPSHOT_TILE_SIZE - 1) / SNAPSHOT_TILE_SIZE;
+        const int Position = Snapshot_p->TileIndex_p[(Row / SNAPSHOT_TILE_SIZE) * TilesX +
+                                                     Column / SNAPSHOT_TILE_SIZE];
+        return (Words_p[(size_t)Position * Snapshot_p->Stride + Row % SNAPSHOT_TILE_SIZE] >>
+                (Column % SNAPSHOT_TILE_SIZE)) & 1;
+    }
+
+    default:
+        return 0;
+    }
+}
+
+
+void
+SNAPSHOT_GetRow(const SNAPSHOT_t* Snapshot_p, const int Row, uint64_t* const Cells_p)
+{
+    const int NumberOfWords = (Snapshot_p->Width + 63) / 64;
+
+    switch (Snapshot_p->Layout)
+    {
+    case SNAPSHOT_LAYOUT_BYTES:
+    {
+        const unsigned char* Row_p = (const unsigned char*)Snapshot_p->Buffer_p +
+                                     (size_t)(Row + 1) * Snapshot_p->Stride + 1;
+
+        memset(Cells_p, 0, NumberOfWords * sizeof(uint64_t));
+        for (int Column = 0; Column < Snapshot_p->Width; Column++)
+        {
+            Cells_p[Column / 64] |= (uint64_t)Row_p[Column] << (Column % 64);
+        }
+        break;
+    }
+
+    case SNAPSHOT_LAYOUT_BITS:
+    {
+        // Storage bit b is column b - 1, so everything moves down one bit
+        const uint32_t* Row_p = (const uint32_t*)Snapshot_p->Buffer_p + (size_t)(Row + 1) * Snapshot_p->Stride;
+
+        for (int i = 0; i < NumberOfWords; i++)
+        {
+            uint64_t Word = Row_p[2 * i];
+            Word |= (2 * i + 1 < Snapshot_p->Stride) ? (uint64_t)Row_p[2 * i + 1] << 32 : 0;
+            Word >>= 1;
+            Word |= (2 * i + 2 < Snapshot_p->Stride) ? (uint64_t)Row_p[2 * i + 2] << 63 : 0;
+            Cells_p[i] = Word;
+        }
+        break;
+    }
+
+    case SNAPSHOT_LAYOUT_TILES:
+    {
+        // Tile rows line up with the words of the row
+        const uint64_t* Words_p = Snapshot_p->Buffer_p;
+        const int* Index_p = Snapshot_p->TileIndex_p + (Row / SNAPSHOT_TILE_SIZE) * NumberOfWords;
+
+        for (int i = 0; i < NumberOfWords; i++)
+        {
+            Cells_p[i] = Words_p[(size_t)Index_p[i] * Snapshot_p->Stride + Row % SNAPSHOT_TILE_SIZE];
+        }
+        break;
+    }
+
+    default:
+        memset(Cells_p, 0, NumberOfWords * sizeof(uint64_t));
+        for (int Column = 0; Column < Snapshot_p->Width; Column++)
+        {
+            Cells_p[Column / 64] |= (uint64_t)SNAPSHOT_GetCellState(Snapshot_p, Column, Row) << (Column % 64);
+        }
+        break;
+    }
+}
+
+
+static BufferHeader_t*
+GetHeader(const void* Buffer_p)
+{
+    BufferHeader_t* Header_p = NULL;
+
+    if (__atomic_load_n(&NumberOfWrapped, __ATOMIC_ACQUIRE) > 0)
+    {
+        pthread_mutex_lock(&WrappedLock);
+        Header_p = Wrapped_p;
+        while (Header_p != NULL && Header_p->Buffer_p != Buffer_p)
+        {
+            Header_p = Header_p->Next_p;
+        }
+        pthread_mutex_unlock(&WrappedLock);
+    }
+    return (Header_p != NULL) ? Header_p : (BufferHeader_t*)((char*)Buffer_p - SNAPSHOT_HEADROOM);
+}
+
+
+// The release function of wrapped buffers that the caller frees itself
+static void
+KeepBuffer(void* Context_p)
+{
+    (void)Context_p;
+}
@@ -0,0 +1,123 @@
+/*
+ * Game of Life - SNAPSHOT Support
+ *
+ * World buffers are reference counted, so that a finished generation can
+ * be handed to readers on other threads without copying it. A world holds
+ * one reference to each buffer it evolves in, and each snapshot holds one
+ * to the buffer of its generation. A world never writes to a buffer that
+ * anyone else still holds: it lets go of it and takes a new one instead,
+ * and the last release frees the old buffer.
+ */
+
+#ifndef GOL_SNAPSHOT_H_
+#define GOL_SNAPSHOT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Bytes before each buffer allocated here that hold its reference count
+#define SNAPSHOT_HEADROOM   64
+
+
+typedef void (*SNAPSHOT_ReleaseFunction_t)(void* Context_p);
+
+
+typedef enum
+{
+    SNAPSHOT_LAYOUT_BYTES,   // ARRAY: one byte per cell, one cell of halo around
+    SNAPSHOT_LAYOUT_BITS,    // BITS: 32-bit uints, storage bit 1 is column 0, halo rows
+    SNAPSHOT_LAYOUT_TILES,   // TILES: 64x64 tiles, uint64_t rows first in each tile
+
+    SNAPSHOT_LAYOUT_LAST_ENTRY
+} SNAPSHOT_Layout_t;
+
+
+typedef struct
+{
+    int               RefCount;
+    long long         Generation;
+    SNAPSHOT_Layout_t Layout;
+    int               Width;
+    int               Height;
+    int               Stride;        // Bytes or uints per row, or uint64_t per tile
+    int               OriginColumn;  // Of cell (0, 0), where the world has moved it to by growing
+    int               OriginRow;
+    const void*       Buffer_p;      // A reference is held
+    const int*        TileIndex_p;   // TILES only: tile (X, Y) by position, a reference is held
+} SNAPSHOT_t;
+
+
+// Returns a buffer of Size bytes, aligned to a cache line, with one
+// reference. The contents are not initialized.
+void*
+SNAPSHOT_AllocateBuffer(const size_t Size);
+
+
+/*
+ * Makes a buffer of the caller's into one that can be held, with one
+ * reference, or returns NULL if out of memory. The reference count is kept
+ * apart, nothing outside the buffer is touched. Release (if not NULL) is
+ * called with Context_p when the last reference is released, the buffer
+ * itself is never freed here.
+ */
+void*
+SNAPSHOT_WrapBuffer(void*                            Buffer_p,
+                    const size_t                     Size,
+                    const SNAPSHOT_ReleaseFunction_t Release,
+                    void*                            Context_p);
+
+
+void
+SNAPSHOT_RetainBuffer(const void* Buffer_p);
+
+
+// Frees the buffer when the last reference is released. NULL is ignored.
+void
+SNAPSHOT_ReleaseBuffer(const void* Buffer_p);
+
+
+/*
+ * If anyone but the caller holds *Buffer_pp, releases it and puts a new
+ * buffer of the same size in its place, holding a copy of the contents if
+ * KeepContents is set and cleared otherwise. Returns 1 if the buffer was
+ * replaced, 0 if the caller was the only holder, or -1 if out of memory,
+ * with *Buffer_pp left as it was (and still shared).
+ */
+int
+SNAPSHOT_UnshareBuffer(void** Buffer_pp, const int KeepContents);
+
+
+// Returns a snapshot with one reference, holding references to Buffer_p
+// and TileIndex_p (which may be NULL), or NULL if out of memory. The
+// origin is (0, 0).
+SNAPSHOT_t*
+SNAPSHOT_Create(const SNAPSHOT_Layout_t Layout,
+                const int               Width,
+                const int               Height,
+                const int               Stride,
+                const void*             Buffer_p,
+                const int*              TileIndex_p,
+                const long long         Generation);
+
+
+void
+SNAPSHOT_Retain(SNAPSHOT_t* Snapshot_p);
+
+
+// NULL is ignored
+void
+SNAPSHOT_Release(SNAPSHOT_t* Snapshot_p);
+
+
+int
+SNAPSHOT_GetCellState(const SNAPSHOT_t* Snapshot_p, const int Column, const int Row);
+
+
+// Packs a row, bit c % 64 of word c / 64 is column c
+void
+SNAPSHOT_GetRow(const SNAPSHOT_t* Snapshot_p, const int Row, uint64_t* const Cells_p);
+
+
+
+#endif // GOL_SNAPSHOT_H_
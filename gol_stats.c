@@ -0,0 +1,99 @@
+/*
+ * Game of Life - STATS Implementation
+ *
+ */
+#include <limits.h>
+
+#include "gol_stats.h"
+
+
+void
+STATS_Reset(STATS_t* Stats_p)
+{
+    Stats_p->Population = 0;
+    Stats_p->MinColumn  = INT_MAX;
+    Stats_p->MaxColumn  = INT_MIN;
+    Stats_p->MinRow     = INT_MAX;
+    Stats_p->MaxRow     = INT_MIN;
+}
+
+
+void
+STATS_SetFull(STATS_t* Stats_p, const int Width, const int Height)
+{
+    Stats_p->Population = (long long)Width * Height;
+    Stats_p->MinColumn  = 0;
+    Stats_p->MaxColumn  = Width - 1;
+    Stats_p->MinRow     = 0;
+    Stats_p->MaxRow     = Height - 1;
+}
+
+
+void
+STATS_AddRow(STATS_t*        Stats_p,
+             const int       Row,
+             const long long Population,
+             const int       MinColumn,
+             const int       MaxColumn)
+{
+    if (Population == 0)
+    {
+        return;
+    }
+
+    Stats_p->Population += Population;
+    if (Row < Stats_p->MinRow)
+    {
+        Stats_p->MinRow = Row;
+    }
+    if (Row > Stats_p->MaxRow)
+    {
+        Stats_p->MaxRow = Row;
+    }
+    if (MinColumn < Stats_p->MinColumn)
+    {
+        Stats_p->MinColumn = MinColumn;
+    }
+    if (MaxColumn > Stats_p->MaxColumn)
+    {
+        Stats_p->MaxColumn = MaxColumn;
+    }
+}
+
+
+void
+STATS_Merge(STATS_t* Stats_p, const STATS_t* const Other_p)
+{
+    Stats_p->Population += Other_p->Population;
+    if (Other_p->MinRow < Stats_p->MinRow)
+    {
+        Stats_p->MinRow = Other_p->MinRow;
+    }
+    if (Other_p->MaxRow > Stats_p->MaxRow)
+    {
+        Stats_p->MaxRow = Other_p->MaxRow;
+    }
+    if (Other_p->MinColumn < Stats_p->MinColumn)
+    {
+        Stats_p->MinColumn = Other_p->MinColumn;
+    }
+    if (Other_p->MaxColumn > Stats_p->MaxColumn)
+    {
+        Stats_p->MaxColumn = Other_p->MaxColumn;
+    }
+}
+
+
+void
+STATS_Shift(STATS_t* Stats_p, const int ColumnShift, const int RowShift)
+{
+    if (Stats_p->Population == 0)
+    {
+        return;
+    }
+
+    Stats_p->MinColumn += ColumnShift;
+    Stats_p->MaxColumn += ColumnShift;
+    Stats_p->MinRow    += RowShift;
+    Stats_p->MaxRow    += RowShift;
+}
@@ -0,0 +1,49 @@
+/*
+ * Game of Life - STATS Support
+ *
+ * Population and bounding box of the live cells in a world. The evolve
+ * kernels fill these in as a side product of computing a generation.
+ */
+
+#ifndef GOL_STATS_H_
+#define GOL_STATS_H_
+
+
+typedef struct
+{
+    long long Population;
+    int       MinColumn;   // MinColumn > MaxColumn when the world is empty
+    int       MaxColumn;
+    int       MinRow;      // MinRow > MaxRow when the world is empty
+    int       MaxRow;
+} STATS_t;
+
+
+void
+STATS_Reset(STATS_t* Stats_p);
+
+
+// Stats that cover every row and column, for worlds not yet scanned
+void
+STATS_SetFull(STATS_t* Stats_p, const int Width, const int Height);
+
+
+void
+STATS_AddRow(STATS_t*        Stats_p,
+             const int       Row,
+             const long long Population,
+             const int       MinColumn,
+             const int       MaxColumn);
+
+
+void
+STATS_Merge(STATS_t* Stats_p, const STATS_t* const Other_p);
+
+
+// For worlds whose contents have been moved by (ColumnShift, RowShift)
+void
+STATS_Shift(STATS_t* Stats_p, const int ColumnShift, const int RowShift);
+
+
+
+#endif // GOL_STATS_H_
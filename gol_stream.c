@@ -0,0 +1,239 @@
+/*
+ * Game of Life - STREAM Implementation
+ *
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gol_stream.h"
+
+
+typedef struct
+{
+    const uint_t* Window_p;     // Row before the chunk, the chunk, row after
+    uint_t*       Evolved_p;
+    int           NumberOfRows;
+    int           NumberOfUintsPerRow;
+    int           Width;
+} Chunk_t;
+
+
+static int
+ReadFully(const int Fd, void* Buffer_p, size_t Size, off_t Offset);
+
+static int
+WriteFully(const int Fd, const void* Buffer_p, size_t Size, off_t Offset);
+
+static void
+EvolveChunkBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+
+int
+STREAM_ReadHeader(const int Fd, STREAM_Header_t* Header_p)
+{
+    const int UintInBits = sizeof(uint_t) * 8;
+
+    if (ReadFully(Fd, Header_p, sizeof(*Header_p), 0) != 0)
+    {
+        return -1;
+    }
+    if (memcmp(Header_p->Magic, STREAM_MAGIC, sizeof(Header_p->Magic)) != 0 ||
+        Header_p->Width <= 0 || Header_p->Height <= 0 ||
+        Header_p->NumberOfUintsPerRow != (Header_p->Width + 2 + (UintInBits - 1)) / UintInBits)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+
+int
+STREAM_WriteHeader(const int Fd, const int Width, const int Height)
+{
+    const int UintInBits = sizeof(uint_t) * 8;
+    STREAM_Header_t Header;
+
+    memset(&Header, 0, sizeof(Header));
+    memcpy(Header.Magic, STREAM_MAGIC, sizeof(Header.Magic));
+    Header.Width  = Width;
+    Header.Height = Height;
+    Header.NumberOfUintsPerRow = (Width + 2 + (UintInBits - 1)) / UintInBits;
+
+    return WriteFully(Fd, &Header, sizeof(Header), 0);
+}
+
+
+int
+STREAM_EvolveFile(const int       SourceFd,
+                  const int       TargetFd,
+                  THREADS_Pool_t* Pool_p)
+{
+    STREAM_Header_t Header;
+    size_t BytesPerRow;
+    int RowsPerChunk;
+    uint_t* Window_p;
+    uint_t* Evolved_p;
+    int Result = 0;
+
+    if (STREAM_ReadHeader(SourceFd, &Header) != 0 ||
+        STREAM_WriteHeader(TargetFd, Header.Width, Header.Height) != 0)
+    {
+        return -1;
+    }
+
+    BytesPerRow  = Header.NumberOfUintsPerRow * sizeof(uint_t);
+    RowsPerChunk = STREAM_CHUNK_IN_BYTES / BytesPerRow;
+    if (RowsPerChunk < 1)
+    {
+        RowsPerChunk = 1;
+    }
+    if (RowsPerChunk > Header.Height)
+    {
+        RowsPerChunk = Header.Height;
+    }
+
+    Window_p  = malloc((RowsPerChunk + 2) * BytesPerRow);
+    Evolved_p = malloc(RowsPerChunk * BytesPerRow);
+    if (Window_p == NULL || Evolved_p == NULL)
+    {
+        free(Window_p);
+        free(Evolved_p);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    posix_fadvise(SourceFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    for (int Start = 0; Start < Header.Height && Result == 0; Start += RowsPerChunk)
+    {
+        int End      = (Start + RowsPerChunk < Header.Height) ? Start + RowsPerChunk : Header.Height;
+        int ReadFrom = (Start > 0) ? Start - 1 : 0;
+        int ReadTo   = (End < Header.Height) ? End + 1 : Header.Height;
+        uint_t* Destination_p = Window_p + (size_t)(ReadFrom - (Start - 1)) * Header.NumberOfUintsPerRow;
+        Chunk_t Chunk;
+
+        // One large read per chunk, the two rows around it are read twice
+        Result = ReadFully(SourceFd, Destination_p, (ReadTo - ReadFrom) * BytesPerRow,
+                           sizeof(Header) + (off_t)ReadFrom * BytesPerRow);
+        if (Result != 0)
+        {
+            break;
+        }
+        if (Start == 0)
+        {
+            memset(Window_p, 0, BytesPerRow);
+        }
+        if (End == Header.Height)
+        {
+            memset(Window_p + (size_t)(End - Start + 1) * Header.NumberOfUintsPerRow, 0, BytesPerRow);
+        }
+
+        // Let the kernel fetch the next chunk while this one is computed
+        if (End < Header.Height)
+        {
+            posix_fadvise(SourceFd, sizeof(Header) + (off_t)End * BytesPerRow,
+                          (off_t)RowsPerChunk * BytesPerRow, POSIX_FADV_WILLNEED);
+        }
+
+        Chunk.Window_p            = Window_p;
+        Chunk.Evolved_p           = Evolved_p;
+        Chunk.NumberOfRows        = End - Start;
+        Chunk.NumberOfUintsPerRow = Header.NumberOfUintsPerRow;
+        Chunk.Width               = Header.Width;
+        THREADS_Run(Pool_p, EvolveChunkBand, &Chunk);
+
+        Result = WriteFully(TargetFd, Evolved_p, (End - Start) * BytesPerRow,
+                            sizeof(Header) + (off_t)Start * BytesPerRow);
+
+        // Rows before this chunk will not be read again in this generation
+        if (ReadFrom > 0)
+        {
+            posix_fadvise(SourceFd, 0, sizeof(Header) + (off_t)ReadFrom * BytesPerRow,
+                          POSIX_FADV_DONTNEED);
+        }
+    }
+
+    free(Window_p);
+    free(Evolved_p);
+    return Result;
+}
+
+
+static void
+EvolveChunkBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    Chunk_t* Chunk_p = (Chunk_t*)Context_p;
+    const size_t Stride = Chunk_p->NumberOfUintsPerRow;
+    int Start;
+    int End;
+
+    THREADS_GetBand(Chunk_p->NumberOfRows, ThreadIndex, NumberOfThreads, &Start, &End);
+
+    for (int Row = Start; Row < End; Row++)
+    {
+        // Window row Row + 1 is chunk row Row
+        BITS_EvolveRow(Chunk_p->Window_p + Row * Stride,
+                       Chunk_p->Window_p + (Row + 1) * Stride,
+                       Chunk_p->Window_p + (Row + 2) * Stride,
+                       Chunk_p->Evolved_p + Row * Stride,
+                       Chunk_p->NumberOfUintsPerRow,
+                       Chunk_p->Width);
+    }
+}
+
+
+static int
+ReadFully(const int Fd, void* Buffer_p, size_t Size, off_t Offset)
+{
+    char* Position_p = Buffer_p;
+
+    while (Size > 0)
+    {
+        ssize_t Count = pread(Fd, Position_p, Size, Offset);
+        if (Count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (Count <= 0)
+        {
+            if (Count == 0)
+            {
+                errno = EIO;  // Truncated file
+            }
+            return -1;
+        }
+        Position_p += Count;
+        Offset     += Count;
+        Size       -= Count;
+    }
+    return 0;
+}
+
+
+static int
+WriteFully(const int Fd, const void* Buffer_p, size_t Size, off_t Offset)
+{
+    const char* Position_p = Buffer_p;
+
+    while (Size > 0)
+    {
+        ssize_t Count = pwrite(Fd, Position_p, Size, Offset);
+        if (Count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (Count < 0)
+        {
+            return -1;
+        }
+        Position_p += Count;
+        Offset     += Count;
+        Size       -= Count;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * Game of Life - STREAM (out-of-core) Support
+ *
+ * A packed world file is a STREAM_Header_t followed by Height rows of
+ * NumberOfUintsPerRow uint_t each, laid out exactly like a BITS row
+ * (bit 0 of the first uint is the left halo and always clear). The halo
+ * rows above and below the world are not stored.
+ *
+ * Evolving a packed file never holds more than a few chunks of rows in
+ * memory, so the world may be much larger than RAM.
+ */
+
+#ifndef GOL_STREAM_H_
+#define GOL_STREAM_H_
+
+#include <stdint.h>
+
+#include "gol_bits.h"
+#include "gol_threads.h"
+
+
+#define STREAM_MAGIC           "GOLPACK1"
+
+// Rows are read and written this many bytes at a time
+#ifndef STREAM_CHUNK_IN_BYTES
+#define STREAM_CHUNK_IN_BYTES  (8 * 1024 * 1024)
+#endif
+
+
+typedef struct
+{
+    char    Magic[8];
+    int32_t Width;
+    int32_t Height;
+    int32_t NumberOfUintsPerRow;
+    int32_t Reserved;
+} STREAM_Header_t;
+
+
+// Returns 0 on success, and -1 (with errno set) on failure.
+int
+STREAM_ReadHeader(const int Fd, STREAM_Header_t* Header_p);
+
+
+int
+STREAM_WriteHeader(const int Fd, const int Width, const int Height);
+
+
+// Writes one generation of Source_p to Target_p, rows in both files are
+// found through the header of the source. Returns 0 on success.
+int
+STREAM_EvolveFile(const int       SourceFd,
+                  const int       TargetFd,
+                  THREADS_Pool_t* Pool_p);
+
+
+
+#endif // GOL_STREAM_H_
@@ -0,0 +1,376 @@
+/*
+ * Game of Life - THREADS Implementation
+ *
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "gol_threads.h"
+
+
+typedef struct
+{
+    THREADS_Pool_t* Pool_p;
+    int             Index;
+} Worker_t;
+
+
+typedef struct
+{
+    THREADS_Pool_t*        Pool_p;
+    THREADS_TaskFunction_t Function;
+    void*                  Context_p;
+} TaskRun_t;
+
+
+static void*
+WorkerMain(void* Argument_p);
+
+static void
+PinWorker(const int Index, const int NumberOfThreads);
+
+static void
+RunTasksWorker(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+static int
+TakeTask(THREADS_Deque_t* Deque_p, const int FromEnd);
+
+
+int
+THREADS_CreatePool(THREADS_Pool_t* Pool_p,
+                   const int       NumberOfThreads,
+                   const int       PinThreads)
+{
+    Worker_t* Workers_p;
+
+    Pool_p->NumberOfThreads = (NumberOfThreads > 1) ? NumberOfThreads : 1;
+    Pool_p->PinThreads      = PinThreads;
+    Pool_p->Threads_p       = NULL;
+    Pool_p->JobNumber       = 0;
+    Pool_p->Pending         = 0;
+    Pool_p->Shutdown        = 0;
+    Pool_p->Function        = NULL;
+    Pool_p->Context_p       = NULL;
+    Pool_p->Deques_p        = NULL;
+
+    if (Pool_p->NumberOfThreads == 1)
+    {
+        return 0;
+    }
+
+    Pool_p->Threads_p = malloc(Pool_p->NumberOfThreads * sizeof(pthread_t));
+    Workers_p = malloc(Pool_p->NumberOfThreads * sizeof(Worker_t));
+    if (posix_memalign((void**)&Pool_p->Deques_p, 64,
+                       Pool_p->NumberOfThreads * sizeof(THREADS_Deque_t)) != 0)
+    {
+        Pool_p->Deques_p = NULL;
+    }
+    if (Pool_p->Threads_p == NULL || Workers_p == NULL || Pool_p->Deques_p == NULL)
+    {
+        free(Pool_p->Threads_p);
+        free(Workers_p);
+        free(Pool_p->Deques_p);
+        Pool_p->Threads_p = NULL;
+        Pool_p->Deques_p  = NULL;
+        Pool_p->NumberOfThreads = 1;
+        return -1;
+    }
+
+    pthread_mutex_init(&Pool_p->Lock, NULL);
+    pthread_cond_init(&Pool_p->StartCondition, NULL);
+    pthread_cond_init(&Pool_p->DoneCondition, NULL);
+
+    for (int i = 0; i < Pool_p->NumberOfThreads; i++)
+    {
+        Workers_p[i].Pool_p = Pool_p;
+        Workers_p[i].Index  = i;
+    }
+
+    for (int i = 0; i < Pool_p->NumberOfThreads; i++)
+    {
+        if (pthread_create(&Pool_p->Threads_p[i], NULL, WorkerMain, &Workers_p[i]) != 0)
+        {
+            // Tear down whatever was started and fall back to one thread
+            pthread_mutex_lock(&Pool_p->Lock);
+            Pool_p->Shutdown = 1;
+            pthread_cond_broadcast(&Pool_p->StartCondition);
+            pthread_mutex_unlock(&Pool_p->Lock);
+            for (int j = 0; j < i; j++)
+            {
+                pthread_join(Pool_p->Threads_p[j], NULL);
+            }
+            pthread_cond_destroy(&Pool_p->DoneCondition);
+            pthread_cond_destroy(&Pool_p->StartCondition);
+            pthread_mutex_destroy(&Pool_p->Lock);
+            free(Pool_p->Threads_p);
+            free(Workers_p);
+            free(Pool_p->Deques_p);
+            Pool_p->Threads_p = NULL;
+            Pool_p->Deques_p  = NULL;
+            Pool_p->NumberOfThreads = 1;
+            return -1;
+        }
+    }
+
+    // The workers copy their arguments before the first job is posted
+    pthread_mutex_lock(&Pool_p->Lock);
+    while (Pool_p->Pending < Pool_p->NumberOfThreads)
+    {
+        pthread_cond_wait(&Pool_p->DoneCondition, &Pool_p->Lock);
+    }
+    Pool_p->Pending = 0;
+    pthread_mutex_unlock(&Pool_p->Lock);
+    free(Workers_p);
+
+    return 0;
+}
+
+
+void
+THREADS_DestroyPool(THREADS_Pool_t* Pool_p)
+{
+    if (Pool_p->Threads_p == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&Pool_p->Lock);
+    Pool_p->Shutdown = 1;
+    pthread_cond_broadcast(&Pool_p->StartCondition);
+    pthread_mutex_unlock(&Pool_p->Lock);
+
+    for (int i = 0; i < Pool_p->NumberOfThreads; i++)
+    {
+        pthread_join(Pool_p->Threads_p[i], NULL);
+    }
+
+    pthread_cond_destroy(&Pool_p->DoneCondition);
+    pthread_cond_destroy(&Pool_p->StartCondition);
+    pthread_mutex_destroy(&Pool_p->Lock);
+    free(Pool_p->Threads_p);
+    free(Pool_p->Deques_p);
+    Pool_p->Threads_p = NULL;
+    Pool_p->Deques_p  = NULL;
+}
+
+
+void
+THREADS_Run(THREADS_Pool_t*    Pool_p,
+            THREADS_Function_t Function,
+            void*              Context_p)
+{
+    if (Pool_p == NULL || Pool_p->Threads_p == NULL)
+    {
+        Function(Context_p, 0, 1);
+        return;
+    }
+
+    pthread_mutex_lock(&Pool_p->Lock);
+    Pool_p->Function  = Function;
+    Pool_p->Context_p = Context_p;
+    Pool_p->Pending   = Pool_p->NumberOfThreads;
+    Pool_p->JobNumber++;
+    pthread_cond_broadcast(&Pool_p->StartCondition);
+    while (Pool_p->Pending > 0)
+    {
+        pthread_cond_wait(&Pool_p->DoneCondition, &Pool_p->Lock);
+    }
+    pthread_mutex_unlock(&Pool_p->Lock);
+}
+
+
+void
+THREADS_RunTasks(THREADS_Pool_t*        Pool_p,
+                 const int              NumberOfTasks,
+                 THREADS_TaskFunction_t Function,
+                 void*                  Context_p)
+{
+    TaskRun_t Run;
+
+    if (Pool_p == NULL || Pool_p->Threads_p == NULL)
+    {
+        for (int Task = 0; Task < NumberOfTasks; Task++)
+        {
+            Function(Context_p, Task, 0);
+        }
+        return;
+    }
+
+    for (int i = 0; i < Pool_p->NumberOfThreads; i++)
+    {
+        int Start;
+        int End;
+
+        THREADS_GetBand(NumberOfTasks, i, Pool_p->NumberOfThreads, &Start, &End);
+        Pool_p->Deques_p[i].Range = ((uint64_t)Start << 32) | (uint32_t)End;
+    }
+
+    Run.Pool_p    = Pool_p;
+    Run.Function  = Function;
+    Run.Context_p = Context_p;
+    THREADS_Run(Pool_p, RunTasksWorker, &Run);
+}
+
+
+int
+THREADS_GetNumberOfThreads(const THREADS_Pool_t* Pool_p)
+{
+    return (Pool_p == NULL) ? 1 : Pool_p->NumberOfThreads;
+}
+
+
+void
+THREADS_GetBand(const int Total,
+                const int Index,
+                const int Count,
+                int*      Start_p,
+                int*      End_p)
+{
+    *Start_p = (int)(((long long)Total * Index) / Count);
+    *End_p   = (int)(((long long)Total * (Index + 1)) / Count);
+}
+
+
+static void*
+WorkerMain(void* Argument_p)
+{
+    Worker_t* Worker_p = (Worker_t*)Argument_p;
+    THREADS_Pool_t* Pool_p = Worker_p->Pool_p;
+    const int Index = Worker_p->Index;
+    unsigned int SeenJobNumber = 0;
+
+    if (Pool_p->PinThreads)
+    {
+        PinWorker(Index, Pool_p->NumberOfThreads);
+    }
+
+    pthread_mutex_lock(&Pool_p->Lock);
+    Pool_p->Pending++;
+    pthread_cond_signal(&Pool_p->DoneCondition);
+
+    for (;;)
+    {
+        while (!Pool_p->Shutdown && Pool_p->JobNumber == SeenJobNumber)
+        {
+            pthread_cond_wait(&Pool_p->StartCondition, &Pool_p->Lock);
+        }
+        if (Pool_p->Shutdown)
+        {
+            break;
+        }
+        SeenJobNumber = Pool_p->JobNumber;
+        pthread_mutex_unlock(&Pool_p->Lock);
+
+        Pool_p->Function(Pool_p->Context_p, Index, Pool_p->NumberOfThreads);
+
+        pthread_mutex_lock(&Pool_p->Lock);
+        if (--Pool_p->Pending == 0)
+        {
+            pthread_cond_signal(&Pool_p->DoneCondition);
+        }
+    }
+    pthread_mutex_unlock(&Pool_p->Lock);
+
+    return NULL;
+}
+
+
+/*
+ * No tasks are added while the tasks run, so once a worker has emptied its
+ * own range and then found every other range empty, all tasks are taken.
+ */
+static void
+RunTasksWorker(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    TaskRun_t* Run_p = (TaskRun_t*)Context_p;
+    THREADS_Deque_t* Deques_p = Run_p->Pool_p->Deques_p;
+    int Task;
+
+    while ((Task = TakeTask(&Deques_p[ThreadIndex], 0)) >= 0)
+    {
+        Run_p->Function(Run_p->Context_p, Task, ThreadIndex);
+    }
+
+    for (int i = 1; i < NumberOfThreads; i++)
+    {
+        THREADS_Deque_t* Victim_p = &Deques_p[(ThreadIndex + i) % NumberOfThreads];
+        while ((Task = TakeTask(Victim_p, 1)) >= 0)
+        {
+            Run_p->Function(Run_p->Context_p, Task, ThreadIndex);
+        }
+    }
+}
+
+
+// The owner works from the front of its range and thieves take from the
+// end, which is the work furthest from what the owner has in its cache.
+// Returns -1 when the range is empty.
+static int
+TakeTask(THREADS_Deque_t* Deque_p, const int FromEnd)
+{
+    uint64_t Range = __atomic_load_n(&Deque_p->Range, __ATOMIC_ACQUIRE);
+
+    for (;;)
+    {
+        uint32_t First = (uint32_t)(Range >> 32);
+        uint32_t End   = (uint32_t)Range;
+        uint64_t NewRange;
+
+        if (First >= End)
+        {
+            return -1;
+        }
+        NewRange = FromEnd ? (((uint64_t)First << 32) | (End - 1)) :
+                             (((uint64_t)(First + 1) << 32) | End);
+        if (__atomic_compare_exchange_n(&Deque_p->Range, &Range, NewRange, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            return FromEnd ? (int)(End - 1) : (int)First;
+        }
+    }
+}
+
+
+/*
+ * Spreads the workers evenly over the CPUs we are allowed to run on.
+ * CPUs are numbered node by node on the machines we care about, so with
+ * fewer workers than CPUs each node still gets its share of the bands.
+ */
+static void
+PinWorker(const int Index, const int NumberOfThreads)
+{
+    cpu_set_t Allowed;
+    cpu_set_t Target;
+    int NumberOfCpus;
+    int Wanted;
+    int Seen = 0;
+
+    if (sched_getaffinity(0, sizeof(Allowed), &Allowed) != 0)
+    {
+        return;
+    }
+
+    NumberOfCpus = CPU_COUNT(&Allowed);
+    if (NumberOfCpus <= 0)
+    {
+        return;
+    }
+    Wanted = (int)(((long long)(Index % NumberOfCpus) * NumberOfCpus) /
+                   ((NumberOfThreads < NumberOfCpus) ? NumberOfThreads : NumberOfCpus));
+
+    for (int Cpu = 0; Cpu < CPU_SETSIZE; Cpu++)
+    {
+        if (CPU_ISSET(Cpu, &Allowed))
+        {
+            if (Seen++ == Wanted)
+            {
+                CPU_ZERO(&Target);
+                CPU_SET(Cpu, &Target);
+                pthread_setaffinity_np(pthread_self(), sizeof(Target), &Target);
+                return;
+            }
+        }
+    }
+}
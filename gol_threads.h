@@ -0,0 +1,102 @@
+/*
+ * Game of Life - THREADS Support
+ *
+ * A small pool of persistent worker threads. The same worker always gets
+ * the same band of rows, both when a world is first touched at allocation
+ * and when it is evolved, so the pages of a band end up on the NUMA node
+ * of the core that works on them.
+ *
+ * Work that does not split evenly into bands can be run as numbered tasks
+ * instead. Each worker starts on its own contiguous range of tasks and,
+ * once that is done, steals tasks from the end of the other ranges.
+ */
+
+#ifndef GOL_THREADS_H_
+#define GOL_THREADS_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+
+typedef void (*THREADS_Function_t)(void*     Context_p,
+                                   const int ThreadIndex,
+                                   const int NumberOfThreads);
+
+
+typedef void (*THREADS_TaskFunction_t)(void*     Context_p,
+                                       const int Task,
+                                       const int ThreadIndex);
+
+
+// The tasks left to one worker, [First, End) packed into one word so that
+// the owner and the thieves can both claim a task with a single CAS
+typedef struct
+{
+    uint64_t Range;
+    char     Padding[56];
+} THREADS_Deque_t;
+
+
+typedef struct
+{
+    int                NumberOfThreads;
+    int                PinThreads;
+    pthread_t*         Threads_p;
+    pthread_mutex_t    Lock;
+    pthread_cond_t     StartCondition;
+    pthread_cond_t     DoneCondition;
+    unsigned int       JobNumber;
+    int                Pending;
+    int                Shutdown;
+    THREADS_Function_t Function;
+    void*              Context_p;
+    THREADS_Deque_t*   Deques_p;          // One per worker
+} THREADS_Pool_t;
+
+
+// Returns 0 on success. With NumberOfThreads <= 1 no threads are created
+// and THREADS_Run() calls the function on the calling thread.
+int
+THREADS_CreatePool(THREADS_Pool_t* Pool_p,
+                   const int       NumberOfThreads,
+                   const int       PinThreads);
+
+
+void
+THREADS_DestroyPool(THREADS_Pool_t* Pool_p);
+
+
+// Calls Function once per worker and waits for all of them to return.
+void
+THREADS_Run(THREADS_Pool_t*    Pool_p,
+            THREADS_Function_t Function,
+            void*              Context_p);
+
+
+/*
+ * Calls Function once for each of the tasks 0 .. NumberOfTasks - 1 and
+ * waits for all of them to return. Worker i starts on band i of the tasks,
+ * so neighbouring tasks should be numbered next to each other.
+ */
+void
+THREADS_RunTasks(THREADS_Pool_t*        Pool_p,
+                 const int              NumberOfTasks,
+                 THREADS_TaskFunction_t Function,
+                 void*                  Context_p);
+
+
+int
+THREADS_GetNumberOfThreads(const THREADS_Pool_t* Pool_p);
+
+
+// Splits [0, Total) into Count contiguous bands and returns band Index.
+void
+THREADS_GetBand(const int Total,
+                const int Index,
+                const int Count,
+                int*      Start_p,
+                int*      End_p);
+
+
+
+#endif // GOL_THREADS_H_
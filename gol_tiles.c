@@ -0,0 +1,549 @@
+/*
+ * Game of Life - TILES Implementation
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "gol_tiles.h"
+#include "gol_snapshot.h"
+
+
+#define TILE_CORNER_ABOVE_LEFT    0x01
+#define TILE_CORNER_ABOVE_RIGHT   0x02
+#define TILE_CORNER_BELOW_LEFT    0x04
+#define TILE_CORNER_BELOW_RIGHT   0x08
+
+
+typedef struct
+{
+    uint64_t Code;
+    int      Index;
+} MortonEntry_t;
+
+
+static uint64_t
+SpreadBits(uint32_t Value);
+
+static int
+CompareMortonEntries(const void* A_p, const void* B_p);
+
+static TILES_Tile_t*
+GetTile(TilesGame_t* Game_p, TILES_Tile_t* Tiles_p, const int TileX, const int TileY);
+
+static int
+NeedsEvolve(TilesGame_t* Game_p, const int TileX, const int TileY);
+
+static void
+FillHalo(TilesGame_t* Game_p, const int Position);
+
+static int
+EvolveTile(TilesGame_t* Game_p, const int Position);
+
+static void
+AddTileStats(STATS_t* Stats_p, const TILES_Tile_t* Tile_p, const int TileX, const int TileY);
+
+static void
+FirstTouchBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+static void
+EvolveBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads);
+
+
+int
+TILES_InitializeWorld(TilesGame_t*    Game_p,
+                      const int       Width,
+                      const int       Height,
+                      THREADS_Pool_t* Pool_p)
+{
+    MortonEntry_t* Entries_p;
+
+    Game_p->Width         = Width;
+    Game_p->Height        = Height;
+    Game_p->TilesX        = (Width + TILES_SIZE - 1) / TILES_SIZE;
+    Game_p->TilesY        = (Height + TILES_SIZE - 1) / TILES_SIZE;
+    Game_p->NumberOfTiles = Game_p->TilesX * Game_p->TilesY;
+    Game_p->Pool_p        = Pool_p;
+
+    // Snapshots hold on to the index, as well as to the tiles
+    Game_p->TileIndex_p = SNAPSHOT_AllocateBuffer(Game_p->NumberOfTiles * sizeof(int));
+    Game_p->TileX_p     = malloc(Game_p->NumberOfTiles * sizeof(int));
+    Game_p->TileY_p     = malloc(Game_p->NumberOfTiles * sizeof(int));
+
+    // Tiles start on a cache line, so no tile shares a line with another
+    Game_p->CurrentTiles_p  = SNAPSHOT_AllocateBuffer(Game_p->NumberOfTiles * sizeof(TILES_Tile_t));
+    Game_p->EvolvingTiles_p = SNAPSHOT_AllocateBuffer(Game_p->NumberOfTiles * sizeof(TILES_Tile_t));
+    Game_p->Changed_p         = malloc(Game_p->NumberOfTiles);
+    Game_p->EvolvingChanged_p = malloc(Game_p->NumberOfTiles);
+    Game_p->BandStats_p       = malloc(THREADS_GetNumberOfThreads(Pool_p) * sizeof(STATS_t));
+    Game_p->EvolveAll         = 1;
+    STATS_Reset(&Game_p->Stats);
+    Game_p->StatsValid        = 1;
+
+    // Rank the tiles by Morton code, which also works for non-square worlds
+    Entries_p = malloc(Game_p->NumberOfTiles * sizeof(MortonEntry_t));
+    if (Entries_p == NULL || Game_p->TileIndex_p == NULL || Game_p->TileX_p == NULL || Game_p->TileY_p == NULL ||
+        Game_p->CurrentTiles_p == NULL || Game_p->EvolvingTiles_p == NULL || Game_p->Changed_p == NULL ||
+        Game_p->EvolvingChanged_p == NULL || Game_p->BandStats_p == NULL)
+    {
+        free(Entries_p);
+        TILES_DestroyWorld(Game_p);
+        return -1;
+    }
+    for (int y = 0; y < Game_p->TilesY; y++)
+    {
+        for (int x = 0; x < Game_p->TilesX; x++)
+        {
+            int Index = y * Game_p->TilesX + x;
+            Entries_p[Index].Code  = SpreadBits(x) | (SpreadBits(y) << 1);
+            Entries_p[Index].Index = Index;
+        }
+    }
+    qsort(Entries_p, Game_p->NumberOfTiles, sizeof(MortonEntry_t), CompareMortonEntries);
+
+    for (int Position = 0; Position < Game_p->NumberOfTiles; Position++)
+    {
+        int Index = Entries_p[Position].Index;
+        Game_p->TileIndex_p[Index]  = Position;
+        Game_p->TileX_p[Position]   = Index % Game_p->TilesX;
+        Game_p->TileY_p[Position]   = Index / Game_p->TilesX;
+    }
+    free(Entries_p);
+
+    // Tiles are cleared by the threads that evolve them
+    THREADS_Run(Pool_p, FirstTouchBand, Game_p);
+    return 0;
+}
+
+
+void
+TILES_DestroyWorld(TilesGame_t* Game_p)
+{
+    SNAPSHOT_ReleaseBuffer(Game_p->TileIndex_p);
+    free(Game_p->TileX_p);
+    free(Game_p->TileY_p);
+    SNAPSHOT_ReleaseBuffer(Game_p->CurrentTiles_p);
+    SNAPSHOT_ReleaseBuffer(Game_p->EvolvingTiles_p);
+    free(Game_p->Changed_p);
+    free(Game_p->EvolvingChanged_p);
+    free(Game_p->BandStats_p);
+}
+
+
+void
+TILES_SetCellStateInCurrent(TilesGame_t* Game_p,
+                            const int    Column,
+                            const int    Row,
+                            const int    State)
+{
+    TILES_Tile_t* Tile_p = GetTile(Game_p, Game_p->CurrentTiles_p,
+                                   Column / TILES_SIZE, Row / TILES_SIZE);
+    uint64_t Bit = (uint64_t)1 << (Column % TILES_SIZE);
+
+    if (State)
+    {
+        Tile_p->Cells[Row % TILES_SIZE] |= Bit;
+    }
+    else
+    {
+        Tile_p->Cells[Row % TILES_SIZE] &= ~Bit;
+    }
+    Game_p->EvolveAll  = 1;
+    Game_p->StatsValid = 0;
+}
+
+
+int
+TILES_GetCellState(TilesGame_t* Game_p,
+                   const int    Column,
+                   const int    Row)
+{
+    TILES_Tile_t* Tile_p = GetTile(Game_p, Game_p->CurrentTiles_p,
+                                   Column / TILES_SIZE, Row / TILES_SIZE);
+
+    return (Tile_p->Cells[Row % TILES_SIZE] >> (Column % TILES_SIZE)) & 1;
+}
+
+
+void
+TILES_SetRowInCurrent(TilesGame_t*          Game_p,
+                      const int             Row,
+                      const uint64_t* const Cells_p)
+{
+    // Tile rows are one word, and line up with the words of the row
+    for (int TileX = 0; TileX < Game_p->TilesX; TileX++)
+    {
+        GetTile(Game_p, Game_p->CurrentTiles_p, TileX, Row / TILES_SIZE)->Cells[Row % TILES_SIZE] =
+            Cells_p[TileX];
+    }
+}
+
+
+void
+TILES_StampRowInCurrent(TilesGame_t*          Game_p,
+                        const int             Row,
+                        const int             Column,
+                        const uint64_t* const Cells_p,
+                        const int             NumberOfColumns,
+                        const PATTERN_Mode_t  Mode)
+{
+    // Only the tiles the cells fall in are touched
+    const int FirstTileX = (Column > 0) ? Column / TILES_SIZE : 0;
+    const int LastTileX  = (Column + NumberOfColumns - 1) / TILES_SIZE;
+
+    for (int TileX = FirstTileX; TileX <= LastTileX && TileX < Game_p->TilesX; TileX++)
+    {
+        TILES_Tile_t* Tile_p = GetTile(Game_p, Game_p->CurrentTiles_p, TileX, Row / TILES_SIZE);
+        uint64_t* Word_p = &Tile_p->Cells[Row % TILES_SIZE];
+        const int First = TileX * TILES_SIZE - Column;
+        const uint64_t Mask = PATTERN_GetMask(NumberOfColumns, First) &
+                              PATTERN_GetMask(Game_p->Width, TileX * TILES_SIZE);
+
+        *Word_p = PATTERN_Combine(*Word_p, PATTERN_GetBits(Cells_p, NumberOfColumns, First), Mask, Mode);
+    }
+}
+
+
+int
+TILES_EvolveWorld(TilesGame_t* Game_p)
+{
+    const int NumberOfThreads = THREADS_GetNumberOfThreads(Game_p->Pool_p);
+    TILES_Tile_t* TempTiles_p;
+    unsigned char* TempChanged_p;
+
+    // Skipped tiles rely on the evolving tiles holding the generation
+    // before, which new tiles (if a snapshot holds the old ones) do not
+    switch (SNAPSHOT_UnshareBuffer((void**)&Game_p->EvolvingTiles_p, 0))
+    {
+    case 0:
+        break;
+
+    case 1:
+        Game_p->EvolveAll = 1;
+        break;
+
+    default:
+        return -1;
+    }
+
+    THREADS_Run(Game_p->Pool_p, EvolveBand, Game_p);
+
+    TempTiles_p = Game_p->CurrentTiles_p;
+    Game_p->CurrentTiles_p  = Game_p->EvolvingTiles_p;
+    Game_p->EvolvingTiles_p = TempTiles_p;
+
+    TempChanged_p = Game_p->Changed_p;
+    Game_p->Changed_p         = Game_p->EvolvingChanged_p;
+    Game_p->EvolvingChanged_p = TempChanged_p;
+    Game_p->EvolveAll = 0;
+
+    STATS_Reset(&Game_p->Stats);
+    for (int i = 0; i < NumberOfThreads; i++)
+    {
+        STATS_Merge(&Game_p->Stats, &Game_p->BandStats_p[i]);
+    }
+    Game_p->StatsValid = 1;
+    return 0;
+}
+
+
+void
+TILES_GetStats(TilesGame_t* Game_p, STATS_t* Stats_p)
+{
+    if (!Game_p->StatsValid)
+    {
+        STATS_Reset(&Game_p->Stats);
+        for (int Position = 0; Position < Game_p->NumberOfTiles; Position++)
+        {
+            AddTileStats(&Game_p->Stats, &Game_p->CurrentTiles_p[Position],
+                         Game_p->TileX_p[Position], Game_p->TileY_p[Position]);
+        }
+        Game_p->StatsValid = 1;
+    }
+    *Stats_p = Game_p->Stats;
+}
+
+
+void
+TILES_InvalidateStats(TilesGame_t* Game_p)
+{
+    Game_p->EvolveAll  = 1;
+    Game_p->StatsValid = 0;
+}
+
+
+int
+TILES_GetWorldWidth(TilesGame_t* Game_p)
+{
+    return Game_p->Width;
+}
+
+
+int
+TILES_GetWorldHeight(TilesGame_t* Game_p)
+{
+    return Game_p->Height;
+}
+
+
+// Puts the bits of Value in the even bit positions of the result
+static uint64_t
+SpreadBits(uint32_t Value)
+{
+    uint64_t Spread = Value;
+
+    Spread = (Spread | (Spread << 16)) & 0x0000FFFF0000FFFFull;
+    Spread = (Spread | (Spread << 8))  & 0x00FF00FF00FF00FFull;
+    Spread = (Spread | (Spread << 4))  & 0x0F0F0F0F0F0F0F0Full;
+    Spread = (Spread | (Spread << 2))  & 0x3333333333333333ull;
+    Spread = (Spread | (Spread << 1))  & 0x5555555555555555ull;
+    return Spread;
+}
+
+
+static int
+CompareMortonEntries(const void* A_p, const void* B_p)
+{
+    const MortonEntry_t* A = A_p;
+    const MortonEntry_t* B = B_p;
+
+    return (A->Code > B->Code) - (A->Code < B->Code);
+}
+
+
+// Returns NULL for tiles outside the world
+static TILES_Tile_t*
+GetTile(TilesGame_t* Game_p, TILES_Tile_t* Tiles_p, const int TileX, const int TileY)
+{
+    if (TileX < 0 || TileX >= Game_p->TilesX || TileY < 0 || TileY >= Game_p->TilesY)
+    {
+        return NULL;
+    }
+    return &Tiles_p[Game_p->TileIndex_p[TileY * Game_p->TilesX + TileX]];
+}
+
+
+// A tile can only change if it, or one of its neighbours, changed last time
+static int
+NeedsEvolve(TilesGame_t* Game_p, const int TileX, const int TileY)
+{
+    if (Game_p->EvolveAll)
+    {
+        return 1;
+    }
+
+    for (int y = TileY - 1; y <= TileY + 1; y++)
+    {
+        for (int x = TileX - 1; x <= TileX + 1; x++)
+        {
+            if (x >= 0 && x < Game_p->TilesX && y >= 0 && y < Game_p->TilesY &&
+                Game_p->Changed_p[Game_p->TileIndex_p[y * Game_p->TilesX + x]])
+            {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+
+// Copies the cells around the tile from its neighbours, dead outside the world
+static void
+FillHalo(TilesGame_t* Game_p, const int Position)
+{
+    const int TileX = Game_p->TileX_p[Position];
+    const int TileY = Game_p->TileY_p[Position];
+    TILES_Tile_t* Tile_p = &Game_p->CurrentTiles_p[Position];
+    const TILES_Tile_t* Above_p      = GetTile(Game_p, Game_p->CurrentTiles_p, TileX,     TileY - 1);
+    const TILES_Tile_t* Below_p      = GetTile(Game_p, Game_p->CurrentTiles_p, TileX,     TileY + 1);
+    const TILES_Tile_t* Left_p       = GetTile(Game_p, Game_p->CurrentTiles_p, TileX - 1, TileY);
+    const TILES_Tile_t* Right_p      = GetTile(Game_p, Game_p->CurrentTiles_p, TileX + 1, TileY);
+    const TILES_Tile_t* AboveLeft_p  = GetTile(Game_p, Game_p->CurrentTiles_p, TileX - 1, TileY - 1);
+    const TILES_Tile_t* AboveRight_p = GetTile(Game_p, Game_p->CurrentTiles_p, TileX + 1, TileY - 1);
+    const TILES_Tile_t* BelowLeft_p  = GetTile(Game_p, Game_p->CurrentTiles_p, TileX - 1, TileY + 1);
+    const TILES_Tile_t* BelowRight_p = GetTile(Game_p, Game_p->CurrentTiles_p, TileX + 1, TileY + 1);
+    uint64_t HaloLeft  = 0;
+    uint64_t HaloRight = 0;
+    uint64_t Corners   = 0;
+
+    Tile_p->HaloAbove = (Above_p != NULL) ? Above_p->Cells[TILES_SIZE - 1] : 0;
+    Tile_p->HaloBelow = (Below_p != NULL) ? Below_p->Cells[0] : 0;
+
+    for (int r = 0; r < TILES_SIZE; r++)
+    {
+        if (Left_p != NULL)
+        {
+            HaloLeft |= (Left_p->Cells[r] >> (TILES_SIZE - 1)) << r;
+        }
+        if (Right_p != NULL)
+        {
+            HaloRight |= (Right_p->Cells[r] & 1) << r;
+        }
+    }
+    Tile_p->HaloLeft  = HaloLeft;
+    Tile_p->HaloRight = HaloRight;
+
+    if (AboveLeft_p != NULL && (AboveLeft_p->Cells[TILES_SIZE - 1] >> (TILES_SIZE - 1)))
+    {
+        Corners |= TILE_CORNER_ABOVE_LEFT;
+    }
+    if (AboveRight_p != NULL && (AboveRight_p->Cells[TILES_SIZE - 1] & 1))
+    {
+        Corners |= TILE_CORNER_ABOVE_RIGHT;
+    }
+    if (BelowLeft_p != NULL && (BelowLeft_p->Cells[0] >> (TILES_SIZE - 1)))
+    {
+        Corners |= TILE_CORNER_BELOW_LEFT;
+    }
+    if (BelowRight_p != NULL && (BelowRight_p->Cells[0] & 1))
+    {
+        Corners |= TILE_CORNER_BELOW_RIGHT;
+    }
+    Tile_p->HaloCorners = Corners;
+}
+
+
+/*
+ * Evolves the tile at Position from its cells and halo, 64 cells at a time
+ * with bit-sliced adders. Returns 1 if any cell changed.
+ */
+static int
+EvolveTile(TilesGame_t* Game_p, const int Position)
+{
+    const int TileX = Game_p->TileX_p[Position];
+    const int TileY = Game_p->TileY_p[Position];
+    const TILES_Tile_t* Tile_p = &Game_p->CurrentTiles_p[Position];
+    TILES_Tile_t* Evolved_p = &Game_p->EvolvingTiles_p[Position];
+    const int ValidColumns = Game_p->Width - TileX * TILES_SIZE;
+    const int ValidRows    = Game_p->Height - TileY * TILES_SIZE;
+    const uint64_t Mask = (ValidColumns < TILES_SIZE) ? ((uint64_t)1 << ValidColumns) - 1 : ~(uint64_t)0;
+    uint64_t Changed = 0;
+
+    for (int r = 0; r < TILES_SIZE; r++)
+    {
+        uint64_t Rows[3];
+        uint64_t LeftBits[3];
+        uint64_t RightBits[3];
+        uint64_t West[3];
+        uint64_t East[3];
+        uint64_t Sum, Ones, Twos, Fours, Carry, Carry2;
+        uint64_t UpperOnes, UpperTwos, LowerOnes, LowerTwos, MiddleOnes, MiddleTwos;
+        uint64_t Next;
+
+        if (r >= ValidRows)
+        {
+            Changed |= Evolved_p->Cells[r];
+            Evolved_p->Cells[r] = 0;
+            continue;
+        }
+
+        Rows[0]      = (r > 0) ? Tile_p->Cells[r - 1] : Tile_p->HaloAbove;
+        LeftBits[0]  = (r > 0) ? (Tile_p->HaloLeft >> (r - 1)) & 1 :
+                                 (Tile_p->HaloCorners & TILE_CORNER_ABOVE_LEFT) ? 1 : 0;
+        RightBits[0] = (r > 0) ? (Tile_p->HaloRight >> (r - 1)) & 1 :
+                                 (Tile_p->HaloCorners & TILE_CORNER_ABOVE_RIGHT) ? 1 : 0;
+        Rows[1]      = Tile_p->Cells[r];
+        LeftBits[1]  = (Tile_p->HaloLeft >> r) & 1;
+        RightBits[1] = (Tile_p->HaloRight >> r) & 1;
+        Rows[2]      = (r < TILES_SIZE - 1) ? Tile_p->Cells[r + 1] : Tile_p->HaloBelow;
+        LeftBits[2]  = (r < TILES_SIZE - 1) ? (Tile_p->HaloLeft >> (r + 1)) & 1 :
+                                              (Tile_p->HaloCorners & TILE_CORNER_BELOW_LEFT) ? 1 : 0;
+        RightBits[2] = (r < TILES_SIZE - 1) ? (Tile_p->HaloRight >> (r + 1)) & 1 :
+                                              (Tile_p->HaloCorners & TILE_CORNER_BELOW_RIGHT) ? 1 : 0;
+
+        for (int i = 0; i < 3; i++)
+        {
+            West[i] = (Rows[i] << 1) | LeftBits[i];
+            East[i] = (Rows[i] >> 1) | (RightBits[i] << (TILES_SIZE - 1));
+        }
+
+        Sum        = West[0] ^ Rows[0];
+        UpperOnes  = Sum ^ East[0];
+        UpperTwos  = (West[0] & Rows[0]) | (Sum & East[0]);
+        Sum        = West[2] ^ Rows[2];
+        LowerOnes  = Sum ^ East[2];
+        LowerTwos  = (West[2] & Rows[2]) | (Sum & East[2]);
+        MiddleOnes = West[1] ^ East[1];
+        MiddleTwos = West[1] & East[1];
+
+        Sum   = UpperOnes ^ LowerOnes;
+        Ones  = Sum ^ MiddleOnes;
+        Carry = (UpperOnes & LowerOnes) | (Sum & MiddleOnes);
+
+        Sum    = UpperTwos ^ LowerTwos;
+        Twos   = Sum ^ MiddleTwos;
+        Carry2 = (UpperTwos & LowerTwos) | (Sum & MiddleTwos);
+        Fours  = Carry2 ^ (Twos & Carry);
+        Twos   = Twos ^ Carry;
+
+        Next = Twos & ~Fours & (Ones | Rows[1]) & Mask;
+        Changed |= Next ^ Rows[1];
+        Evolved_p->Cells[r] = Next;
+    }
+
+    return Changed != 0;
+}
+
+
+static void
+AddTileStats(STATS_t* Stats_p, const TILES_Tile_t* Tile_p, const int TileX, const int TileY)
+{
+    for (int r = 0; r < TILES_SIZE; r++)
+    {
+        uint64_t Row = Tile_p->Cells[r];
+        if (Row != 0)
+        {
+            STATS_AddRow(Stats_p, TileY * TILES_SIZE + r, __builtin_popcountll(Row),
+                         TileX * TILES_SIZE + __builtin_ctzll(Row),
+                         TileX * TILES_SIZE + (TILES_SIZE - 1 - __builtin_clzll(Row)));
+        }
+    }
+}
+
+
+static void
+FirstTouchBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    TilesGame_t* Game_p = (TilesGame_t*)Context_p;
+    int Start;
+    int End;
+
+    THREADS_GetBand(Game_p->NumberOfTiles, ThreadIndex, NumberOfThreads, &Start, &End);
+
+    memset(&Game_p->CurrentTiles_p[Start], 0, (End - Start) * sizeof(TILES_Tile_t));
+    memset(&Game_p->EvolvingTiles_p[Start], 0, (End - Start) * sizeof(TILES_Tile_t));
+    memset(&Game_p->Changed_p[Start], 1, End - Start);
+    memset(&Game_p->EvolvingChanged_p[Start], 1, End - Start);
+}
+
+
+// Each thread takes a contiguous run of tiles in Morton order
+static void
+EvolveBand(void* Context_p, const int ThreadIndex, const int NumberOfThreads)
+{
+    TilesGame_t* Game_p = (TilesGame_t*)Context_p;
+    STATS_t* Stats_p = &Game_p->BandStats_p[ThreadIndex];
+    int Start;
+    int End;
+
+    THREADS_GetBand(Game_p->NumberOfTiles, ThreadIndex, NumberOfThreads, &Start, &End);
+    STATS_Reset(Stats_p);
+
+    for (int Position = Start; Position < End; Position++)
+    {
+        const int TileX = Game_p->TileX_p[Position];
+        const int TileY = Game_p->TileY_p[Position];
+
+        if (NeedsEvolve(Game_p, TileX, TileY))
+        {
+            FillHalo(Game_p, Position);
+            Game_p->EvolvingChanged_p[Position] = EvolveTile(Game_p, Position);
+        }
+        else
+        {
+            // Unchanged for a generation, so the evolving tile already matches
+            Game_p->EvolvingChanged_p[Position] = 0;
+        }
+        AddTileStats(Stats_p, &Game_p->EvolvingTiles_p[Position], TileX, TileY);
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Game of Life - TILES Variant
+ *
+ * The world is cut into 64x64 cell tiles. Each tile is one contiguous
+ * block holding its cells, one uint64_t per row, together with a copy of
+ * the cells around it (its halo), so a tile can be evolved without
+ * looking at any other tile. Tiles are stored in Morton (Z) order, which
+ * keeps tiles that are close in the world close in memory.
+ */
+
+#ifndef GOL_TILES_H_
+#define GOL_TILES_H_
+
+#include <stdint.h>
+
+#include "gol_threads.h"
+#include "gol_stats.h"
+#include "gol_pattern.h"
+
+
+#define TILES_SIZE   64
+
+
+typedef struct
+{
+    uint64_t Cells[TILES_SIZE];   // Row r, bit c is cell (c, r) of the tile
+    uint64_t HaloAbove;           // The row above, from the tile(s) above
+    uint64_t HaloBelow;
+    uint64_t HaloLeft;            // Bit r is the cell left of row r
+    uint64_t HaloRight;
+    uint64_t HaloCorners;         // Bits 0-3: above left/right, below left/right
+    uint64_t Padding[3];          // Tiles are a whole number of cache lines
+} TILES_Tile_t;
+
+
+typedef struct
+{
+    int             Width;
+    int             Height;
+    int             TilesX;
+    int             TilesY;
+    int             NumberOfTiles;
+    int*            TileIndex_p;       // Position in memory of tile (X, Y)
+    int*            TileX_p;           // Tile X and Y by position in memory
+    int*            TileY_p;
+    TILES_Tile_t*   CurrentTiles_p;
+    TILES_Tile_t*   EvolvingTiles_p;
+    unsigned char*  Changed_p;         // Per tile: changed in the last evolve
+    unsigned char*  EvolvingChanged_p;
+    int             EvolveAll;         // Set when cells are changed directly
+    THREADS_Pool_t* Pool_p;
+    STATS_t         Stats;
+    int             StatsValid;
+    STATS_t*        BandStats_p;
+} TilesGame_t;
+
+
+// Returns 0, or -1 if out of memory, with nothing left allocated
+int
+TILES_InitializeWorld(TilesGame_t*    Game_p,
+                      const int       Width,
+                      const int       Height,
+                      THREADS_Pool_t* Pool_p);
+
+
+void
+TILES_DestroyWorld(TilesGame_t* Game_p);
+
+
+void
+TILES_SetCellStateInCurrent(TilesGame_t* Game_p,
+                            const int    Column,
+                            const int    Row,
+                            const int    State);
+
+
+int
+TILES_GetCellState(TilesGame_t* Game_p,
+                   const int    Column,
+                   const int    Row);
+
+
+// Sets a whole row of the current world, bit c % 64 of word c / 64 is
+// column c. Bits for columns >= Width must be clear. Rows may be set from
+// several threads at once, TILES_InvalidateStats() must be called after.
+void
+TILES_SetRowInCurrent(TilesGame_t*          Game_p,
+                      const int             Row,
+                      const uint64_t* const Cells_p);
+
+
+// Combines NumberOfColumns packed cells, laid out as for
+// TILES_SetRowInCurrent(), into the current world from (Column, Row) on.
+// Column may be negative, cells outside the world are dropped.
+// TILES_InvalidateStats() must be called after.
+void
+TILES_StampRowInCurrent(TilesGame_t*          Game_p,
+                        const int             Row,
+                        const int             Column,
+                        const uint64_t* const Cells_p,
+                        const int             NumberOfColumns,
+                        const PATTERN_Mode_t  Mode);
+
+
+// Returns 0, or -1 if out of memory, with the world left as it was
+int
+TILES_EvolveWorld(TilesGame_t* Game_p);
+
+
+void
+TILES_GetStats(TilesGame_t* Game_p, STATS_t* Stats_p);
+
+
+// Must be called after the current world is modified directly
+void
+TILES_InvalidateStats(TilesGame_t* Game_p);
+
+
+int
+TILES_GetWorldWidth(TilesGame_t* Game_p);
+
+
+int
+TILES_GetWorldHeight(TilesGame_t* Game_p);
+
+
+
+#endif // GOL_TILES_H_
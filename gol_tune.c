@@ -0,0 +1,305 @@
+/*
+ * Game of Life - TUNE Implementation
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gol_tune.h"
+#include "gol_variant.h"
+
+
+// Tuning evolves a sample of the world, at most this large
+#define TUNE_SAMPLE_WIDTH   4096
+#define TUNE_SAMPLE_CELLS   (4 * 1024 * 1024)
+
+#define TUNE_MAX_CANDIDATES 64
+
+
+static int
+GetBits(long long Value);
+
+static int
+ListCandidates(const int* const Variants_p, const int NumberOfVariants, TUNE_Choice_t* const Candidates_p);
+
+static double
+MeasureCandidate(const TUNE_Sampler_t* const Sampler_p,
+                 const int                   Column,
+                 const int                   Row,
+                 const int                   Width,
+                 const int                   Height,
+                 const TUNE_Choice_t* const  Candidate_p,
+                 const double                Seconds);
+
+static double
+GetSeconds(void);
+
+
+int
+TUNE_GetNumberOfCpus(void)
+{
+    const long NumberOfCpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (NumberOfCpus > 1) ? (int)NumberOfCpus : 1;
+}
+
+
+void
+TUNE_MakeKey(TUNE_Key_t*     Key_p,
+             const int       Width,
+             const int       Height,
+             const long long Population)
+{
+    const long long NumberOfCells = (long long)Width * Height;
+
+    memset(Key_p, 0, sizeof(*Key_p));
+    if (gethostname(Key_p->Host, sizeof(Key_p->Host) - 1) != 0 || Key_p->Host[0] == '\0')
+    {
+        strcpy(Key_p->Host, "localhost");
+    }
+    // The file is split on white space
+    for (char* Char_p = Key_p->Host; *Char_p != '\0'; Char_p++)
+    {
+        *Char_p = (*Char_p == ' ' || *Char_p == '\t') ? '_' : *Char_p;
+    }
+
+    Key_p->NumberOfCpus = TUNE_GetNumberOfCpus();
+    Key_p->WidthClass   = GetBits(Width);
+    Key_p->HeightClass  = GetBits(Height);
+    Key_p->DensityClass = 0;
+    if (Population > 0)
+    {
+        long long Doubled = Population;
+
+        Key_p->DensityClass = 1;
+        while (Doubled * 2 < NumberOfCells && Key_p->DensityClass < 32)
+        {
+            Doubled *= 2;
+            Key_p->DensityClass++;
+        }
+    }
+}
+
+
+int
+TUNE_Lookup(const char* const       Filename_p,
+            const TUNE_Key_t* const Key_p,
+            TUNE_Choice_t* const    Choice_p)
+{
+    char Line[256];
+    int Found = 0;
+    FILE* File_p;
+
+    if ((File_p = fopen(Filename_p, "r")) == NULL)
+    {
+        return -1;
+    }
+
+    while (fgets(Line, sizeof(Line), File_p) != NULL)
+    {
+        TUNE_Key_t Key;
+        TUNE_Choice_t Choice;
+
+        if (Line[0] == '#' ||
+            sscanf(Line, "%63s %d %d %d %d %d %d %d %lf", Key.Host, &Key.NumberOfCpus,
+                   &Key.WidthClass, &Key.HeightClass, &Key.DensityClass,
+                   &Choice.Variant, &Choice.NumberOfThreads, &Choice.InPlace,
+                   &Choice.CellUpdatesPerSecond) != 9)
+        {
+            continue;
+        }
+        if (strcmp(Key.Host, Key_p->Host) == 0 && Key.NumberOfCpus == Key_p->NumberOfCpus &&
+            Key.WidthClass == Key_p->WidthClass && Key.HeightClass == Key_p->HeightClass &&
+            Key.DensityClass == Key_p->DensityClass)
+        {
+            *Choice_p = Choice;
+            Found = 1;
+        }
+    }
+
+    fclose(File_p);
+    return Found ? 0 : -1;
+}
+
+
+int
+TUNE_Store(const char* const          Filename_p,
+           const TUNE_Key_t* const    Key_p,
+           const TUNE_Choice_t* const Choice_p)
+{
+    FILE* File_p;
+    int Result = 0;
+
+    if ((File_p = fopen(Filename_p, "a")) == NULL)
+    {
+        return -1;
+    }
+
+    if (fseek(File_p, 0, SEEK_END) == 0 && ftell(File_p) == 0)
+    {
+        fprintf(File_p, "# HOST CPUS WIDTH HEIGHT DENSITY VARIANT THREADS IN_PLACE RATE\n");
+    }
+    if (fprintf(File_p, "%s %d %d %d %d %d %d %d %.4g\n", Key_p->Host, Key_p->NumberOfCpus,
+                Key_p->WidthClass, Key_p->HeightClass, Key_p->DensityClass,
+                Choice_p->Variant, Choice_p->NumberOfThreads, Choice_p->InPlace,
+                Choice_p->CellUpdatesPerSecond) < 0)
+    {
+        Result = -1;
+    }
+    if (fclose(File_p) != 0)
+    {
+        Result = -1;
+    }
+    return Result;
+}
+
+
+int
+TUNE_Choose(const char* const           Filename_p,
+            const int                   Width,
+            const int                   Height,
+            const long long             Population,
+            const int* const            Variants_p,
+            const int                   NumberOfVariants,
+            const double                Seconds,
+            const TUNE_Sampler_t* const Sampler_p,
+            TUNE_Choice_t* const        Choice_p,
+            int* const                  Cached_p)
+{
+    TUNE_Choice_t Candidates[TUNE_MAX_CANDIDATES];
+    int NumberOfCandidates;
+    int SampleWidth;
+    int SampleHeight;
+    TUNE_Key_t Key;
+
+    TUNE_MakeKey(&Key, Width, Height, Population);
+    if (Filename_p != NULL && TUNE_Lookup(Filename_p, &Key, Choice_p) == 0 &&
+        VARIANT_GetOps(Choice_p->Variant) != NULL)
+    {
+        *Cached_p = 1;
+        return 0;
+    }
+    *Cached_p = 0;
+
+    SampleWidth  = (Width < TUNE_SAMPLE_WIDTH) ? Width : TUNE_SAMPLE_WIDTH;
+    SampleHeight = TUNE_SAMPLE_CELLS / SampleWidth;
+    SampleHeight = (Height < SampleHeight) ? Height : SampleHeight;
+
+    NumberOfCandidates = ListCandidates(Variants_p, NumberOfVariants, Candidates);
+    Choice_p->CellUpdatesPerSecond = -1.0;
+    for (int i = 0; i < NumberOfCandidates; i++)
+    {
+        Candidates[i].CellUpdatesPerSecond =
+            MeasureCandidate(Sampler_p, (Width - SampleWidth) / 2, (Height - SampleHeight) / 2,
+                             SampleWidth, SampleHeight, &Candidates[i], Seconds / NumberOfCandidates);
+        if (Candidates[i].CellUpdatesPerSecond > Choice_p->CellUpdatesPerSecond)
+        {
+            *Choice_p = Candidates[i];
+        }
+    }
+    if (Choice_p->CellUpdatesPerSecond <= 0.0)
+    {
+        return -1;
+    }
+
+    if (Filename_p != NULL)
+    {
+        TUNE_Store(Filename_p, &Key, Choice_p);
+    }
+    return 0;
+}
+
+
+// Bits needed for Value, 0 for 0
+static int
+GetBits(long long Value)
+{
+    int Bits = 0;
+
+    for (; Value > 0; Value >>= 1)
+    {
+        Bits++;
+    }
+    return Bits;
+}
+
+// Each of the variants with 1, 2, 4 ... threads up to the number of CPUs if
+// it has workers, and both in place and not if it can do either
+static int
+ListCandidates(const int* const Variants_p, const int NumberOfVariants, TUNE_Choice_t* const Candidates_p)
+{
+    const int NumberOfCpus = TUNE_GetNumberOfCpus();
+    int NumberOfCandidates = 0;
+
+    for (int i = 0; i < NumberOfVariants; i++)
+    {
+        const VARIANT_Ops_t* Ops_p = VARIANT_GetOps(Variants_p[i]);
+        const int MaxThreads = (Ops_p->Flags & VARIANT_THREADED) ? NumberOfCpus : 1;
+        const int InPlaceChoices = ((Ops_p->Flags & VARIANT_IN_PLACE) && !(Ops_p->Flags & VARIANT_ONLY_IN_PLACE)) ? 2 : 1;
+
+        for (int Threads = 1; ; Threads = (Threads * 2 < MaxThreads) ? Threads * 2 : MaxThreads)
+        {
+            for (int InPlace = 0; InPlace < InPlaceChoices && NumberOfCandidates < TUNE_MAX_CANDIDATES; InPlace++)
+            {
+                Candidates_p[NumberOfCandidates].Variant              = Variants_p[i];
+                Candidates_p[NumberOfCandidates].NumberOfThreads      = Threads;
+                Candidates_p[NumberOfCandidates].InPlace              = (Ops_p->Flags & VARIANT_ONLY_IN_PLACE) ? 1 : InPlace;
+                Candidates_p[NumberOfCandidates].CellUpdatesPerSecond = 0.0;
+                NumberOfCandidates++;
+            }
+            if (Threads == MaxThreads)
+            {
+                break;
+            }
+        }
+    }
+    return NumberOfCandidates;
+}
+
+
+// Returns the cell updates per second of the candidate on the sample at
+// (Column, Row), 0.0 if it can not be made
+static double
+MeasureCandidate(const TUNE_Sampler_t* const Sampler_p,
+                 const int                   Column,
+                 const int                   Row,
+                 const int                   Width,
+                 const int                   Height,
+                 const TUNE_Choice_t* const  Candidate_p,
+                 const double                Seconds)
+{
+    void* Sample_p;
+    long long Generations = 0;
+    double Start;
+    double Elapsed;
+
+    if ((Sample_p = Sampler_p->Make(Sampler_p->Context_p, Candidate_p, Column, Row, Width, Height)) == NULL)
+    {
+        return 0.0;
+    }
+
+    // The first generation warms up the caches and the workers
+    Sampler_p->Evolve(Sample_p);
+    Start = GetSeconds();
+    do
+    {
+        Sampler_p->Evolve(Sample_p);
+        Generations++;
+        Elapsed = GetSeconds() - Start;
+    } while (Elapsed < Seconds);
+
+    Sampler_p->Destroy(Sample_p);
+    return (double)Width * Height * Generations / ((Elapsed > 0.0) ? Elapsed : 1e-9);
+}
+
+
+static double
+GetSeconds(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return Now.tv_sec + Now.tv_nsec / 1e9;
+}
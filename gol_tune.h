@@ -0,0 +1,119 @@
+/*
+ * Game of Life - TUNE Support
+ *
+ * The cache of autotuning choices. Each line of the cache file holds the
+ * choice for one host and one class of worlds:
+ *
+ *   HOST CPUS WIDTH HEIGHT DENSITY VARIANT THREADS IN_PLACE RATE
+ *
+ * where WIDTH and HEIGHT are the number of bits in the size of the world,
+ * and DENSITY is 1 for worlds with half their cells alive or more, 2 for
+ * a quarter, 3 for an eighth and so on (0 when empty). Worlds of about the
+ * same size and density share a choice. Lines starting with '#' are
+ * comments, and later lines win over earlier ones, so a new choice is
+ * simply appended.
+ *
+ * Choices are measured on worlds made by the caller, see TUNE_Choose().
+ */
+
+#ifndef GOL_TUNE_H_
+#define GOL_TUNE_H_
+
+
+#define TUNE_MAX_HOST_LENGTH   64
+
+
+typedef struct
+{
+    char Host[TUNE_MAX_HOST_LENGTH];
+    int  NumberOfCpus;
+    int  WidthClass;
+    int  HeightClass;
+    int  DensityClass;
+} TUNE_Key_t;
+
+
+typedef struct
+{
+    int    Variant;               // A GOL_Variant_t
+    int    NumberOfThreads;
+    int    InPlace;
+    double CellUpdatesPerSecond;  // As measured on the sample
+} TUNE_Choice_t;
+
+
+/*
+ * Makes a world of the variant, threads and in place setting of Choice_p
+ * holding the cells of the world being tuned from (Column, Row) on, Width
+ * x Height, or returns NULL if it can not be made.
+ */
+typedef void* (*TUNE_MakeSample_t)(void*                      Context_p,
+                                   const TUNE_Choice_t* const Choice_p,
+                                   const int                  Column,
+                                   const int                  Row,
+                                   const int                  Width,
+                                   const int                  Height);
+
+
+// The worlds that choices are measured on
+typedef struct
+{
+    TUNE_MakeSample_t Make;
+    void              (*Evolve)(void* Sample_p);
+    void              (*Destroy)(void* Sample_p);
+    void*             Context_p;
+} TUNE_Sampler_t;
+
+
+// The CPUs online, at least 1
+int
+TUNE_GetNumberOfCpus(void);
+
+
+void
+TUNE_MakeKey(TUNE_Key_t*     Key_p,
+             const int       Width,
+             const int       Height,
+             const long long Population);
+
+
+// Returns 0 and the choice for Key_p, or -1 if there is none (or no file)
+int
+TUNE_Lookup(const char* const       Filename_p,
+            const TUNE_Key_t* const Key_p,
+            TUNE_Choice_t* const    Choice_p);
+
+
+// Returns 0, or -1 (with errno set) if the file can not be written
+int
+TUNE_Store(const char* const          Filename_p,
+           const TUNE_Key_t* const    Key_p,
+           const TUNE_Choice_t* const Choice_p);
+
+
+/*
+ * Chooses how a world Width x Height with Population live cells evolves
+ * fastest. Each of Variants_p is a candidate with 1, 2, 4 ... threads up
+ * to the number of CPUs if it has workers, and both in place and not if
+ * it can do either. Each candidate evolves a sample of the world for its
+ * share of Seconds: a band across its middle, whole rows if they fit.
+ *
+ * If Filename_p is not NULL, the choice is looked up there first, and
+ * stored there once measured. Returns 0 and the choice, with *Cached_p
+ * set if it was looked up, or -1 if no candidate could be measured.
+ */
+int
+TUNE_Choose(const char* const           Filename_p,
+            const int                   Width,
+            const int                   Height,
+            const long long             Population,
+            const int* const            Variants_p,
+            const int                   NumberOfVariants,
+            const double                Seconds,
+            const TUNE_Sampler_t* const Sampler_p,
+            TUNE_Choice_t* const        Choice_p,
+            int* const                  Cached_p);
+
+
+
+#endif // GOL_TUNE_H_
@@ -0,0 +1,648 @@
+/*
+ * Game of Life - VARIANT Operations
+ *
+ */
+
+#include <string.h>
+
+#include "gol_api.h"
+#include "gol_variant.h"
+#include "gol_ref.h"
+#include "gol_array.h"
+#include "gol_bits.h"
+#include "gol_tiles.h"
+#include "gol_counts.h"
+
+
+/*
+ * The operations that ARRAY, BITS, TILES and COUNTS (PREFIX) all have under the
+ * same names. GetRow() reads the current world through Describe().
+ */
+#define DEFINE_COMMON_OPERATIONS(NAME, PREFIX, GAME_T)                         \
+static void                                                                    \
+NAME##Destroy(void* Game_p)                                                    \
+{                                                                              \
+    PREFIX##_DestroyWorld((GAME_T*)Game_p);                                    \
+}                                                                              \
+                                                                               \
+static int                                                                     \
+NAME##Evolve(void* Game_p)                                                     \
+{                                                                              \
+    return PREFIX##_EvolveWorld((GAME_T*)Game_p);                              \
+}                                                                              \
+                                                                               \
+static int                                                                     \
+NAME##GetWidth(void* Game_p)                                                   \
+{                                                                              \
+    return PREFIX##_GetWorldWidth((GAME_T*)Game_p);                            \
+}                                                                              \
+                                                                               \
+static int                                                                     \
+NAME##GetHeight(void* Game_p)                                                  \
+{                                                                              \
+    return PREFIX##_GetWorldHeight((GAME_T*)Game_p);                           \
+}                                                                              \
+                                                                               \
+static int                                                                     \
+NAME##GetCellState(void* Game_p, const int Column, const int Row)              \
+{                                                                              \
+    return PREFIX##_GetCellState((GAME_T*)Game_p, Column, Row);                \
+}                                                                              \
+                                                                               \
+static void                                                                    \
+NAME##SetCellState(void* Game_p, const int Column, const int Row,              \
+                   const int State)                                            \
+{                                                                              \
+    PREFIX##_SetCellStateInCurrent((GAME_T*)Game_p, Column, Row, State);       \
+}                                                                              \
+                                                                               \
+static void                                                                    \
+NAME##GetRow(void* Game_p, const int Row, uint64_t* const Cells_p)             \
+{                                                                              \
+    SNAPSHOT_t View;                                                           \
+                                                                               \
+    NAME##Describe(Game_p, &View);                                             \
+    SNAPSHOT_GetRow(&View, Row, Cells_p);                                      \
+}                                                                              \
+                                                                               \
+static void                                                                    \
+NAME##SetRow(void* Game_p, const int Row, const uint64_t* const Cells_p)       \
+{                                                                              \
+    PREFIX##_SetRowInCurrent((GAME_T*)Game_p, Row, Cells_p);                   \
+}                                                                              \
+                                                                               \
+static void                                                                    \
+NAME##StampRow(void*                 Game_p,                                   \
+               const int             Row,                                      \
+               const int             Column,                                   \
+               const uint64_t* const Cells_p,                                  \
+               const int             NumberOfColumns,                          \
+               const PATTERN_Mode_t  Mode)                                     \
+{                                                                              \
+    PREFIX##_StampRowInCurrent((GAME_T*)Game_p, Row, Column, Cells_p,          \
+                               NumberOfColumns, Mode);                         \
+}                                                                              \
+                                                                               \
+static void                                                                    \
+NAME##GetStats(void* Game_p, STATS_t* Stats_p)                                 \
+{                                                                              \
+    PREFIX##_GetStats((GAME_T*)Game_p, Stats_p);                               \
+}                                                                              \
+                                                                               \
+static void                                                                    \
+NAME##InvalidateStats(void* Game_p)                                            \
+{                                                                              \
+    PREFIX##_InvalidateStats((GAME_T*)Game_p);                                 \
+}
+
+
+static int
+RefInitialize(void*           Game_p,
+              const int       Width,
+              const int       Height,
+              const int       InPlace,
+              THREADS_Pool_t* Pool_p);
+
+static void
+RefDestroy(void* Game_p);
+
+static int
+RefEvolve(void* Game_p);
+
+static int
+RefGetWidth(void* Game_p);
+
+static int
+RefGetHeight(void* Game_p);
+
+static int
+RefGetCellState(void* Game_p, const int Column, const int Row);
+
+static void
+RefSetCellState(void* Game_p, const int Column, const int Row, const int State);
+
+static void
+RefGetRow(void* Game_p, const int Row, uint64_t* const Cells_p);
+
+static void
+RefSetRow(void* Game_p, const int Row, const uint64_t* const Cells_p);
+
+static void
+RefStampRow(void*                 Game_p,
+            const int             Row,
+            const int             Column,
+            const uint64_t* const Cells_p,
+            const int             NumberOfColumns,
+            const PATTERN_Mode_t  Mode);
+
+static void
+RefGetStats(void* Game_p, STATS_t* Stats_p);
+
+static void
+RefInvalidateStats(void* Game_p);
+
+static int
+ArrayInitialize(void*           Game_p,
+                const int       Width,
+                const int       Height,
+                const int       InPlace,
+                THREADS_Pool_t* Pool_p);
+
+static void
+ArrayDescribe(void* Game_p, SNAPSHOT_t* Snapshot_p);
+
+static void**
+ArrayGetCurrentBuffer(void* Game_p);
+
+static int
+ArrayResize(void*     Game_p,
+            const int NewWidth,
+            const int NewHeight,
+            const int ColumnShift,
+            const int RowShift);
+
+static int
+BitsInitialize(void*           Game_p,
+               const int       Width,
+               const int       Height,
+               const int       InPlace,
+               THREADS_Pool_t* Pool_p);
+
+static void
+BitsDescribe(void* Game_p, SNAPSHOT_t* Snapshot_p);
+
+static void**
+BitsGetCurrentBuffer(void* Game_p);
+
+static int
+BitsResize(void*     Game_p,
+           const int NewWidth,
+           const int NewHeight,
+           const int ColumnShift,
+           const int RowShift);
+
+static int
+TilesInitialize(void*           Game_p,
+                const int       Width,
+                const int       Height,
+                const int       InPlace,
+                THREADS_Pool_t* Pool_p);
+
+static void
+TilesDescribe(void* Game_p, SNAPSHOT_t* Snapshot_p);
+
+static void**
+TilesGetCurrentBuffer(void* Game_p);
+
+static int
+CountsInitialize(void*           Game_p,
+                 const int       Width,
+                 const int       Height,
+                 const int       InPlace,
+                 THREADS_Pool_t* Pool_p);
+
+static void
+CountsDescribe(void* Game_p, SNAPSHOT_t* Snapshot_p);
+
+static void**
+CountsGetCurrentBuffer(void* Game_p);
+
+
+DEFINE_COMMON_OPERATIONS(Array, ARRAY, ArrayGame_t)
+DEFINE_COMMON_OPERATIONS(Bits,  BITS,  BitsGame_t)
+DEFINE_COMMON_OPERATIONS(Tiles, TILES, TilesGame_t)
+DEFINE_COMMON_OPERATIONS(Counts, COUNTS, CountsGame_t)
+
+
+static const VARIANT_Ops_t RefOps =
+{
+    .Name_p           = "REFERENCE",
+    .Flags            = 0,
+    .GameSize         = sizeof(RefGame_t),
+    .Initialize       = RefInitialize,
+    .Destroy          = RefDestroy,
+    .Evolve           = RefEvolve,
+    .GetWidth         = RefGetWidth,
+    .GetHeight        = RefGetHeight,
+    .GetCellState     = RefGetCellState,
+    .SetCellState     = RefSetCellState,
+    .GetRow           = RefGetRow,
+    .SetRow           = RefSetRow,
+    .StampRow         = RefStampRow,
+    .GetStats         = RefGetStats,
+    .InvalidateStats  = RefInvalidateStats,
+    .Describe         = NULL,
+    .GetCurrentBuffer = NULL,
+    .Resize           = NULL,
+};
+
+
+static const VARIANT_Ops_t ArrayOps =
+{
+    .Name_p           = "ARRAY",
+    .Flags            = VARIANT_THREADED | VARIANT_IN_PLACE,
+    .GameSize         = sizeof(ArrayGame_t),
+    .Initialize       = ArrayInitialize,
+    .Destroy          = ArrayDestroy,
+    .Evolve           = ArrayEvolve,
+    .GetWidth         = ArrayGetWidth,
+    .GetHeight        = ArrayGetHeight,
+    .GetCellState     = ArrayGetCellState,
+    .SetCellState     = ArraySetCellState,
+    .GetRow           = ArrayGetRow,
+    .SetRow           = ArraySetRow,
+    .StampRow         = ArrayStampRow,
+    .GetStats         = ArrayGetStats,
+    .InvalidateStats  = ArrayInvalidateStats,
+    .Describe         = ArrayDescribe,
+    .GetCurrentBuffer = ArrayGetCurrentBuffer,
+    .Resize           = ArrayResize,
+};
+
+
+static const VARIANT_Ops_t BitsOps =
+{
+    .Name_p           = "BITS",
+    .Flags            = VARIANT_THREADED | VARIANT_IN_PLACE,
+    .GameSize         = sizeof(BitsGame_t),
+    .Initialize       = BitsInitialize,
+    .Destroy          = BitsDestroy,
+    .Evolve           = BitsEvolve,
+    .GetWidth         = BitsGetWidth,
+    .GetHeight        = BitsGetHeight,
+    .GetCellState     = BitsGetCellState,
+    .SetCellState     = BitsSetCellState,
+    .GetRow           = BitsGetRow,
+    .SetRow           = BitsSetRow,
+    .StampRow         = BitsStampRow,
+    .GetStats         = BitsGetStats,
+    .InvalidateStats  = BitsInvalidateStats,
+    .Describe         = BitsDescribe,
+    .GetCurrentBuffer = BitsGetCurrentBuffer,
+    .Resize           = BitsResize,
+};
+
+
+static const VARIANT_Ops_t TilesOps =
+{
+    .Name_p           = "TILES",
+    .Flags            = VARIANT_THREADED,
+    .GameSize         = sizeof(TilesGame_t),
+    .Initialize       = TilesInitialize,
+    .Destroy          = TilesDestroy,
+    .Evolve           = TilesEvolve,
+    .GetWidth         = TilesGetWidth,
+    .GetHeight        = TilesGetHeight,
+    .GetCellState     = TilesGetCellState,
+    .SetCellState     = TilesSetCellState,
+    .GetRow           = TilesGetRow,
+    .SetRow           = TilesSetRow,
+    .StampRow         = TilesStampRow,
+    .GetStats         = TilesGetStats,
+    .InvalidateStats  = TilesInvalidateStats,
+    .Describe         = TilesDescribe,
+    .GetCurrentBuffer = TilesGetCurrentBuffer,
+    .Resize           = NULL,
+};
+
+
+static const VARIANT_Ops_t CountsOps =
+{
+    .Name_p           = "COUNTS",
+    .Flags            = VARIANT_ONLY_IN_PLACE,
+    .GameSize         = sizeof(CountsGame_t),
+    .Initialize       = CountsInitialize,
+    .Destroy          = CountsDestroy,
+    .Evolve           = CountsEvolve,
+    .GetWidth         = CountsGetWidth,
+    .GetHeight        = CountsGetHeight,
+    .GetCellState     = CountsGetCellState,
+    .SetCellState     = CountsSetCellState,
+    .GetRow           = CountsGetRow,
+    .SetRow           = CountsSetRow,
+    .StampRow         = CountsStampRow,
+    .GetStats         = CountsGetStats,
+    .InvalidateStats  = CountsInvalidateStats,
+    .Describe         = CountsDescribe,
+    .GetCurrentBuffer = CountsGetCurrentBuffer,
+    .Resize           = NULL,
+};
+
+
+static const VARIANT_Ops_t* const Variants[GOL_VARIANT_LAST_ENTRY] =
+{
+    [GOL_VARIANT_REFERENCE] = &RefOps,
+    [GOL_VARIANT_ARRAY]     = &ArrayOps,
+    [GOL_VARIANT_BITS]      = &BitsOps,
+    [GOL_VARIANT_TILES]     = &TilesOps,
+    [GOL_VARIANT_COUNTS]    = &CountsOps,
+};
+
+
+const VARIANT_Ops_t*
+VARIANT_GetOps(const int Variant)
+{
+    if (Variant < 0 || Variant >= GOL_VARIANT_LAST_ENTRY)
+    {
+        return NULL;
+    }
+    return Variants[Variant];
+}
+
+
+// REFERENCE worlds have a fixed size and no pool, Width, Height and
+// InPlace are ignored
+static int
+RefInitialize(void*           Game_p,
+              const int       Width,
+              const int       Height,
+              const int       InPlace,
+              THREADS_Pool_t* Pool_p)
+{
+    (void)Width;
+    (void)Height;
+    (void)InPlace;
+    (void)Pool_p;
+    initialize_world((RefGame_t*)Game_p);
+    return 0;
+}
+
+
+static void
+RefDestroy(void* Game_p)
+{
+    (void)Game_p;
+}
+
+
+static int
+RefEvolve(void* Game_p)
+{
+    next_generation((RefGame_t*)Game_p);
+    return 0;
+}
+
+
+static int
+RefGetWidth(void* Game_p)
+{
+    (void)Game_p;
+    return get_world_width();
+}
+
+
+static int
+RefGetHeight(void* Game_p)
+{
+    (void)Game_p;
+    return get_world_height();
+}
+
+
+static int
+RefGetCellState(void* Game_p, const int Column, const int Row)
+{
+    return get_cell_state((RefGame_t*)Game_p, Column, Row);
+}
+
+
+// Cells outside the world are ignored, the reference code would abort()
+static void
+RefSetCellState(void* Game_p, const int Column, const int Row, const int State)
+{
+    if (Column >= 0 && Column < get_world_width() && Row >= 0 && Row < get_world_height())
+    {
+        set_cell_state_in_current((RefGame_t*)Game_p, Column, Row, State);
+    }
+}
+
+
+static void
+RefGetRow(void* Game_p, const int Row, uint64_t* const Cells_p)
+{
+    const int Width = get_world_width();
+
+    memset(Cells_p, 0, ((Width + 63) / 64) * sizeof(uint64_t));
+    for (int Column = 0; Column < Width; Column++)
+    {
+        Cells_p[Column / 64] |= (uint64_t)RefGetCellState(Game_p, Column, Row) << (Column % 64);
+    }
+}
+
+
+static void
+RefSetRow(void* Game_p, const int Row, const uint64_t* const Cells_p)
+{
+    for (int Column = 0; Column < get_world_width(); Column++)
+    {
+        RefSetCellState(Game_p, Column, Row, (Cells_p[Column / 64] >> (Column % 64)) & 1);
+    }
+}
+
+
+static void
+RefStampRow(void*                 Game_p,
+            const int             Row,
+            const int             Column,
+            const uint64_t* const Cells_p,
+            const int             NumberOfColumns,
+            const PATTERN_Mode_t  Mode)
+{
+    for (int j = 0; j < NumberOfColumns; j++)
+    {
+        if (Column + j >= 0 && Column + j < get_world_width())
+        {
+            int State = RefGetCellState(Game_p, Column + j, Row);
+
+            State = (int)PATTERN_Combine(State, (Cells_p[j / 64] >> (j % 64)) & 1, 1, Mode);
+            RefSetCellState(Game_p, Column + j, Row, State);
+        }
+    }
+}
+
+
+// Counted cell by cell, REFERENCE worlds keep no stats
+static void
+RefGetStats(void* Game_p, STATS_t* Stats_p)
+{
+    STATS_Reset(Stats_p);
+    for (int y = 0; y < get_world_height(); y++)
+    {
+        int Population = 0;
+        int MinColumn = 0;
+        int MaxColumn = 0;
+
+        for (int x = 0; x < get_world_width(); x++)
+        {
+            if (RefGetCellState(Game_p, x, y) == ALIVE)
+            {
+                MinColumn = (Population == 0) ? x : MinColumn;
+                MaxColumn = x;
+                Population++;
+            }
+        }
+        STATS_AddRow(Stats_p, y, Population, MinColumn, MaxColumn);
+    }
+}
+
+
+static void
+RefInvalidateStats(void* Game_p)
+{
+    (void)Game_p;
+}
+
+
+static int
+ArrayInitialize(void*           Game_p,
+                const int       Width,
+                const int       Height,
+                const int       InPlace,
+                THREADS_Pool_t* Pool_p)
+{
+    return ARRAY_InitializeWorld((ArrayGame_t*)Game_p, Width, Height, InPlace, Pool_p);
+}
+
+
+static void
+ArrayDescribe(void* Game_p, SNAPSHOT_t* Snapshot_p)
+{
+    ArrayGame_t* Array_p = (ArrayGame_t*)Game_p;
+
+    Snapshot_p->Layout      = SNAPSHOT_LAYOUT_BYTES;
+    Snapshot_p->Width       = Array_p->Width;
+    Snapshot_p->Height      = Array_p->Height;
+    Snapshot_p->Stride      = Array_p->Width + 2;
+    Snapshot_p->Buffer_p    = Array_p->CurrentWorld_p;
+    Snapshot_p->TileIndex_p = NULL;
+}
+
+
+static void**
+ArrayGetCurrentBuffer(void* Game_p)
+{
+    return (void**)&((ArrayGame_t*)Game_p)->CurrentWorld_p;
+}
+
+
+static int
+ArrayResize(void*     Game_p,
+            const int NewWidth,
+            const int NewHeight,
+            const int ColumnShift,
+            const int RowShift)
+{
+    return ARRAY_ResizeWorld((ArrayGame_t*)Game_p, NewWidth, NewHeight, ColumnShift, RowShift);
+}
+
+
+static int
+BitsInitialize(void*           Game_p,
+               const int       Width,
+               const int       Height,
+               const int       InPlace,
+               THREADS_Pool_t* Pool_p)
+{
+    return BITS_InitializeWorld((BitsGame_t*)Game_p, Width, Height, InPlace, Pool_p);
+}
+
+
+static void
+BitsDescribe(void* Game_p, SNAPSHOT_t* Snapshot_p)
+{
+    BitsGame_t* Bits_p = (BitsGame_t*)Game_p;
+
+    Snapshot_p->Layout      = SNAPSHOT_LAYOUT_BITS;
+    Snapshot_p->Width       = Bits_p->Width;
+    Snapshot_p->Height      = Bits_p->Height;
+    Snapshot_p->Stride      = Bits_p->NumberOfUintsPerRow;
+    Snapshot_p->Buffer_p    = Bits_p->CurrentWorld_p;
+    Snapshot_p->TileIndex_p = NULL;
+}
+
+
+static void**
+BitsGetCurrentBuffer(void* Game_p)
+{
+    return (void**)&((BitsGame_t*)Game_p)->CurrentWorld_p;
+}
+
+
+static int
+BitsResize(void*     Game_p,
+           const int NewWidth,
+           const int NewHeight,
+           const int ColumnShift,
+           const int RowShift)
+{
+    return BITS_ResizeWorld((BitsGame_t*)Game_p, NewWidth, NewHeight, ColumnShift, RowShift);
+}
+
+
+// TILES worlds always evolve into a second set of tiles
+static int
+TilesInitialize(void*           Game_p,
+                const int       Width,
+                const int       Height,
+                const int       InPlace,
+                THREADS_Pool_t* Pool_p)
+{
+    (void)InPlace;
+    return TILES_InitializeWorld((TilesGame_t*)Game_p, Width, Height, Pool_p);
+}
+
+
+static void
+TilesDescribe(void* Game_p, SNAPSHOT_t* Snapshot_p)
+{
+    TilesGame_t* Tiles_p = (TilesGame_t*)Game_p;
+
+    Snapshot_p->Layout      = SNAPSHOT_LAYOUT_TILES;
+    Snapshot_p->Width       = Tiles_p->Width;
+    Snapshot_p->Height      = Tiles_p->Height;
+    Snapshot_p->Stride      = sizeof(TILES_Tile_t) / sizeof(uint64_t);
+    Snapshot_p->Buffer_p    = Tiles_p->CurrentTiles_p;
+    Snapshot_p->TileIndex_p = Tiles_p->TileIndex_p;
+}
+
+
+static void**
+TilesGetCurrentBuffer(void* Game_p)
+{
+    return (void**)&((TilesGame_t*)Game_p)->CurrentTiles_p;
+}
+
+
+// COUNTS worlds have a single buffer and follow their changes on one thread
+static int
+CountsInitialize(void*           Game_p,
+                 const int       Width,
+                 const int       Height,
+                 const int       InPlace,
+                 THREADS_Pool_t* Pool_p)
+{
+    (void)InPlace;
+    (void)Pool_p;
+    return COUNTS_InitializeWorld((CountsGame_t*)Game_p, Width, Height);
+}
+
+
+static void
+CountsDescribe(void* Game_p, SNAPSHOT_t* Snapshot_p)
+{
+    CountsGame_t* Counts_p = (CountsGame_t*)Game_p;
+
+    Snapshot_p->Layout      = SNAPSHOT_LAYOUT_BYTES;
+    Snapshot_p->Width       = Counts_p->Width;
+    Snapshot_p->Height      = Counts_p->Height;
+    Snapshot_p->Stride      = Counts_p->Width + 2;
+    Snapshot_p->Buffer_p    = Counts_p->CurrentWorld_p;
+    Snapshot_p->TileIndex_p = NULL;
+}
+
+
+static void**
+CountsGetCurrentBuffer(void* Game_p)
+{
+    return (void**)&((CountsGame_t*)Game_p)->CurrentWorld_p;
+}
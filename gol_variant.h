@@ -0,0 +1,88 @@
+/*
+ * Game of Life - VARIANT Operations
+ *
+ * Each implementation variant registers a table of operations, which the
+ * API looks up once when a world is initialized and calls through from
+ * then on. A new variant needs a table in gol_variant.c, an entry in
+ * Variants[] and a member in the API's world union, but no changes
+ * to the API functions themselves.
+ */
+
+#ifndef GOL_VARIANT_H_
+#define GOL_VARIANT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gol_threads.h"
+#include "gol_stats.h"
+#include "gol_pattern.h"
+#include "gol_snapshot.h"
+
+
+#define VARIANT_THREADED        0x1   // Evolves on the workers of its pool
+#define VARIANT_IN_PLACE        0x2   // Can evolve in a single buffer
+#define VARIANT_ONLY_IN_PLACE   0x4   // Always evolves in a single buffer
+
+
+/*
+ * Game_p is the variant's own world (ArrayGame_t and so on). Operations
+ * marked optional are NULL for variants that can not do them. Rows are
+ * packed as for the SetRowInCurrent() functions: bit c % 64 of word
+ * c / 64 is column c.
+ */
+typedef struct
+{
+    const char* Name_p;
+    int         Flags;
+    size_t      GameSize;   // Of the variant's own world, for Game_p
+
+    // Returns 0, or -1 if out of memory, with nothing left allocated
+    int  (*Initialize)(void*           Game_p,
+                       const int       Width,
+                       const int       Height,
+                       const int       InPlace,
+                       THREADS_Pool_t* Pool_p);
+    void (*Destroy)(void* Game_p);
+    // Returns 0, or -1 if out of memory, with the world left as it was
+    int  (*Evolve)(void* Game_p);
+
+    int  (*GetWidth)(void* Game_p);
+    int  (*GetHeight)(void* Game_p);
+    int  (*GetCellState)(void* Game_p, const int Column, const int Row);
+    void (*SetCellState)(void* Game_p, const int Column, const int Row, const int State);
+    void (*GetRow)(void* Game_p, const int Row, uint64_t* const Cells_p);
+    void (*SetRow)(void* Game_p, const int Row, const uint64_t* const Cells_p);
+    void (*StampRow)(void*                 Game_p,
+                     const int             Row,
+                     const int             Column,
+                     const uint64_t* const Cells_p,
+                     const int             NumberOfColumns,
+                     const PATTERN_Mode_t  Mode);
+
+    void (*GetStats)(void* Game_p, STATS_t* Stats_p);
+    void (*InvalidateStats)(void* Game_p);
+
+    // Optional: fills in the layout fields of *Snapshot_p, no references
+    // are taken, for variants whose current world is a snapshot buffer
+    void (*Describe)(void* Game_p, SNAPSHOT_t* Snapshot_p);
+
+    // Optional, with Describe: where the current world buffer is kept
+    void** (*GetCurrentBuffer)(void* Game_p);
+
+    // Optional: see ARRAY_ResizeWorld()
+    int  (*Resize)(void*     Game_p,
+                   const int NewWidth,
+                   const int NewHeight,
+                   const int ColumnShift,
+                   const int RowShift);
+} VARIANT_Ops_t;
+
+
+// Returns NULL for unknown variants. Variant is a GOL_Variant_t.
+const VARIANT_Ops_t*
+VARIANT_GetOps(const int Variant);
+
+
+
+#endif // GOL_VARIANT_H_